@@ -0,0 +1,36 @@
+/**
+ * @file cache.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief L1 data cache maintenance.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Anything the VideoCore or the DMA engine reads or writes behind the back of the ARM has to be
+ * cleaned out of the data cache before it is handed over, and invalidated before the ARM reads
+ * what came back. Memory from the coherent pool (kernel/coherent.h) is never cached and needs
+ * neither.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef COMMON_CACHE_H
+#define COMMON_CACHE_H
+
+#include "common/types.h"
+
+/// @brief Size of an ARM1176 L1 cache line in bytes.
+#define CACHE_LINE_SIZE 32
+
+#if RPI_VERSION == 1
+
+//! @brief Wait for every outstanding memory access and cache operation to finish.
+#define __data_sync_barrier() asm volatile("mcr p15, 0, %0, c7, c10, 4" : : "r"(0) : "memory")
+
+#else
+#error "Cache maintenance not defined for raspberry pi version!"
+#endif
+
+void cache_clean_range(const void* start, u32_t size);
+void cache_invalidate_range(void* start, u32_t size);
+void cache_clean_invalidate_range(void* start, u32_t size);
+
+#endif // cache.h
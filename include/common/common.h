@@ -10,18 +10,13 @@
 #ifndef COMMON_COMMON_H
 #define COMMON_COMMON_H
 
+#include "common/endian.h"
 #include "common/types.h"
 
-extern bool beTest;
-
 void common_init(void);
 
 void spin_delay(u32_t count);
-
-// Endianess functions
-
-u16_t beths(u16_t bg32);
-u32_t beth(u32_t bg32);
-u64_t bethl(u64_t bg32);
+void spin_delay_calibrate(u32_t loopsPerMicro);
+void spin_delay_micros(u32_t micros);
 
 #endif // common.h
\ No newline at end of file
@@ -0,0 +1,86 @@
+/**
+ * @file divide.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Integer division for a core without a divide instruction.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The compiler turns `/` and `%` on variables into calls to the ARM EABI helpers, which are built
+ * on `divide_u32` and `divide_u64`. Those take time in proportion to the number of quotient bits,
+ * so hot paths dividing by a known constant use the reciprocal helpers here instead, which are a
+ * few multiplies.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef COMMON_DIVIDE_H
+#define COMMON_DIVIDE_H
+
+#include "common/types.h"
+
+u32_t divide_u32(u32_t dividend, u32_t divisor, u32_t* remainder);
+u64_t divide_u64(u64_t dividend, u64_t divisor, u64_t* remainder);
+i32_t divide_i32(i32_t dividend, i32_t divisor, i32_t* remainder);
+i64_t divide_i64(i64_t dividend, i64_t divisor, i64_t* remainder);
+
+/**
+ * @brief The high 64 bits of a 64x64 bit product, built from 32x32 to 64 bit multiplies.
+ *
+ * @param a The first factor.
+ * @param b The second factor.
+ * @return u64_t `(a * b) >> 64`.
+ */
+static inline u64_t divide_mulhi_u64(u64_t a, u64_t b) {
+    u64_t low   = (u64_t)(u32_t)a * (u32_t)b;
+    u64_t mid1  = (u64_t)(u32_t)(a >> 32) * (u32_t)b;
+    u64_t mid2  = (u64_t)(u32_t)a * (u32_t)(b >> 32);
+    u64_t high  = (u64_t)(u32_t)(a >> 32) * (u32_t)(b >> 32);
+    u64_t carry = ((low >> 32) + (u32_t)mid1 + (u32_t)mid2) >> 32;
+
+    return high + (mid1 >> 32) + (mid2 >> 32) + carry;
+}
+
+// Each multiplier is 2^(32 + s) / d, or 2^(64 + s) / d, rounded up, with s large enough that the
+// rounding error never reaches the next integer for any dividend. Powers of two shared with the
+// divisor are shifted out of the dividend first so the 64 bit multipliers fit.
+
+/// @brief `value / 10` for every 32 bit value.
+static inline u32_t divide_u32_by_10(u32_t value) {
+    return (u32_t)(((u64_t)value * 0xCCCCCCCDu) >> 35);
+}
+
+/// @brief `value / 100` for every 32 bit value.
+static inline u32_t divide_u32_by_100(u32_t value) {
+    return (u32_t)(((u64_t)value * 0x51EB851Fu) >> 37);
+}
+
+/// @brief `value / 1000` for every 32 bit value.
+static inline u32_t divide_u32_by_1000(u32_t value) {
+    return (u32_t)(((u64_t)value * 0x10624DD3u) >> 38);
+}
+
+/// @brief `value / 1000000` for every 32 bit value.
+static inline u32_t divide_u32_by_1000000(u32_t value) {
+    return (u32_t)(((u64_t)value * 0x431BDE83u) >> 50);
+}
+
+/// @brief `value / 10` for every 64 bit value.
+static inline u64_t divide_u64_by_10(u64_t value) {
+    return divide_mulhi_u64(value, 0xCCCCCCCCCCCCCCCDull) >> 3;
+}
+
+/// @brief `value / 100` for every 64 bit value.
+static inline u64_t divide_u64_by_100(u64_t value) {
+    return divide_mulhi_u64(value >> 2, 0x28F5C28F5C28F5C3ull) >> 2;
+}
+
+/// @brief `value / 1000` for every 64 bit value.
+static inline u64_t divide_u64_by_1000(u64_t value) {
+    return divide_mulhi_u64(value >> 3, 0x20C49BA5E353F7CFull) >> 4;
+}
+
+/// @brief `value / 1000000` for every 64 bit value.
+static inline u64_t divide_u64_by_1000000(u64_t value) {
+    return divide_mulhi_u64(value >> 6, 0x0218DEF416BDB1A7ull) >> 7;
+}
+
+#endif // divide.h
@@ -0,0 +1,68 @@
+/**
+ * @file endian.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Byte order conversion helpers, specialised for the target byte order at compile time.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The conversions use the compiler builtins, which GCC turns into a single REV or REV16 on ARMv6
+ * and folds away entirely for constants, such as the device tree magic. On a big endian build
+ * they compile to nothing.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef COMMON_ENDIAN_H
+#define COMMON_ENDIAN_H
+
+#include "common/types.h"
+
+#if !defined(__BYTE_ORDER__) || !defined(__ORDER_LITTLE_ENDIAN__)
+#error "Byte order not known for this compiler!"
+#endif
+
+/**
+ * @brief Reverse the bytes of a 16 bit value.
+ */
+static inline u16_t bswap16(u16_t value) {
+    return __builtin_bswap16(value);
+}
+
+/**
+ * @brief Reverse the bytes of a 32 bit value.
+ */
+static inline u32_t bswap32(u32_t value) {
+    return __builtin_bswap32(value);
+}
+
+/**
+ * @brief Reverse the bytes of a 64 bit value.
+ */
+static inline u64_t bswap64(u64_t value) {
+    return __builtin_bswap64(value);
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+/// @brief Big endian to host short.
+static inline u16_t beths(u16_t be16) { return bswap16(be16); }
+
+/// @brief Big endian to host.
+static inline u32_t beth(u32_t be32) { return bswap32(be32); }
+
+/// @brief Big endian to host long.
+static inline u64_t bethl(u64_t be64) { return bswap64(be64); }
+
+#else
+
+/// @brief Big endian to host short.
+static inline u16_t beths(u16_t be16) { return be16; }
+
+/// @brief Big endian to host.
+static inline u32_t beth(u32_t be32) { return be32; }
+
+/// @brief Big endian to host long.
+static inline u64_t bethl(u64_t be64) { return be64; }
+
+#endif
+
+#endif // endian.h
@@ -0,0 +1,43 @@
+/**
+ * @file format.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Formatted output engine and division free number conversion.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The ARM1176 has no divide instruction, so decimals are produced two digits at a time from a
+ * table, dividing by 100 with a multiply by its reciprocal. The engine knows nothing about where
+ * its output goes, it hands runs of characters to a sink.
+ *
+ * Supported conversions are %d %i %u %x %X %p %s %c and %%, with the `l` and `ll` length
+ * modifiers, the `-` and `0` flags, and a width given inline or as `*`.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef COMMON_FORMAT_H
+#define COMMON_FORMAT_H
+
+#include "common/types.h"
+
+#include <stdarg.h>
+
+/// @brief Buffer size that holds any number converted by this module, 20 digits and a sign.
+#define FORMAT_NUMBER_SIZE 24
+
+/**
+ * @brief Receives the output of the engine.
+ *
+ * @param context The context given to `format_vprint`.
+ * @param data The characters, not null terminated.
+ * @param length The number of characters.
+ */
+typedef void (*format_sink_t)(void* context, const char* data, u32_t length);
+
+char* format_decimal_u32(char* end, u32_t value);
+char* format_decimal_u64(char* end, u64_t value);
+char* format_hexadecimal(char* end, u64_t value, bool upper);
+
+int format_vprint(format_sink_t sink, void* context, const char* format, va_list ap);
+int format_print(format_sink_t sink, void* context, const char* format, ...);
+
+#endif // format.h
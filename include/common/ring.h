@@ -0,0 +1,93 @@
+/**
+ * @file ring.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Lock-free single producer, single consumer byte ring.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The producer only writes `head` and the consumer only writes `tail`, so one side can run in an
+ * interrupt handler while the other runs in normal code without masking interrupts. Both indices
+ * run freely and wrap at 2^32, the size being a power of two so that masking them gives the slot.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef COMMON_RING_H
+#define COMMON_RING_H
+
+#include "common/types.h"
+
+struct ring_t {
+    u8_t* buffer;
+    u32_t mask; // Size of the buffer minus 1.
+    u32_t head; // Bytes ever pushed, only written by the producer.
+    u32_t tail; // Bytes ever popped, only written by the consumer.
+};
+
+/**
+ * @brief Set up an empty ring.
+ *
+ * @param ring The ring.
+ * @param buffer Backing storage of `size` bytes.
+ * @param size Size of the ring, a power of two.
+ */
+static inline void ring_init(struct ring_t* ring, u8_t* buffer, u32_t size) {
+    ring->buffer = buffer;
+    ring->mask   = size - 1;
+    ring->head   = 0;
+    ring->tail   = 0;
+}
+
+/**
+ * @brief Number of bytes in the ring.
+ */
+static inline u32_t ring_count(const struct ring_t* ring) {
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Whether the ring is empty.
+ */
+static inline bool ring_empty(const struct ring_t* ring) {
+    return ring_count(ring) == 0;
+}
+
+/**
+ * @brief Add a byte to the ring, from the producer.
+ *
+ * @param ring The ring.
+ * @param byte The byte.
+ * @return bool False if the ring is full.
+ */
+static inline bool ring_push(struct ring_t* ring, u8_t byte) {
+    u32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask) {
+        return false;
+    }
+
+    ring->buffer[head & ring->mask] = byte;
+    // Publish the byte before the index that makes it visible.
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Take the oldest byte from the ring, from the consumer.
+ *
+ * @param ring The ring.
+ * @param byte Set to the byte.
+ * @return bool False if the ring is empty.
+ */
+static inline bool ring_pop(struct ring_t* ring, u8_t* byte) {
+    u32_t tail = ring->tail;
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail) {
+        return false;
+    }
+
+    *byte = ring->buffer[tail & ring->mask];
+    // Read the byte before handing its slot back to the producer.
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+#endif // ring.h
@@ -5,7 +5,7 @@
 
 extern size_t strlen(const char* str);
 extern const char* strchr(const char* str, char c);
-extern int strncmp(const char* fst, const char* snd, unsigned int n);
+extern int strncmp(const char* fst, const char* snd, size_t n);
 extern char* strncpy(char* destination, const char* source, size_t num);
 
 #endif
\ No newline at end of file
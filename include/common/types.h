@@ -31,7 +31,9 @@ typedef volatile u32_t reg32_t;
 typedef volatile u64_t reg64_t;
 
 // Pointer types
+#ifndef NULL
 #define NULL 0x0
+#endif
 #if RPI_VERSION == 1 // 32 bit
 typedef u32_t arithptr_t;
 typedef u32_t ptr_t;
@@ -46,4 +48,4 @@ typedef int bool;
 #endif
 
 // Other
-typedef unsigned int size_t;
\ No newline at end of file
+typedef __SIZE_TYPE__ size_t;
\ No newline at end of file
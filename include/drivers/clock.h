@@ -12,6 +12,9 @@
 #define DRIVERS_CLOCK_H
 
 #include "common/types.h"
+#include "drivers/dt.h"
+
+extern const struct dt_driver_t clock_driver;
 
 u64_t clock_micros(void);
 
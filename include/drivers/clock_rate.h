@@ -0,0 +1,52 @@
+/**
+ * @file clock_rate.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Rates of the clocks that the VideoCore firmware controls.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Unless the kernel is built with CLOCK_RATE_KEEP_ARM (`make ARM_MAX_CLOCK=0`), `clock_rate_init`
+ * raises the ARM clock from the conservative rate it boots at to its maximum.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef DRIVERS_CLOCK_RATE_H
+#define DRIVERS_CLOCK_RATE_H
+
+#include "common/types.h"
+
+/**
+ * @brief Clock ids of the mailbox property interface.
+ */
+enum ClockId {
+    CLOCK_ID_EMMC = 1,
+    CLOCK_ID_UART = 2,
+    CLOCK_ID_ARM  = 3,
+    CLOCK_ID_CORE = 4,
+};
+
+/// @brief One more than the highest clock id.
+#define CLOCK_ID_COUNT 5
+
+enum ClockRateReturn {
+    CLOCK_RATE_GOOD          = 0,
+    CLOCK_RATE_MAILBOX_ERROR = -1,
+    CLOCK_RATE_BAD_CLOCK     = -2,
+};
+
+/**
+ * @brief Rates of a clock in Hz.
+ */
+struct ClockRates {
+    u32_t current;
+    u32_t min;
+    u32_t max;
+};
+
+enum ClockRateReturn clock_rate_init(void);
+
+enum ClockRateReturn clock_rate_query(enum ClockId clock, struct ClockRates* rates);
+enum ClockRateReturn clock_rate_set(enum ClockId clock, u32_t rate);
+u32_t clock_rate_current(enum ClockId clock);
+
+#endif // clock_rate.h
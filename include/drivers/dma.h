@@ -0,0 +1,109 @@
+/**
+ * @file dma.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief BCM2835 DMA controller driver.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * A transfer is a chain of control blocks in memory that the DMA engine reads itself, so the
+ * control blocks must come from the coherent pool (kernel/coherent.h), and any cached source
+ * buffer must be cleaned out of the data cache before the transfer starts.
+ *
+ * Every write to a peripheral is 32 bits wide. A register that keeps only the low byte of each
+ * write, like the UART data register, drops three of every four bytes of a packed buffer, so each
+ * byte must be given its own word.
+ *
+ * The channels the ARM may use come from `brcm,dma-channel-mask` in the device tree, and drivers
+ * take one with `dma_channel_claim`.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef DRIVERS_DMA_H
+#define DRIVERS_DMA_H
+
+#include "common/types.h"
+#include "drivers/dt.h"
+
+/// @brief Number of channels in the main DMA block, channel 15 lives elsewhere and is not used.
+#define DMA_CHANNELS 15
+
+/// @brief Channels free for the ARM when the device tree does not say, those of the Pi firmware.
+#define DMA_DEFAULT_CHANNEL_MASK 0x7f35
+
+/// @brief Bus address of the peripherals, as the DMA engine sees them.
+#define DMA_PERIPHERAL_BUS_BASE 0x7E000000
+
+/**
+ * @brief Transfer information bits of a control block.
+ */
+enum DmaTransferInfo {
+    DMA_TI_INTEN      = 1 << 0,  // Interrupt once this control block is done.
+    DMA_TI_WAIT_RESP  = 1 << 3,  // Wait for each write to be acknowledged.
+    DMA_TI_DEST_INC   = 1 << 4,  // Increment the destination address.
+    DMA_TI_DEST_DREQ  = 1 << 6,  // Pace writes by the DREQ of the peripheral.
+    DMA_TI_SRC_INC    = 1 << 8,  // Increment the source address.
+    DMA_TI_SRC_DREQ   = 1 << 10, // Pace reads by the DREQ of the peripheral.
+    DMA_TI_NO_BURSTS = 1 << 26,  // Do not use wide bursts.
+};
+
+/// @brief Peripheral whose DREQ paces a transfer, in the transfer information.
+#define DMA_TI_PERMAP(dreq) ((u32_t)(dreq) << 16)
+
+/**
+ * @brief DREQ numbers of the peripherals.
+ */
+enum DmaDreq {
+    DMA_DREQ_UART_TX = 12,
+    DMA_DREQ_UART_RX = 14,
+};
+
+enum DmaReturn {
+    DMA_GOOD        = 0,
+    DMA_BUSY        = -1,
+    DMA_BAD_CHANNEL = -2,
+    DMA_NO_IRQ      = -3,
+    DMA_ERROR       = -4,
+    DMA_NO_CHANNEL  = -5,
+};
+
+/**
+ * @brief A control block, which the DMA engine reads from memory. Must be aligned to 32 bytes.
+ */
+struct dma_control_block_t {
+    u32_t info;   // enum DmaTransferInfo.
+    u32_t source; // Bus address to read from.
+    u32_t dest;   // Bus address to write to.
+    u32_t length; // Bytes to transfer.
+    u32_t stride; // Unused, 2D mode is never enabled.
+    u32_t next;   // Bus address of the next control block, 0 to stop.
+    u32_t reserved[2];
+} __attribute__((aligned(32)));
+
+/**
+ * @brief Called from the DMA interrupt once a transfer has finished.
+ *
+ * @param channel The channel.
+ * @param status DMA_GOOD, or DMA_ERROR if the engine reported an error.
+ * @param context The context given to `dma_start`.
+ */
+typedef void (*dma_callback_t)(u32_t channel, enum DmaReturn status, void* context);
+
+/**
+ * @brief Get the bus address of a peripheral register, for a control block.
+ *
+ * @param address The physical address of the register.
+ */
+static inline u32_t dma_peripheral_bus_address(ptr_t address) {
+    return DMA_PERIPHERAL_BUS_BASE | (address & 0x00ffffff);
+}
+
+extern const struct dt_driver_t dma_driver;
+
+enum DmaReturn dma_channel_claim(u32_t* channel);
+enum DmaReturn dma_channel_init(u32_t channel);
+enum DmaReturn dma_start(u32_t channel, u32_t controlBlock, dma_callback_t callback,
+                         void* context);
+bool dma_busy(u32_t channel);
+void dma_poll(u32_t channel);
+
+#endif // dma.h
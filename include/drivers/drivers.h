@@ -0,0 +1,26 @@
+/**
+ * @file drivers.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Registry of device tree probed drivers.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+
+#ifndef DRIVERS_DRIVERS_H
+#define DRIVERS_DRIVERS_H
+
+#include "drivers/dt.h"
+
+/**
+ * @brief Probe every registered driver against the device tree.
+ *
+ * The device tree is walked once, and each enabled node is matched against the compatible strings
+ * of every registered driver. Must be called after dt_init.
+ *
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t drivers_probe(void);
+
+#endif
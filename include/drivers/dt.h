@@ -23,34 +23,147 @@
 #define FDT_VERSION 17
 
 enum dt_return_value_t {
-    DT_GOOD             = 0,
-    DT_NO_MAGIC         = -1,
-    DT_WRONG_VERSION    = -2,
-    DT_INVALID_TOKEN    = -3,
-    DT_INVALID_PATH     = -4,
-    DT_NO_MORE_SIBLINGS = -5,
-    DT_NO_MORE_PROPS    = -6,
-    DT_NO_CHILDREN      = -7,
-    DT_INVALID_ITER     = -8,
-    DT_PATH_NOT_FOUND   = -9,
+    DT_GOOD                 = 0,
+    DT_NO_MAGIC             = -1,
+    DT_WRONG_VERSION        = -2,
+    DT_INVALID_TOKEN        = -3,
+    DT_INVALID_PATH         = -4,
+    DT_NO_MORE_SIBLINGS     = -5,
+    DT_NO_MORE_PROPS        = -6,
+    DT_NO_CHILDREN          = -7,
+    DT_INVALID_ITER         = -8,
+    DT_PATH_NOT_FOUND       = -9,
+    DT_TOO_MANY_NODES       = -10,
+    DT_PHANDLE_NOT_FOUND    = -11,
+    DT_PROP_NOT_FOUND       = -12,
+    DT_PROP_TOO_SHORT       = -13,
+    DT_NO_TRANSLATION       = -14,
+    DT_BAD_CHECKSUM         = -15,
+    DT_TOO_MANY_REGS        = -16,
+    DT_NO_MORE_RESERVED     = -17,
+    DT_NO_MEMORY            = -18,
+    DT_TOO_MANY_COMPATIBLES = -19,
 };
 
+/**
+ * @brief A pre-resolved property name.
+ *
+ * This is the offset of the name in the strings block, so matching a property against it is a
+ * single integer compare. Resolve names once with `dt_prop_name_resolve` and keep the handle.
+ */
+typedef u32_t dt_prop_name_t;
+
+/// @brief Handle for a name that no property in the device tree uses, it never matches.
+#define DT_PROP_NAME_INVALID 0xffffffff
+
 // Forward decls
 
-struct dt_node_iter_t;
+struct dt_t;
+
+/**
+ * @brief Structure to store information about a node iterator.
+ *
+ * Iterators index into the node table built by `dt_init`, so moving between nodes never has to
+ * touch the structure block.
+ */
+struct dt_node_iter_t {
+    const struct dt_t* device_tree; // Device tree of the node.
+    u32_t index;                    // Index of the node in the device tree node table.
+};
+
+/**
+ * @brief Structure to store information about a property iterator.
+ *
+ */
+struct dt_prop_iter_t {
+    const struct dt_t* device_tree; // Device tree of the property.
+    u32_t index;                    // Index of the property in the device tree property table.
+    u32_t end;                      // One past the index of the last property of the node.
+};
+
+/**
+ * @brief A decoded entry of a `reg` property.
+ */
+struct dt_reg_t {
+    u64_t address; // Address in the parent bus address space.
+    u64_t size;    // Size of the region in bytes.
+};
+
+/**
+ * @brief A decoded entry of a `ranges` property.
+ */
+struct dt_range_t {
+    u64_t child;  // Base address in the child bus address space.
+    u64_t parent; // Base address in the parent bus address space.
+    u64_t size;   // Size of the mapped region in bytes.
+};
+
+/**
+ * @brief A driver that is bound to device tree nodes by their `compatible` property.
+ *
+ * `probe` is called once for every enabled node that lists one of the driver's compatible strings,
+ * and should read the node's configuration (e.g. with `dt_iter_reg_address`).
+ */
+struct dt_driver_t {
+    const char* name;              // Name of the driver.
+    const char* const* compatible; // NULL terminated list of compatible strings.
+
+    // Called with each matching node.
+    enum dt_return_value_t (*probe)(const struct dt_node_iter_t* node);
+};
 
 // General
 
 extern enum dt_return_value_t dt_init(void* fdt);
+extern enum dt_return_value_t dt_blob_region(ptr_t* base, u32_t* size);
+extern enum dt_return_value_t dt_memreserve(u32_t index, u64_t* address, u64_t* size);
 
 // Searching
 
-extern enum dt_return_value_t dt_get_node_by_path(const char* path);
+extern enum dt_return_value_t dt_get_node_by_path(const char* path, struct dt_node_iter_t* node);
+extern enum dt_return_value_t dt_resolve_phandle(u32_t phandle, struct dt_node_iter_t* node);
 
 // Iterators
 
 extern enum dt_return_value_t dt_iter_init_node(struct dt_node_iter_t* iter);
 extern enum dt_return_value_t dt_iter_next_sibling(struct dt_node_iter_t* iter);
 extern enum dt_return_value_t dt_iter_first_child(struct dt_node_iter_t* iter);
+extern enum dt_return_value_t dt_iter_parent(struct dt_node_iter_t* iter);
 extern enum dt_return_value_t dt_iter_namen(struct dt_node_iter_t* iter, char* out, size_t n);
+extern const char* dt_iter_name(const struct dt_node_iter_t* iter);
+
+// Drivers
+
+extern enum dt_return_value_t dt_probe_drivers(const struct dt_driver_t* const* drivers,
+                                               size_t count);
+
+// Properties
+
+extern enum dt_return_value_t dt_prop_name_resolve(const char* name, dt_prop_name_t* handle);
+extern enum dt_return_value_t dt_iter_find_prop(const struct dt_node_iter_t* iter,
+                                                dt_prop_name_t name, struct dt_prop_iter_t* prop);
+extern enum dt_return_value_t dt_iter_get_prop(const struct dt_node_iter_t* iter, const char* name,
+                                               struct dt_prop_iter_t* prop);
+extern enum dt_return_value_t dt_iter_first_prop(const struct dt_node_iter_t* iter,
+                                                 struct dt_prop_iter_t* prop);
+extern enum dt_return_value_t dt_prop_next(struct dt_prop_iter_t* prop);
+extern const char* dt_prop_name(const struct dt_prop_iter_t* prop);
+extern const void* dt_prop_data(const struct dt_prop_iter_t* prop);
+extern u32_t dt_prop_len(const struct dt_prop_iter_t* prop);
+extern enum dt_return_value_t dt_prop_read_u32(const struct dt_prop_iter_t* prop, u32_t index,
+                                               u32_t* out);
+
+// Addresses
+
+extern enum dt_return_value_t dt_iter_reg_address(const struct dt_node_iter_t* iter, u32_t index,
+                                                  u64_t* address, u64_t* size);
+extern enum dt_return_value_t dt_iter_mmio_base(const struct dt_node_iter_t* iter, ptr_t* base);
+extern enum dt_return_value_t dt_iter_decode_reg(const struct dt_node_iter_t* iter,
+                                                 struct dt_reg_t* out, u32_t max, u32_t* count);
+extern enum dt_return_value_t dt_iter_decode_ranges(const struct dt_node_iter_t* iter,
+                                                    struct dt_range_t* out, u32_t max,
+                                                    u32_t* count);
+extern enum dt_return_value_t dt_iter_decode_interrupts(const struct dt_node_iter_t* iter,
+                                                        u32_t* out, u32_t max, u32_t* cells,
+                                                        u32_t* count);
 #endif
\ No newline at end of file
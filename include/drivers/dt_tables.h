@@ -0,0 +1,108 @@
+/**
+ * @file dt_tables.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Lookup tables that the device tree driver builds from a blob.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * These are internal to the device tree driver. They are exposed so that `tools/dt_compile` can
+ * build them from a blob at compile time, and emit them as constant C tables that `dt_init` uses
+ * instead of parsing the blob when the kernel is built with `DT_PRECOMPILE=1`.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+
+#ifndef DRIVERS_DT_TABLES_H
+#define DRIVERS_DT_TABLES_H
+
+#include "common/types.h"
+#include "drivers/dt.h"
+
+/**
+ * @brief A single entry in the unflattened node table.
+ *
+ * All links are indices into the node table, so walking between parents, children and siblings
+ * never has to re-scan the structure block.
+ */
+struct dt_node_t {
+    u32_t name_off;     // Offset of the node name from the start of the structure block.
+    u32_t first_prop;   // Index of the first property of this node in the property table.
+    u32_t path_hash;    // FNV-1a hash of the absolute path of this node.
+    u16_t prop_count;   // Number of properties this node has.
+    u16_t parent;       // Index of the parent node, DT_NO_NODE for the root.
+    u16_t first_child;  // Index of the first child, DT_NO_NODE if there are no children.
+    u16_t next_sibling; // Index of the next sibling, DT_NO_NODE if this is the last sibling.
+    u8_t address_cells; // `#address-cells` of this node, the cells in its children's addresses.
+    u8_t size_cells;    // `#size-cells` of this node, the cells in its children's sizes.
+};
+
+/**
+ * @brief A single entry in the property table, with all values already translated to host endian.
+ *
+ */
+struct dt_prop_entry_t {
+    u32_t nameoff;  // Offset of the property name into the strings block.
+    u32_t len;      // Length of the property value in bytes.
+    u32_t data_off; // Offset of the property value from the start of the structure block.
+};
+
+/**
+ * @brief A single slot in the phandle hash table.
+ *
+ */
+struct dt_phandle_entry_t {
+    u32_t phandle; // The phandle value, only valid if `node` is not DT_NO_NODE.
+    u16_t node;    // Index of the node with this phandle, DT_NO_NODE for an empty slot.
+};
+
+/**
+ * @brief A single slot in the property name intern table.
+ *
+ */
+struct dt_name_entry_t {
+    u32_t hash;    // FNV-1a hash of the name.
+    u32_t nameoff; // Offset of the name in the strings block, DT_PROP_NAME_INVALID if empty.
+};
+
+/**
+ * @brief A single `reg` entry of a node, translated to a CPU physical address.
+ *
+ */
+struct dt_reg_entry_t {
+    u64_t address; // CPU physical address of the region, if `status` is DT_GOOD.
+    u64_t size;    // Size of the region in bytes.
+    i32_t status;  // enum dt_return_value_t from translating the address.
+};
+
+/**
+ * @brief Every table the device tree driver needs, along with the blob they were built from.
+ *
+ */
+struct dt_tables_t {
+    u32_t checksum;                            // `dt_blob_checksum` of the blob.
+    u32_t totalsize;                           // Total size of the blob in bytes.
+    const struct dt_node_t* nodes;             // Node table, in depth first order.
+    u32_t node_count;                          // Number of entries in the node table.
+    const struct dt_prop_entry_t* props;       // Property table, grouped by node.
+    u32_t prop_count;                          // Number of entries in the property table.
+    const u16_t* path_table;                   // Open addressed table of node indices by path hash.
+    u32_t path_table_mask;                     // Number of slots in `path_table` minus one.
+    const struct dt_phandle_entry_t* phandles; // Open addressed table of nodes by phandle.
+    u32_t phandle_table_mask;                  // Number of slots in `phandles` minus one.
+    const struct dt_name_entry_t* names;       // Open addressed table of strings by name hash.
+    u32_t name_table_mask;                     // Number of slots in `names` minus one.
+    const struct dt_reg_entry_t* regs;         // Translated `reg` entries, grouped by node.
+    const u16_t* reg_first;                    // `node_count + 1` indices into `regs`.
+    u32_t reg_count;                           // Number of entries in `regs`.
+};
+
+extern u32_t dt_blob_checksum(const void* fdt);
+extern void dt_get_tables(struct dt_tables_t* tables);
+extern enum dt_return_value_t dt_init_from_tables(void* fdt, const struct dt_tables_t* tables);
+
+#ifdef DT_PRECOMPILED
+/// @brief Tables generated from $(DTB) at build time by `tools/dt_compile`.
+extern const struct dt_tables_t dt_precompiled_tables;
+#endif
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * @file firmware.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Board and firmware properties reported by the VideoCore.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * None of these can change while the kernel runs, so they are all fetched in a single mailbox
+ * message by `firmware_init` and then served from memory.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef DRIVERS_FIRMWARE_H
+#define DRIVERS_FIRMWARE_H
+
+#include "common/types.h"
+#include "drivers/mbox.h"
+
+/// @brief Length of a MAC address in bytes.
+#define FIRMWARE_MAC_LENGTH 6
+
+enum FirmwareReturn {
+    FIRMWARE_GOOD          = 0,
+    FIRMWARE_MAILBOX_ERROR = -1,
+};
+
+/**
+ * @brief A region of memory reported by the VideoCore.
+ */
+struct FirmwareMemory {
+    u32_t base;
+    u32_t size;
+};
+
+enum FirmwareReturn firmware_init(void);
+
+u32_t firmware_revision(void);
+u32_t firmware_board_model(void);
+struct MailboxBoardRevision firmware_board_revision(void);
+u32_t firmware_board_revision_code(void);
+u64_t firmware_board_serial(void);
+const u8_t* firmware_mac_address(void);
+struct FirmwareMemory firmware_arm_memory(void);
+struct FirmwareMemory firmware_vc_memory(void);
+
+#endif // firmware.h
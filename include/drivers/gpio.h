@@ -10,57 +10,62 @@
 #ifndef DRIVERS_GPIO_H
 #define DRIVERS_GPIO_H
 
+#include "drivers/dt.h"
+
 /**
- * @brief Addresses for GPIO memory mapped peripheral IO.
+ * @brief Register offsets for GPIO memory mapped peripheral IO, from the GPIO base address.
  */
-enum GpioPhysicalAddress {
-    GPIO_BASE    = 0x20200000,         // GPIO Base address
-    GPIO_GPFSEL0 = (GPIO_BASE + 0x00), // Function select registers
-    GPIO_GPFSEL1 = (GPIO_BASE + 0x04),
-    GPIO_GPFSEL2 = (GPIO_BASE + 0x08),
-    GPIO_GPFSEL3 = (GPIO_BASE + 0x0c),
-    GPIO_GPFSEL4 = (GPIO_BASE + 0x10),
-    GPIO_GPFSEL5 = (GPIO_BASE + 0x14),
+enum GpioRegisterOffset {
+    GPIO_GPFSEL0 = 0x00, // Function select registers
+    GPIO_GPFSEL1 = 0x04,
+    GPIO_GPFSEL2 = 0x08,
+    GPIO_GPFSEL3 = 0x0c,
+    GPIO_GPFSEL4 = 0x10,
+    GPIO_GPFSEL5 = 0x14,
 
-    GPIO_GPSET0 = (GPIO_BASE + 0x1c), // Pin output set
-    GPIO_GPSET1 = (GPIO_BASE + 0x20),
+    GPIO_GPSET0 = 0x1c, // Pin output set
+    GPIO_GPSET1 = 0x20,
 
-    GPIO_GPCLR0 = (GPIO_BASE + 0x28), // Pin output clear
-    GPIO_GPCLR1 = (GPIO_BASE + 0x2c),
+    GPIO_GPCLR0 = 0x28, // Pin output clear
+    GPIO_GPCLR1 = 0x2c,
 
-    GPIO_GPLEV0 = (GPIO_BASE + 0x34), // Pin level
-    GPIO_GPLEV1 = (GPIO_BASE + 0x38),
+    GPIO_GPLEV0 = 0x34, // Pin level
+    GPIO_GPLEV1 = 0x38,
 
-    GPIO_GPEDS0 = (GPIO_BASE + 0x40), // Pin event detect status
-    GPIO_GPEDS1 = (GPIO_BASE + 0x44),
+    GPIO_GPEDS0 = 0x40, // Pin event detect status
+    GPIO_GPEDS1 = 0x44,
 
-    GPIO_GPREN0 = (GPIO_BASE + 0x4C), // Pin rising edge detect enable
-    GPIO_GPREN1 = (GPIO_BASE + 0x50),
+    GPIO_GPREN0 = 0x4C, // Pin rising edge detect enable
+    GPIO_GPREN1 = 0x50,
 
-    GPIO_GPFEN0 = (GPIO_BASE + 0x58), // Pin falling edge detect enable
-    GPIO_GPFEN1 = (GPIO_BASE + 0x5c),
+    GPIO_GPFEN0 = 0x58, // Pin falling edge detect enable
+    GPIO_GPFEN1 = 0x5c,
 
-    GPIO_GPHEN0 = (GPIO_BASE + 0x64), // Pin high detect enable
-    GPIO_GPHEN1 = (GPIO_BASE + 0x68),
+    GPIO_GPHEN0 = 0x64, // Pin high detect enable
+    GPIO_GPHEN1 = 0x68,
 
-    GPIO_GPLEN0 = (GPIO_BASE + 0x70), // Pin low detect enable
-    GPIO_GPLEN1 = (GPIO_BASE + 0x74),
+    GPIO_GPLEN0 = 0x70, // Pin low detect enable
+    GPIO_GPLEN1 = 0x74,
 
-    GPIO_GPAREN0 = (GPIO_BASE + 0x7c), // Pin async rising edge detect
-    GPIO_GPAREN1 = (GPIO_BASE + 0x80),
+    GPIO_GPAREN0 = 0x7c, // Pin async rising edge detect
+    GPIO_GPAREN1 = 0x80,
 
-    GPIO_GPAFEN0 = (GPIO_BASE + 0x88), // Pin async falling edge detect
-    GPIO_GPAFEN1 = (GPIO_BASE + 0x8C),
+    GPIO_GPAFEN0 = 0x88, // Pin async falling edge detect
+    GPIO_GPAFEN1 = 0x8C,
 
-    GPIO_GPPUD     = (GPIO_BASE + 0x94), // Pin pull-up / down enable
-    GPIO_GPPUDCLK0 = (GPIO_BASE + 0x98), // Pin pull-up / down enable clock
-    GPIO_GPPUDCLK1 = (GPIO_BASE + 0x9C), // Pin pull-up / down enable clock
+    GPIO_GPPUD     = 0x94, // Pin pull-up / down enable
+    GPIO_GPPUDCLK0 = 0x98, // Pin pull-up / down enable clock
+    GPIO_GPPUDCLK1 = 0x9C, // Pin pull-up / down enable clock
 };
 
 enum pinMode_t { GPIO_INPUT, GPIO_OUTPUT };
 
 enum pinLevel_t { GPIO_HIGH, GPIO_LOW };
 
+enum pinPull_t { GPIO_PULL_NONE = 0, GPIO_PULL_DOWN = 1, GPIO_PULL_UP = 2 };
+
+extern const struct dt_driver_t gpio_driver;
+
 /**
  * @brief Set the mode of a gpio pin.
  *
@@ -79,4 +84,12 @@ void gpio_pin_mode(int pin, enum pinMode_t mode);
  */
 void gpio_set_pin(int pin, enum pinLevel_t level);
 
+/**
+ * @brief Set the pull-up / pull-down resistor of a gpio pin.
+ *
+ * @param pin The pin [0, 53].
+ * @param pull The resistor to enable.
+ */
+void gpio_pin_pull(int pin, enum pinPull_t pull);
+
 #endif // gpio.h
\ No newline at end of file
@@ -0,0 +1,98 @@
+/**
+ * @file irq.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief BCM2835 interrupt controller and CPU interrupt masking.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Interrupts are numbered as in the device tree binding of the controller: 0 to 31 are the ARM
+ * basic interrupts, 32 to 63 are GPU interrupts 0 to 31 and 64 to 95 are GPU interrupts 32 to 63.
+ *
+ * Handlers run in IRQ mode on the IRQ stack with interrupts masked, so they must be short and must
+ * never wait on another interrupt.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef DRIVERS_IRQ_H
+#define DRIVERS_IRQ_H
+
+#include "common/types.h"
+#include "drivers/dt.h"
+
+/// @brief Number of interrupts that can be registered.
+#define IRQ_COUNT 96
+
+/// @brief First interrupt of each bank.
+#define IRQ_BANK_BASIC 0
+#define IRQ_BANK_GPU_0 32
+#define IRQ_BANK_GPU_1 64
+
+/**
+ * @brief Interrupts used by the kernel.
+ */
+enum IrqNumber {
+    IRQ_MAILBOX = IRQ_BANK_BASIC + 1,
+    IRQ_DMA_0   = IRQ_BANK_GPU_0 + 16, // DMA channel n is IRQ_DMA_0 + n.
+    IRQ_UART    = IRQ_BANK_GPU_1 + 25,
+};
+
+/// @brief CPSR bit that masks IRQs, set in the flags from `irq_save` if they were already masked.
+#define IRQ_CPSR_MASK 0x80
+
+enum IrqReturn {
+    IRQ_GOOD       = 0,
+    IRQ_BAD_NUMBER = -1,
+    IRQ_IN_USE     = -2,
+};
+
+/**
+ * @brief An interrupt handler.
+ *
+ * @param context The context given to `irq_register`.
+ */
+typedef void (*irq_handler_t)(void* context);
+
+#if RPI_VERSION == 1
+
+//! @brief Unmask IRQs on the CPU.
+#define __irq_cpu_enable() asm volatile("cpsie i" : : : "memory")
+
+//! @brief Mask IRQs on the CPU.
+#define __irq_cpu_disable() asm volatile("cpsid i" : : : "memory")
+
+//! @brief Sleep until an interrupt is pending, even a masked one.
+#define __irq_wait() asm volatile("wfi" : : : "memory")
+
+/**
+ * @brief Mask IRQs on the CPU.
+ *
+ * @return u32_t The previous CPSR, for `irq_restore`.
+ */
+static inline u32_t irq_save(void) {
+    u32_t flags;
+    asm volatile("mrs %0, cpsr\n\tcpsid i" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+/**
+ * @brief Put the CPU IRQ mask back to what it was before `irq_save`.
+ *
+ * @param flags The value returned by `irq_save`.
+ */
+static inline void irq_restore(u32_t flags) {
+    asm volatile("msr cpsr_c, %0" : : "r"(flags) : "memory");
+}
+
+#else
+#error "Interrupt masking not defined for raspberry pi version!"
+#endif
+
+extern const struct dt_driver_t irq_driver;
+
+enum IrqReturn irq_register(u32_t irq, irq_handler_t handler, void* context);
+enum IrqReturn irq_enable(u32_t irq);
+enum IrqReturn irq_disable(u32_t irq);
+
+void irq_dispatch(void);
+
+#endif // irq.h
@@ -16,7 +16,9 @@
 #ifndef DRIVERS_MBOX_H
 #define DRIVERS_MBOX_H
 
+#include "common/cache.h"
 #include "common/types.h"
+#include "drivers/dt.h"
 
 /**
  * @brief Represents the possible mailbox property request codes.
@@ -30,7 +32,11 @@ enum MailboxRequestCodes {
     MBOX_GET_BOARD_SERIAL   = 0x00010004,
     MBOX_GET_ARM_MEMORY     = 0x00010005,
     MBOX_GET_VC_MEMORY      = 0x00010006,
-    MBOX_GET_CLOCKS         = 0x00010007
+    MBOX_GET_CLOCKS         = 0x00010007,
+    MBOX_GET_CLOCK_RATE     = 0x00030002,
+    MBOX_GET_MAX_CLOCK_RATE = 0x00030004,
+    MBOX_GET_MIN_CLOCK_RATE = 0x00030007,
+    MBOX_SET_CLOCK_RATE     = 0x00038002
 };
 
 /**
@@ -41,22 +47,64 @@ enum MailboxReturnStatus {
     MBOX_GOOD                  = 0,
     MBOX_ERROR_PARSING_REQUEST = -1,
     MBOX_ERROR_NO_RESPONSE     = -2,
-    MBOX_ITER_NO_MORE_SEGMENTS = -3,
-    MM_FAILED_INIT             = -4,
+    MBOX_ERROR_MESSAGE_FULL    = -4,
+    MBOX_ERROR_BUSY            = -5,
+    MBOX_ERROR_NO_IRQ          = -6,
+    MBOX_ERROR_NO_MEMORY       = -7,
 };
 
 /**
  * @brief Represents the supported mailbox channels.
  *
  */
-enum MailboxChannels { MBOX_PROPERTY_CHANNEL = 0x8 };
+enum MailboxChannels { MBOX_FRAMEBUFFER_CHANNEL = 0x1, MBOX_PROPERTY_CHANNEL = 0x8 };
+
+/// @brief Number of mailbox channels, the low 4 bits of every message.
+#define MBOX_CHANNELS 16
+
+/// @brief Requests that can be in flight on each channel at once, a power of two.
+#define MBOX_IN_FLIGHT 4
+
+/**
+ * @brief State of a mailbox request.
+ */
+enum MailboxCompletionState {
+    MBOX_COMPLETION_IDLE    = 0,
+    MBOX_COMPLETION_PENDING = 1,
+    MBOX_COMPLETION_DONE    = 2,
+};
+
+struct MailboxCompletion;
+
+/**
+ * @brief Called from the mailbox interrupt once a request has completed.
+ *
+ * Runs in IRQ mode, so it must not wait on another mailbox request.
+ *
+ * @param completion The completion handle of the request.
+ * @param context The context given to `mailbox_completion_init`.
+ */
+typedef void (*mailbox_callback_t)(struct MailboxCompletion* completion, void* context);
+
+/**
+ * @brief Completion handle of an asynchronous mailbox request.
+ *
+ * The handle must stay alive until the request has completed. It can be polled with
+ * `mailbox_poll`, waited on with `mailbox_wait`, or given a callback.
+ */
+struct MailboxCompletion {
+    volatile u32_t state;        // enum MailboxCompletionState.
+    u32_t reply;                 // Data of the reply, with the channel bits cleared.
+    mailbox_callback_t callback; // Called once the request completes, may be NULL.
+    void* context;               // Passed to the callback.
+};
 
 /**
  * @brief Bit translation of the value returned by getting the board revision number from the
  * mailbox.
  *
- * This struct can be passed into `mailbox_request_property` as the buffer if the code is
- * MBOX_GET_BOARD_REVISION.
+ * The revision is read once by `firmware_init`, use `firmware_board_revision` rather than asking the
+ * VideoCore again.
  *
  * For an explanation of the meaning of each value, go to
  * https://www.raspberrypi.com/documentation/computers/raspberry-pi.html#new-style-revision-codes
@@ -76,29 +124,96 @@ struct MailboxBoardRevision {
     u32_t overVoltage : 1;
 } __attribute__((packed));
 
+/// @brief Size of a property message in words, header and end tag included.
+#define MBOX_MESSAGE_WORDS 64
+
+/// @brief Handle of a tag in a property message, MBOX_NO_TAG if it did not fit.
+typedef u32_t mailbox_tag_t;
+
+/// @brief The tag handle returned when a tag does not fit in the message.
+#define MBOX_NO_TAG 0
+
 /**
- * @brief Represents the memory information returned by the mailbox.
+ * @brief A property message holding any number of tags, sent to the VideoCore in one round trip.
  *
- * This struct can be passed into `mailbox_request_property` as the buffer if the code is
- * MBOX_GET_ARM_MEMORY or MBOX_GET_VC_MEMORY.
+ * Tags are added with `mailbox_message_add`, the whole message is sent with
+ * `mailbox_message_send`, and then the response to each tag is read back with
+ * `mailbox_message_result`.
  */
-struct MailboxMemoryIterator {
-    u32_t base;
-    u32_t size;
-    int index;      // Used by mbox.c, do not modify.
-    bool is_arm;
+struct MailboxMessage {
+    u32_t buffer[MBOX_MESSAGE_WORDS] __attribute__((aligned(CACHE_LINE_SIZE)));
+    u32_t words;   // Words used, from the start of the buffer to the end of the last tag.
+    bool overflow; // Set once a tag did not fit, the message is then never sent.
 };
 
-int mailbox_request_buffer_size(enum MailboxRequestCodes code);
+extern const struct dt_driver_t mbox_driver;
 
-enum MailboxReturnStatus mailbox_request_property(enum MailboxRequestCodes code, u8_t* buffer);
+int mailbox_resolve_request_buffer_size(enum MailboxRequestCodes code);
+
+void mailbox_message_init(struct MailboxMessage* message);
+mailbox_tag_t mailbox_message_add(struct MailboxMessage* message, enum MailboxRequestCodes code,
+                                  const u32_t* request, u32_t requestWords, u32_t valueSize);
+enum MailboxReturnStatus mailbox_message_send(struct MailboxMessage* message);
+enum MailboxReturnStatus mailbox_message_submit(struct MailboxMessage* message,
+                                                struct MailboxCompletion* completion);
+enum MailboxReturnStatus mailbox_message_status(const struct MailboxMessage* message);
+enum MailboxReturnStatus mailbox_message_result(const struct MailboxMessage* message,
+                                                mailbox_tag_t tag, void* value, u32_t size);
+
+/**
+ * @brief Add a tag that takes no request arguments, sized by
+ * `mailbox_resolve_request_buffer_size`.
+ *
+ * @param message The message to add to.
+ * @param code The property to request.
+ * @return mailbox_tag_t Handle of the tag, MBOX_NO_TAG if it did not fit.
+ */
+static inline mailbox_tag_t mailbox_message_add_property(struct MailboxMessage* message,
+                                                         enum MailboxRequestCodes code) {
+    return mailbox_message_add(message, code, NULL, 0,
+                               (u32_t)mailbox_resolve_request_buffer_size(code));
+}
+
+/**
+ * @brief Add a request for the current, maximum or minimum rate of a clock, the response is the
+ * clock id then the rate in Hz.
+ *
+ * @param message The message to add to.
+ * @param code MBOX_GET_CLOCK_RATE, MBOX_GET_MAX_CLOCK_RATE or MBOX_GET_MIN_CLOCK_RATE.
+ * @param clock The clock id.
+ * @return mailbox_tag_t Handle of the tag, MBOX_NO_TAG if it did not fit.
+ */
+static inline mailbox_tag_t mailbox_message_add_clock_rate(struct MailboxMessage* message,
+                                                           enum MailboxRequestCodes code,
+                                                           u32_t clock) {
+    return mailbox_message_add(message, code, &clock, 1, 8);
+}
 
-inline enum MailboxReturnStatus mailbox_request_brev(struct MailboxBoardRevision* buffer) {
-    return mailbox_request_property(MBOX_GET_BOARD_REVISION, (u8_t*)buffer);
+/**
+ * @brief Add a request to change the rate of a clock, the response is the clock id then the rate
+ * in Hz that the clock was actually set to.
+ *
+ * @param message The message to add to.
+ * @param clock The clock id.
+ * @param rate The rate in Hz.
+ * @return mailbox_tag_t Handle of the tag, MBOX_NO_TAG if it did not fit.
+ */
+static inline mailbox_tag_t mailbox_message_add_set_clock_rate(struct MailboxMessage* message,
+                                                               u32_t clock, u32_t rate) {
+    // The last word is skip turbo, left clear so the firmware raises the voltage with the clock.
+    u32_t request[3] = {clock, rate, 0};
+    return mailbox_message_add(message, MBOX_SET_CLOCK_RATE, request, 3, 8);
 }
 
-enum MailboxReturnStatus mailbox_mem_iter_init(struct MailboxMemoryIterator* iter, bool is_arm);
-enum MailboxReturnStatus mailbox_mem_iter_next(struct MailboxMemoryIterator* iter);
+enum MailboxReturnStatus mailbox_enable_irq(void);
 
+void mailbox_completion_init(struct MailboxCompletion* completion, mailbox_callback_t callback,
+                             void* context);
+enum MailboxReturnStatus mailbox_submit(enum MailboxChannels channel, u32_t data,
+                                        struct MailboxCompletion* completion);
+bool mailbox_poll(struct MailboxCompletion* completion);
+void mailbox_wait(struct MailboxCompletion* completion);
+
+enum MailboxReturnStatus mailbox_request_property(enum MailboxRequestCodes code, u8_t* buffer);
 
 #endif
\ No newline at end of file
@@ -11,21 +11,82 @@
 #define DRIVERS_UART_H
 
 #include "common/types.h"
+#include "drivers/dt.h"
+
+/// @brief Line speed set up during boot, chosen at build time with `make UART_BAUD=...`.
+#ifndef UART_BAUD
+#define UART_BAUD 115200
+#endif
+
+/// @brief Line speeds from here on need the UART reference clock raised through the mailbox.
+#define UART_HIGH_SPEED_BAUD 921600
+
+/**
+ * @brief Line speed set up by `uart_init`. UART_BAUD, unless that needs the reference clock raised
+ * first, in which case the line runs at 115200 until `uart_set_baud` switches it over.
+ */
+#if UART_BAUD < UART_HIGH_SPEED_BAUD
+#define UART_BOOT_BAUD UART_BAUD
+#else
+#define UART_BOOT_BAUD 115200
+#endif
+
+/// @brief Most buffers in one bulk transmit.
+#define UART_DMA_MAX_SEGMENTS 16
+
+enum UartReturn {
+    UART_GOOD         = 0,
+    UART_NO_IRQ       = -1,
+    UART_BAD_BAUD     = -2,
+    UART_NO_DMA       = -3,
+    UART_BUSY         = -4,
+    UART_BAD_SEGMENTS = -5,
+    UART_DMA_ERROR    = -6,
+};
+
+/**
+ * @brief A buffer of a bulk transmit.
+ */
+struct uart_dma_segment_t {
+    const void* data;
+    u32_t length;
+};
+
+/**
+ * @brief Called from the DMA interrupt once a bulk transmit is done.
+ *
+ * @param status UART_GOOD, or UART_DMA_ERROR if the DMA engine reported an error.
+ * @param context The context given to `uart_dma_write`.
+ */
+typedef void (*uart_dma_callback_t)(enum UartReturn status, void* context);
+
+extern const struct dt_driver_t uart_driver;
 
 void uart_init();
+void uart_set_clock(u32_t clock);
+enum UartReturn uart_set_baud(u32_t baud);
+u32_t uart_baud(void);
+enum UartReturn uart_enable_irq(void);
+void uart_flush(void);
+
+enum UartReturn uart_enable_dma(void);
+enum UartReturn uart_dma_write(const struct uart_dma_segment_t* segments, u32_t count,
+                               uart_dma_callback_t callback, void* context);
 
 void uart_putch(const char c);
 void uart_puts(const char* string);
+u32_t uart_write(const char* data, u32_t length);
 
 void uart_puti(i32_t number);
 void uart_putu(u32_t number);
 
-// void uart_putil(i64_t number); // Need to create 64 bit divmod
-// void uart_putul(u64_t number); // Need to create 64 bit divmod
+void uart_putil(i64_t number);
+void uart_putul(u64_t number);
 
 void uart_puth(u32_t number);
-// void uart_puthl(u64_t number); // Need to create 64 bit divmod
+void uart_puthl(u64_t number);
 
 unsigned char uart_getch();
+bool uart_try_getch(unsigned char* c);
 
 #endif // uart.h
\ No newline at end of file
@@ -0,0 +1,30 @@
+/**
+ * @file arena.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Boot time bump allocator.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Before the page allocator is up, early subsystems allocate from a linear arena placed after the
+ * kernel image by linker.ld. Allocation moves a pointer, and memory is only given back by rolling
+ * the pointer back to a mark. Once the memory map is built the arena is retired, and everything
+ * past the last allocation is handed to the page allocator.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef KERNEL_ARENA_H
+#define KERNEL_ARENA_H
+
+#include "common/types.h"
+
+void arena_init(void* start, u32_t size);
+
+void* arena_alloc(u32_t size, u32_t align);
+
+u32_t arena_mark(void);
+void arena_release(u32_t mark);
+
+u32_t arena_used(void);
+void* arena_retire(void);
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file coherent.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Uncached buffers shared with the VideoCore and the DMA engine.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The pool is a single 1MiB section mapped as uncached normal memory, so buffers from it never
+ * need cache maintenance. Each buffer comes with the bus address that the VideoCore and the DMA
+ * engine use to reach it.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef KERNEL_COHERENT_H
+#define KERNEL_COHERENT_H
+
+#include "common/types.h"
+
+/**
+ * @brief Bus alias of ARM physical memory that bypasses the VideoCore L2 cache, which the ARM
+ * does not see.
+ */
+#define COHERENT_BUS_ALIAS 0xC0000000
+
+/// @brief Alignment and granularity of coherent buffers, a multiple of the cache line size.
+#define COHERENT_GRANULE 64
+
+enum CoherentReturn {
+    COHERENT_GOOD        = 0,
+    COHERENT_NO_MEMORY   = -1,
+    COHERENT_BAD_BUFFER  = -2,
+    COHERENT_NOT_STARTED = -3,
+};
+
+/**
+ * @brief A buffer from the coherent pool.
+ */
+struct coherent_buffer_t {
+    void* cpu;  // Address the ARM uses.
+    u32_t bus;  // Address the VideoCore and the DMA engine use.
+    u32_t size; // Size in bytes, rounded up to COHERENT_GRANULE.
+};
+
+/**
+ * @brief Get the bus address of ARM physical memory, for handing to the VideoCore or the DMA
+ * engine.
+ */
+static inline u32_t coherent_bus_address(const void* ptr) {
+    return ((u32_t)(uintptr_t)ptr & ~COHERENT_BUS_ALIAS) | COHERENT_BUS_ALIAS;
+}
+
+enum CoherentReturn coherent_init(void);
+bool coherent_ready(void);
+bool coherent_contains(const void* ptr);
+
+enum CoherentReturn coherent_alloc(u32_t size, struct coherent_buffer_t* buffer);
+enum CoherentReturn coherent_free(const struct coherent_buffer_t* buffer);
+
+#endif
@@ -4,7 +4,14 @@
 #include "fs.h"
 #include <stdarg.h>
 
+void console_init(file_write_t write);
+void console_drain_log(void);
+void console_stream_trace(void);
+void console_panic_log(void);
+void console_run(void);
+
 int printf(const char* format, ...);
+int fprintf(FILE* file, const char* format, ...);
 int vfprintf(FILE* file, const char* format, va_list ap);
 
 #endif
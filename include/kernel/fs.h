@@ -1,14 +1,59 @@
 #ifndef KERNEL_FS_H
 #define KERNEL_FS_H
 
+#include "common/types.h"
+
 // File location index (limits file sizes to 2^32 bytes).
 typedef unsigned int loc_t;
 
+/// @brief End of file, or an error, from the character functions.
+#define EOF (-1)
+
+/// @brief Size of the write buffer of every file.
+#define FILE_BUFFER_SIZE 256
+
+/// @brief Number of file descriptors that can be open.
+#define FILE_MAX_OPEN 8
+
+/**
+ * @brief Where the contents of a file end up when it is flushed.
+ *
+ * @param data The buffered characters.
+ * @param length The number of characters.
+ * @return u32_t The number of characters written, less than `length` on error.
+ */
+typedef u32_t (*file_write_t)(const char* data, u32_t length);
+
+/**
+ * @brief When a file writes out its buffer, other than when the buffer is full.
+ */
+enum FileFlags {
+    FILE_FULLY_BUFFERED = 0,      // Only on `fflush`.
+    FILE_LINE_BUFFERED  = 1 << 0, // After each call that wrote a newline.
+    FILE_UNBUFFERED     = 1 << 1, // After each call.
+};
+
 typedef struct file_ptr {
-    int fd;         // File descriptor.
-    loc_t location; // File ptr location.
+    int fd;             // File descriptor.
+    loc_t location;     // File ptr location.
+    file_write_t write; // Sink of the buffer.
+    u32_t flags;        // enum FileFlags.
+    u32_t used;         // Characters in the buffer.
+    bool newline;       // A newline was buffered since the last flush.
+    char buffer[FILE_BUFFER_SIZE];
 } FILE;
 
+extern FILE* stdout;
+extern FILE* stderr;
+
+void file_init(FILE* file, int fd, file_write_t write, u32_t flags);
+void file_queue(FILE* file, const char* data, u32_t length);
+int file_settle(FILE* file);
+
 FILE* fopen(int fd);
+int fflush(FILE* file);
+int fputc(int c, FILE* file);
+int fputs(const char* string, FILE* file);
+size_t fwrite(const void* data, size_t size, size_t count, FILE* file);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file heap.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Kernel heap.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Small objects are carved out of slabs, which are 16KiB blocks from the page allocator that each
+ * hold objects of a single size class. Requests larger than the biggest class are served directly
+ * by the page allocator.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef KERNEL_HEAP_H
+#define KERNEL_HEAP_H
+
+#include "common/types.h"
+
+/// @brief Number of slab size classes.
+#define HEAP_CLASSES 14
+
+/// @brief Stats index for allocations that bypass the slabs and go straight to the page allocator.
+#define HEAP_LARGE HEAP_CLASSES
+
+/// @brief Alignment of every pointer returned by `kmalloc`.
+#define HEAP_ALIGN 16
+
+enum HeapReturn {
+    HEAP_GOOD          = 0,
+    HEAP_BAD_POINTER   = -1,
+    HEAP_NOT_ALLOCATED = -2,
+    HEAP_BAD_CLASS     = -3,
+};
+
+/**
+ * @brief Utilisation and fragmentation counters of a size class.
+ *
+ * Utilisation is `used / capacity`, the share of slots in the slabs of the class that hold a live
+ * object. Internal fragmentation is `1 - requested / allocated`, the share of the handed out bytes
+ * that callers never asked for. For HEAP_LARGE the objects are pages.
+ */
+struct heap_stats_t {
+    u32_t object_size;      // Size of a slot, 0 for HEAP_LARGE.
+    u32_t objects_per_slab; // Slots in each slab, 0 for HEAP_LARGE.
+    u32_t slabs;            // Slabs currently owned by the class, including a cached empty one.
+    u32_t capacity;         // Slots across all of the slabs.
+    u32_t used;             // Live objects.
+    u32_t peak_used;        // Highest value of `used`.
+    u32_t allocs;           // Successful allocations.
+    u32_t frees;            // Successful frees.
+    u64_t requested_bytes;  // Bytes asked for by every allocation.
+    u64_t allocated_bytes;  // Bytes handed out by every allocation.
+};
+
+void heap_init(uintptr_t window);
+
+void* kmalloc(u32_t size);
+enum HeapReturn kfree(void* ptr);
+
+enum HeapReturn heap_stats(u32_t index, struct heap_stats_t* stats);
+
+#endif
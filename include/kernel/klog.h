@@ -0,0 +1,60 @@
+/**
+ * @file klog.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Kernel log ring.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Log lines are formatted into a fixed ring of records instead of being written to the console
+ * straight away, and are drained to the console later from the idle loop. Any context can write,
+ * interrupt handlers included, without taking a lock or masking interrupts: a writer claims a
+ * record with an atomic increment and publishes it by writing its sequence number last.
+ *
+ * When writers get more than KLOG_RECORDS ahead of the drain the oldest records are overwritten,
+ * so the ring always holds the latest lines for `klog_replay` after a panic.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef KERNEL_KLOG_H
+#define KERNEL_KLOG_H
+
+#include "common/format.h"
+#include "common/types.h"
+
+#include <stdarg.h>
+
+/// @brief Number of records in the ring, a power of two.
+#define KLOG_RECORDS 128
+
+/// @brief Longest message kept, including its null terminator. Longer messages are truncated.
+#define KLOG_MESSAGE_SIZE 112
+
+enum KlogLevel {
+    KLOG_ERROR = 0,
+    KLOG_WARN  = 1,
+    KLOG_INFO  = 2,
+    KLOG_DEBUG = 3,
+};
+
+struct klog_record_t {
+    u32_t sequence; // Index of the record plus one once published, 0 while being written.
+    u32_t level;    // enum KlogLevel.
+    u64_t time;     // Microseconds since boot.
+    char message[KLOG_MESSAGE_SIZE];
+};
+
+/**
+ * @brief Source of the record timestamps, in microseconds.
+ */
+typedef u64_t (*klog_clock_t)(void);
+
+void klog_init(klog_clock_t clock);
+
+void klog(enum KlogLevel level, const char* format, ...);
+void klog_vwrite(enum KlogLevel level, const char* format, va_list ap);
+
+bool klog_pending(void);
+u32_t klog_drain(format_sink_t sink, void* context);
+void klog_replay(format_sink_t sink, void* context);
+
+#endif // klog.h
@@ -10,11 +10,50 @@
 #ifndef KERNEL_MM_H
 #define KERNEL_MM_H
 
+#include "common/types.h"
+
+/**
+ * @brief Owner of a region of physical memory.
+ *
+ * Where the sources of the memory map overlap, the owner with the higher value wins.
+ */
+enum MemoryOwnership {
+    ARM      = 0,
+    VC       = 1,
+    RESERVED = 2,
+    MMIO     = 3,
+    UNOWNED  = 4
+};
+
+struct MemorySegment {
+    u32_t base;
+    u32_t size;
+    enum MemoryOwnership owner;
+};
+
 enum MemoryMapReturn {
-    MM_GOOD            = 0,
-    MM_BAD_DEVICE_TREE = -1,
+    MM_GOOD              = 0,
+    MM_BAD_DEVICE_TREE   = -1,
+    MM_FAILED_INIT       = -2,
+    MM_NO_MEMORY         = -3,
+    MM_TOO_MANY_SEGMENTS = -4,
 };
 
+/**
+ * @brief Whether the end of a region reported in 32 bits wraps past the top of the address space,
+ * which the memory map and the page allocator can not hold.
+ */
+static inline bool mm_region_wraps(u32_t base, u32_t size) {
+    return size > 0xffffffff - base;
+}
+
 enum MemoryMapReturn mm_init();
 
+void mm_map_reset(void);
+enum MemoryMapReturn mm_map_add(u64_t base, u64_t size, enum MemoryOwnership owner);
+enum MemoryMapReturn mm_map_build(void);
+
+enum MemoryOwnership mm_owner_of(ptr_t address);
+const struct MemorySegment* mm_memory_map(u32_t* count);
+
 #endif
\ No newline at end of file
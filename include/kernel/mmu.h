@@ -0,0 +1,45 @@
+/**
+ * @file mmu.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Memory management unit and L1 cache control.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The kernel runs identity mapped with 1MiB sections. RAM is normal write-back cacheable memory,
+ * and the peripheral window is device memory that is never cached or executed from.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef KERNEL_MMU_H
+#define KERNEL_MMU_H
+
+#include "common/types.h"
+
+#define MMU_SECTION_SHIFT 20
+#define MMU_SECTION_SIZE  (1 << MMU_SECTION_SHIFT)
+
+/**
+ * @brief Start and end of the BCM2835 peripheral window, in ARM physical addresses.
+ */
+#define MMU_PERIPHERAL_BASE 0x20000000
+#define MMU_PERIPHERAL_END  0x21000000
+
+/**
+ * @brief End of the RAM that is mapped at boot, the most the BCM2835 can address.
+ */
+#define MMU_RAM_END 0x20000000
+
+/**
+ * @brief How the memory of a section is accessed.
+ */
+enum MmuMemoryType {
+    MMU_MEMORY_NORMAL,   // Normal write-back cacheable memory.
+    MMU_MEMORY_UNCACHED, // Normal memory that is never cached, for sharing with the VideoCore.
+    MMU_MEMORY_DEVICE,   // Shared device memory, for peripherals.
+};
+
+void mmu_init(void);
+void mmu_set_caches(bool enable);
+void mmu_set_section(ptr_t address, enum MmuMemoryType type);
+
+#endif
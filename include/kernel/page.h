@@ -0,0 +1,57 @@
+/**
+ * @file page.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Physical page frame allocator.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * A binary buddy allocator over physical memory. Blocks are a power of two number of pages, from a
+ * single 4KiB page (order 0) up to 1MiB (order PAGE_MAX_ORDER), and are aligned to their own size.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef KERNEL_PAGE_H
+#define KERNEL_PAGE_H
+
+#include "common/types.h"
+
+#define PAGE_SHIFT     12
+#define PAGE_SIZE      (1 << PAGE_SHIFT)
+#define PAGE_MAX_ORDER 8
+#define PAGE_ORDERS    (PAGE_MAX_ORDER + 1)
+
+enum PageReturn {
+    PAGE_GOOD          = 0,
+    PAGE_NO_MEMORY     = -1,
+    PAGE_BAD_ORDER     = -2,
+    PAGE_BAD_ADDRESS   = -3,
+    PAGE_NOT_ALLOCATED = -4,
+};
+
+/**
+ * @brief Metadata kept for every page frame managed by the allocator.
+ *
+ * Free lists are threaded through the metadata rather than the free pages themselves, so the
+ * allocator never touches the memory it hands out.
+ */
+struct page_t {
+    u32_t next;   // Frame of the next free block of the same order, if this heads a free block.
+    u32_t prev;   // Frame of the previous free block of the same order.
+    u8_t order;   // Order of the block this page heads.
+    u8_t flags;   // PAGE_FLAG_* bits.
+    u16_t unused; // Padding.
+};
+
+u32_t page_metadata_size(ptr_t base, u32_t size);
+void page_init(ptr_t base, u32_t size, struct page_t* metadata);
+void page_add_free_range(ptr_t start, ptr_t end);
+
+enum PageReturn page_alloc(u32_t order, ptr_t* address);
+enum PageReturn page_free(ptr_t address);
+enum PageReturn page_block_order(ptr_t address, u32_t* order);
+
+u32_t page_order_for_size(u32_t size);
+u32_t page_free_count(u32_t order);
+u32_t page_free_pages(void);
+
+#endif
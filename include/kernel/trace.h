@@ -0,0 +1,117 @@
+/**
+ * @file trace.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Binary event tracing over the UART.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Trace points are compiled in with `make TRACE=1`, and compile to nothing otherwise. Each writes
+ * a small fixed record to a ring, lock free like the kernel log, and the console streams the ring
+ * out in framed batches while it is idle. tools/trace_decode turns a capture of the serial output
+ * into Chrome trace JSON. Console text between the frames is skipped by the decoder.
+ *
+ * The interrupt that carries the stream must be left out with `trace_ignore_irq`, or every frame
+ * sent would trace the interrupts that send it, and the ring would never empty.
+ *
+ * A frame, all little endian:
+ *
+ *     offset  size
+ *          0     2  TRACE_MAGIC, "TR"
+ *          2     1  TRACE_VERSION
+ *          3     1  Number of records, 1 to TRACE_BATCH
+ *          4     4  Sequence number of the first record, a gap from the last frame means records
+ *                   were overwritten before they could be sent
+ *          8     8  Time of the first record, in microseconds
+ *         16  16*n  Records: u16 event, u16 reserved, i32 microseconds since the previous record
+ *                   (the first is 0), u32 arg0, u32 arg1
+ *       last     4  CRC-32 of everything before it
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef KERNEL_TRACE_H
+#define KERNEL_TRACE_H
+
+#include "common/types.h"
+#include "kernel/trace_events.h"
+
+/// @brief Number of records in the ring, a power of two.
+#define TRACE_RECORDS 256
+
+/// @brief Most records in one frame.
+#define TRACE_BATCH 32
+
+#define TRACE_MAGIC         0x5254 // "TR"
+#define TRACE_VERSION       1
+#define TRACE_HEADER_SIZE   16
+#define TRACE_RECORD_SIZE   16
+#define TRACE_CHECKSUM_SIZE 4
+
+/// @brief Size of a frame of `count` records.
+#define TRACE_FRAME_SIZE(count)                                                                    \
+    (TRACE_HEADER_SIZE + (count) * TRACE_RECORD_SIZE + TRACE_CHECKSUM_SIZE)
+
+enum TraceEvent {
+#define TRACE_EVENT_ID(id, name, phase, track) id,
+    TRACE_EVENTS(TRACE_EVENT_ID)
+#undef TRACE_EVENT_ID
+    TRACE_EVENT_COUNT,
+};
+
+/**
+ * @brief Source of the record timestamps, in microseconds.
+ */
+typedef u64_t (*trace_clock_t)(void);
+
+/**
+ * @brief Where frames are written.
+ *
+ * @param data The frame.
+ * @param length Size of the frame.
+ * @return u32_t The number of bytes written.
+ */
+typedef u32_t (*trace_write_t)(const char* data, u32_t length);
+
+void trace_init(trace_clock_t clock);
+void trace_ignore_irq(u32_t irq);
+bool trace_irq_wanted(u32_t irq);
+void trace_emit(enum TraceEvent event, u32_t arg0, u32_t arg1);
+bool trace_pending(void);
+u32_t trace_stream(trace_write_t write);
+u32_t trace_crc32(const u8_t* data, u32_t length);
+
+/**
+ * @brief A trace point. Safe from any context, interrupt handlers included.
+ *
+ * @param event The event.
+ * @param arg0 First argument, see trace_events.h.
+ * @param arg1 Second argument, see trace_events.h.
+ */
+static inline void trace(enum TraceEvent event, u32_t arg0, u32_t arg1) {
+#ifdef TRACE_ENABLED
+    trace_emit(event, arg0, arg1);
+#else
+    (void)event;
+    (void)arg0;
+    (void)arg1;
+#endif
+}
+
+/**
+ * @brief A trace point around an interrupt handler, skipped for interrupts left out with
+ * `trace_ignore_irq`.
+ *
+ * @param event TRACE_IRQ_BEGIN or TRACE_IRQ_END.
+ * @param irq The interrupt number.
+ */
+static inline void trace_irq(enum TraceEvent event, u32_t irq) {
+#ifdef TRACE_ENABLED
+    if (trace_irq_wanted(irq)) {
+        trace_emit(event, irq, 0);
+    }
+#else
+    (void)event;
+    (void)irq;
+#endif
+}
+
+#endif // trace.h
@@ -0,0 +1,33 @@
+/**
+ * @file trace_events.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief The trace events of the kernel.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * One X-macro list, so the kernel and the host decoder in tools/trace_decode.c number and name
+ * the events the same way. Add new events at the end, so older captures still decode.
+ *
+ * Each entry is X(id, name, phase, track):
+ * - `id`, the enum TraceEvent constant.
+ * - `name`, shown in the trace viewer. A begin and its end share a name.
+ * - `phase`, the Chrome trace phase: 'B' and 'E' begin and end a slice on the track, 'b' and 'e'
+ *   begin and end an asynchronous slice matched by `arg0`, and 'i' is an instant.
+ * - `track`, 0 for normal code and 1 for interrupt handlers, so their slices nest.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef KERNEL_TRACE_EVENTS_H
+#define KERNEL_TRACE_EVENTS_H
+
+#define TRACE_EVENTS(X)                                                                            \
+    X(TRACE_BOOT_STEP_BEGIN, "boot_step", 'B', 0) /* arg0: line in boot.c */                       \
+    X(TRACE_BOOT_STEP_END, "boot_step", 'E', 0)   /* arg0: line in boot.c, arg1: failed */         \
+    X(TRACE_IRQ_BEGIN, "irq", 'B', 1)             /* arg0: interrupt number */                     \
+    X(TRACE_IRQ_END, "irq", 'E', 1)               /* arg0: interrupt number */                     \
+    X(TRACE_MAILBOX_SUBMIT, "mailbox", 'b', 0)    /* arg0: completion, arg1: channel */            \
+    X(TRACE_MAILBOX_COMPLETE, "mailbox", 'e', 1)  /* arg0: completion, arg1: channel */            \
+    X(TRACE_UART_DMA_BEGIN, "uart_dma", 'b', 0)   /* arg0: DMA channel, arg1: bytes */             \
+    X(TRACE_UART_DMA_END, "uart_dma", 'e', 1)     /* arg0: DMA channel, arg1: status */
+
+#endif // trace_events.h
@@ -10,29 +10,110 @@
 #include "common/common.h"
 #include "common/types.h"
 #include "drivers/clock.h"
+#include "drivers/clock_rate.h"
+#include "drivers/drivers.h"
 #include "drivers/dt.h"
+#include "drivers/firmware.h"
+#include "drivers/irq.h"
+#include "drivers/mbox.h"
 #include "drivers/uart.h"
+#include "kernel/arena.h"
+#include "kernel/console.h"
+#include "kernel/klog.h"
 #include "kernel/mm.h"
+#include "kernel/mmu.h"
+#include "kernel/trace.h"
 
+/// @brief The boot arena, from linker.ld.
+extern u8_t __boot_arena_start[];
+extern u8_t __boot_arena_end[];
+
+#ifdef BOOT_CACHE_BENCH
+/// @brief The kernel text, from linker.ld.
+extern u8_t __text_start[];
+extern u8_t __text_end[];
+
+/// @brief Number of passes over the kernel text made by the cache benchmark.
+#define BOOT_BENCH_PASSES 8
+
+/// @brief Keeps the result of the cache benchmark workload alive.
+static volatile u32_t boot_bench_sink;
+#endif
+
+/**
+ * @brief Log a boot message. It reaches the UART once the console drains the kernel log.
+ *
+ * @param msg The message.
+ */
 void boot_info_uart(const char* msg) {
-    u64_t time = clock_micros();
-    uart_putch('[');
-    uart_putu((u32_t)time);
-    uart_puts("]:\t");
-    uart_puts(msg);
-    uart_putch('\n');
+    klog(KLOG_INFO, "%s", msg);
+}
+
+#ifdef BOOT_CACHE_BENCH
+/**
+ * @brief Time a pass of FNV-1a over the kernel text, a mix of instruction fetches, loads and
+ * branches.
+ *
+ * @return u32_t The time taken in microseconds.
+ */
+static u32_t boot_bench_time(void) {
+    const u32_t* word = (const u32_t*)__text_start;
+    u32_t words       = (u32_t)(__text_end - __text_start) / sizeof(u32_t);
+    u32_t hash        = 0x811c9dc5;
+    u64_t start       = clock_micros();
+
+    for (u32_t pass = 0; pass < BOOT_BENCH_PASSES; pass++) {
+        for (u32_t i = 0; i < words; i++) {
+            hash = (hash ^ word[i]) * 0x01000193;
+        }
+    }
+
+    boot_bench_sink = hash;
+    return (u32_t)(clock_micros() - start);
 }
 
+/**
+ * @brief Report how much faster the caches make the kernel, by running the same loop with them on
+ * and off. Only built with `make CACHE_BENCH=1`.
+ *
+ * IRQs stay masked throughout, so no handler runs with the caches off.
+ */
+static void boot_report_cache_speedup(void) {
+    u32_t flags  = irq_save();
+    u32_t cached = boot_bench_time();
+    mmu_set_caches(false);
+    u32_t uncached = boot_bench_time();
+    mmu_set_caches(true);
+    irq_restore(flags);
+
+    // Speedup in tenths.
+    u32_t tenths = cached ? uncached * 10 / cached : 0;
+
+    klog(KLOG_INFO, "Cache benchmark: cached %uus, uncached %uus, speedup %u.%ux", cached,
+         uncached, tenths / 10, tenths % 10);
+}
+#endif
+
+/**
+ * @brief Stop the kernel, after writing out the whole kernel log.
+ */
 void boot_panic() {
+    __irq_cpu_disable();
+    console_panic_log();
+    uart_flush();
+
     while (true)
     ;
 }
 
 #define verify_valid_boot(func, exp, msg) \
+    trace(TRACE_BOOT_STEP_BEGIN, __LINE__, 0); \
     if ((func) != (exp)) { \
-        boot_info_uart(msg); \
+        trace(TRACE_BOOT_STEP_END, __LINE__, true); \
+        klog(KLOG_ERROR, "%s", msg); \
         boot_panic(); \
-    }
+    } \
+    trace(TRACE_BOOT_STEP_END, __LINE__, false);
 
 /**
  * @brief Do all of the low level driver initialisation and setup.
@@ -46,23 +127,35 @@ void boot_main(u32_t r0, u32_t r1, ptr_t dtb) {
     (void)r1;
 
     common_init();
+    klog_init(clock_micros);
+    trace_init(clock_micros);
+    trace_ignore_irq(IRQ_UART); // The trace is streamed over the UART.
     uart_init();
+    console_init(uart_write);
+    arena_init(__boot_arena_start, (u32_t)(__boot_arena_end - __boot_arena_start));
     
     boot_info_uart("Initialising PioneerOS.");
     
     verify_valid_boot(dt_init((void*)dtb), DT_GOOD, "Failed to initialise the device tree.");
+    verify_valid_boot(drivers_probe(), DT_GOOD, "Failed to probe device drivers.");
+    verify_valid_boot(firmware_init(), FIRMWARE_GOOD, "Failed to read the firmware properties.");
     verify_valid_boot(mm_init(), MM_GOOD, "Failed to initialise the memory map.");
+    verify_valid_boot(mailbox_enable_irq(), MBOX_GOOD, "Failed to enable the mailbox interrupt.");
+    verify_valid_boot(uart_enable_irq(), UART_GOOD, "Failed to enable the UART interrupt.");
+    verify_valid_boot(uart_enable_dma(), UART_GOOD, "Failed to set up the UART DMA channel.");
+    __irq_cpu_enable();
+    verify_valid_boot(clock_rate_init(), CLOCK_RATE_GOOD, "Failed to set up the clock rates.");
+    verify_valid_boot(uart_set_baud(UART_BAUD), UART_GOOD, "Failed to set the UART line speed.");
+
+    klog(KLOG_INFO, "Clock rates: ARM %uHz, core %uHz, UART %uHz at %u baud",
+         clock_rate_current(CLOCK_ID_ARM), clock_rate_current(CLOCK_ID_CORE),
+         clock_rate_current(CLOCK_ID_UART), uart_baud());
+
+#ifdef BOOT_CACHE_BENCH
+    boot_report_cache_speedup();
+#endif
 
     boot_info_uart("Initialisation complete.");
 
-    while (1) {
-        unsigned char in = uart_getch();
-        if (in == (unsigned char)'\r') {
-            uart_puts("\r\n");
-        } else if ((i32_t)in == 127) { // Backspace
-            uart_puts("\e[1D\e[0J");
-        } else {
-            uart_putch(in);
-        }
-    }
-}
\ No newline at end of file
+    console_run();
+}
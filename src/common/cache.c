@@ -0,0 +1,83 @@
+/**
+ * @file cache.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief L1 data cache maintenance implementation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Each operation walks the range a line at a time with the CP15 c7 by-address operations, then
+ * waits for them to finish.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "common/cache.h"
+#include "common/types.h"
+
+/// @brief Round an address down to the start of its cache line.
+#define CACHE_LINE_START(address) ((address) & ~(uintptr_t)(CACHE_LINE_SIZE - 1))
+
+/**
+ * @brief Write any dirty lines in a range back to memory, keeping them in the cache.
+ *
+ * Use before a device reads memory that the ARM has written.
+ *
+ * @param start The start of the range.
+ * @param size The size of the range in bytes.
+ */
+void cache_clean_range(const void* start, u32_t size) {
+    uintptr_t end = (uintptr_t)start + size;
+
+    for (uintptr_t line = CACHE_LINE_START((uintptr_t)start); line < end;
+         line += CACHE_LINE_SIZE) {
+        asm volatile("mcr p15, 0, %0, c7, c10, 1" : : "r"(line) : "memory");
+    }
+    __data_sync_barrier();
+}
+
+/**
+ * @brief Discard the lines of a range from the cache, so the next reads come from memory.
+ *
+ * Use before the ARM reads memory that a device has written. A line that the range only partly
+ * covers may hold data of a neighbour, so those are cleaned as well rather than thrown away.
+ *
+ * @param start The start of the range.
+ * @param size The size of the range in bytes.
+ */
+void cache_invalidate_range(void* start, u32_t size) {
+    uintptr_t first = (uintptr_t)start;
+    uintptr_t end   = first + size;
+
+    if (size == 0) {
+        return;
+    }
+
+    if (first & (CACHE_LINE_SIZE - 1)) {
+        asm volatile("mcr p15, 0, %0, c7, c14, 1" : : "r"(CACHE_LINE_START(first)) : "memory");
+    }
+    if (end & (CACHE_LINE_SIZE - 1)) {
+        asm volatile("mcr p15, 0, %0, c7, c14, 1" : : "r"(CACHE_LINE_START(end)) : "memory");
+    }
+
+    for (uintptr_t line = CACHE_LINE_START(first); line < end; line += CACHE_LINE_SIZE) {
+        asm volatile("mcr p15, 0, %0, c7, c6, 1" : : "r"(line) : "memory");
+    }
+    __data_sync_barrier();
+}
+
+/**
+ * @brief Write any dirty lines in a range back to memory and discard them from the cache.
+ *
+ * Use on a buffer that a device both reads and writes.
+ *
+ * @param start The start of the range.
+ * @param size The size of the range in bytes.
+ */
+void cache_clean_invalidate_range(void* start, u32_t size) {
+    uintptr_t end = (uintptr_t)start + size;
+
+    for (uintptr_t line = CACHE_LINE_START((uintptr_t)start); line < end;
+         line += CACHE_LINE_SIZE) {
+        asm volatile("mcr p15, 0, %0, c7, c14, 1" : : "r"(line) : "memory");
+    }
+    __data_sync_barrier();
+}
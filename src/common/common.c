@@ -10,19 +10,20 @@
 #include "common/common.h"
 #include "common/types.h"
 
-static u32_t test = 0x1234;
-
 /**
- * @brief Boolean representing system endianess, configured after `common_init()`. If `beTest` then
- * the system is big endian.
+ * @brief Iterations of the `spin_delay` loop per microsecond before calibration, for the firmware
+ * default ARM clock of 700MHz at two cycles an iteration.
  */
-bool beTest = false;
+#define SPIN_DEFAULT_LOOPS_PER_MICRO 350
+
+/// @brief Iterations of the `spin_delay` loop per microsecond at the current ARM clock.
+static u32_t spin_loops_per_micro = SPIN_DEFAULT_LOOPS_PER_MICRO;
 
 /**
  * @brief Initialise common functions.
  *
  */
-void common_init(void) { beTest = *(u8_t*)&test == (u8_t)0x12; }
+void common_init(void) {}
 
 /**
  * @brief Spin the cpu COUNT cycles.
@@ -30,54 +31,38 @@ void common_init(void) { beTest = *(u8_t*)&test == (u8_t)0x12; }
  * @param count Number of cycles to spin.
  */
 inline void spin_delay(u32_t count) {
+#if defined(__arm__)
     asm volatile("__spin_delay_%=: subs %[count], %[count], #1; bne __spin_delay_%=\n"
                  : "=r"(count)
                  : [count] "0"(count)
                  : "cc");
-}
-
-/**
- * @brief Big endian to host short.
- *
- * @param bg32 The value to translate.
- * @return u32_t The translated value.
- */
-u16_t beths(u16_t bg16) {
-    if (beTest) {
-        return bg16;
-    } else {
-        return ((bg16 & 0xff00) >> 8) | ((bg16 & 0xff) << 8);
+#else
+    // Host builds (the test suite) only need the delay to not be optimised away.
+    while (count-- > 0) {
+        asm volatile("" : : : "memory");
     }
+#endif
 }
 
 /**
- * @brief Big endian to host.
+ * @brief Set how many iterations of `spin_delay` take a microsecond, measured whenever the ARM
+ * clock changes.
  *
- * @param bg32 The value to translate.
- * @return u32_t The translated value.
+ * @param loopsPerMicro Iterations per microsecond, 0 is ignored.
  */
-u32_t beth(u32_t bg32) {
-    if (beTest) {
-        return bg32;
-    } else {
-        return ((bg32 & 0xff) << 24) | ((bg32 & 0xff00) << 8) | ((bg32 & 0xff0000) >> 8) |
-               ((bg32 & 0xff000000) >> 24);
+void spin_delay_calibrate(u32_t loopsPerMicro) {
+    if (loopsPerMicro) {
+        spin_loops_per_micro = loopsPerMicro;
     }
 }
 
 /**
- * @brief Big endian to host long.
+ * @brief Spin the cpu for at least MICROS microseconds.
  *
- * @param bg32 The value to translate.
- * @return u64_t The translated value.
+ * @param micros Number of microseconds to spin.
  */
-u64_t bethl(u64_t bg64) {
-    if (beTest) {
-        return bg64;
-    } else {
-        return ((bg64 & 0xff) << 56) | ((bg64 & 0xff00) << 40) | ((bg64 & 0xff0000) << 24) |
-               ((bg64 & 0xff000000) << 8) | ((bg64 & 0xff00000000) >> 8) |
-               ((bg64 & 0xff0000000000) >> 24) | ((bg64 & 0xff000000000000) >> 40) |
-               ((bg64 & 0xff00000000000000) >> 56);
+void spin_delay_micros(u32_t micros) {
+    while (micros-- > 0) {
+        spin_delay(spin_loops_per_micro);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,167 @@
+/**
+ * @file divide.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Integer division runtime.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Division is shift and subtract. The divisor is first lined up with the top bit of the dividend
+ * using the leading zero counts, so the loop only runs once per possible quotient bit, and it stops
+ * as soon as nothing is left of the dividend.
+ *
+ * Dividing by zero gives a quotient of 0 and the dividend as the remainder, as the ARM hardware
+ * dividers of later cores do, rather than trapping.
+ *
+ * The 64 bit EABI helpers return their remainder in r2 and r3, which C can not express, so they
+ * are wrapped in aeabi.S.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "common/divide.h"
+#include "common/types.h"
+
+/**
+ * @brief Count the leading zeros of a non zero 64 bit value, without the libgcc helper.
+ *
+ * @param value The value.
+ * @return u32_t The number of leading zeros.
+ */
+static inline u32_t divide_clz_u64(u64_t value) {
+    u32_t high = (u32_t)(value >> 32);
+    return high ? (u32_t)__builtin_clz(high) : 32 + (u32_t)__builtin_clz((u32_t)value);
+}
+
+/**
+ * @brief Unsigned 32 bit division.
+ *
+ * @param dividend The dividend.
+ * @param divisor The divisor.
+ * @param remainder Set to the remainder, unless NULL.
+ * @return u32_t The quotient.
+ */
+u32_t divide_u32(u32_t dividend, u32_t divisor, u32_t* remainder) {
+    u32_t quotient = 0;
+
+    if (divisor != 0 && divisor <= dividend) {
+        u32_t shift = (u32_t)(__builtin_clz(divisor) - __builtin_clz(dividend));
+        divisor <<= shift;
+
+        for (u32_t bit = 1u << shift; bit && dividend; bit >>= 1, divisor >>= 1) {
+            if (dividend >= divisor) {
+                dividend -= divisor;
+                quotient |= bit;
+            }
+        }
+    }
+
+    if (remainder) {
+        *remainder = dividend;
+    }
+    return quotient;
+}
+
+/**
+ * @brief Unsigned 64 bit division, handed to `divide_u32` when both halves fit.
+ *
+ * @param dividend The dividend.
+ * @param divisor The divisor.
+ * @param remainder Set to the remainder, unless NULL.
+ * @return u64_t The quotient.
+ */
+u64_t divide_u64(u64_t dividend, u64_t divisor, u64_t* remainder) {
+    if (!(dividend >> 32) && !(divisor >> 32)) {
+        u32_t remainder32;
+        u32_t quotient = divide_u32((u32_t)dividend, (u32_t)divisor, &remainder32);
+        if (remainder) {
+            *remainder = remainder32;
+        }
+        return quotient;
+    }
+
+    u64_t quotient = 0;
+
+    if (divisor != 0 && divisor <= dividend) {
+        u32_t shift = divide_clz_u64(divisor) - divide_clz_u64(dividend);
+        divisor <<= shift;
+
+        for (u64_t bit = 1ull << shift; bit && dividend; bit >>= 1, divisor >>= 1) {
+            if (dividend >= divisor) {
+                dividend -= divisor;
+                quotient |= bit;
+            }
+        }
+    }
+
+    if (remainder) {
+        *remainder = dividend;
+    }
+    return quotient;
+}
+
+/**
+ * @brief Signed 32 bit division, rounding towards zero like C.
+ *
+ * @param dividend The dividend.
+ * @param divisor The divisor.
+ * @param remainder Set to the remainder, which has the sign of the dividend, unless NULL.
+ * @return i32_t The quotient.
+ */
+i32_t divide_i32(i32_t dividend, i32_t divisor, i32_t* remainder) {
+    u32_t magnitude = dividend < 0 ? -(u32_t)dividend : (u32_t)dividend;
+    u32_t by        = divisor < 0 ? -(u32_t)divisor : (u32_t)divisor;
+    u32_t rest;
+    u32_t quotient = divide_u32(magnitude, by, &rest);
+
+    if (remainder) {
+        *remainder = (i32_t)(dividend < 0 ? -rest : rest);
+    }
+    return (i32_t)((dividend < 0) != (divisor < 0) ? -quotient : quotient);
+}
+
+/**
+ * @brief Signed 64 bit division, rounding towards zero like C.
+ *
+ * @param dividend The dividend.
+ * @param divisor The divisor.
+ * @param remainder Set to the remainder, which has the sign of the dividend, unless NULL.
+ * @return i64_t The quotient.
+ */
+i64_t divide_i64(i64_t dividend, i64_t divisor, i64_t* remainder) {
+    u64_t magnitude = dividend < 0 ? -(u64_t)dividend : (u64_t)dividend;
+    u64_t by        = divisor < 0 ? -(u64_t)divisor : (u64_t)divisor;
+    u64_t rest;
+    u64_t quotient = divide_u64(magnitude, by, &rest);
+
+    if (remainder) {
+        *remainder = (i64_t)(dividend < 0 ? -rest : rest);
+    }
+    return (i64_t)((dividend < 0) != (divisor < 0) ? -quotient : quotient);
+}
+
+// ARM EABI run-time helpers, called by the compiler for `/` and `%`. The divmod variants return the
+// quotient in r0 and the remainder in r1, which is a 64 bit return with the remainder on top.
+
+u32_t __aeabi_uidiv(u32_t dividend, u32_t divisor);
+i32_t __aeabi_idiv(i32_t dividend, i32_t divisor);
+u64_t __aeabi_uidivmod(u32_t dividend, u32_t divisor);
+u64_t __aeabi_idivmod(i32_t dividend, i32_t divisor);
+
+u32_t __aeabi_uidiv(u32_t dividend, u32_t divisor) {
+    return divide_u32(dividend, divisor, NULL);
+}
+
+i32_t __aeabi_idiv(i32_t dividend, i32_t divisor) {
+    return divide_i32(dividend, divisor, NULL);
+}
+
+u64_t __aeabi_uidivmod(u32_t dividend, u32_t divisor) {
+    u32_t remainder;
+    u32_t quotient = divide_u32(dividend, divisor, &remainder);
+    return ((u64_t)remainder << 32) | quotient;
+}
+
+u64_t __aeabi_idivmod(i32_t dividend, i32_t divisor) {
+    i32_t remainder;
+    i32_t quotient = divide_i32(dividend, divisor, &remainder);
+    return ((u64_t)(u32_t)remainder << 32) | (u32_t)quotient;
+}
@@ -0,0 +1,321 @@
+/**
+ * @file format.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Formatted output engine and division free number conversion.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "common/format.h"
+#include "common/divide.h"
+#include "common/string.h"
+#include "common/types.h"
+
+/// @brief The decimal digits of 0 to 99, two characters each.
+static const char format_digit_pairs[201] = "0001020304050607080910111213141516171819"
+                                            "2021222324252627282930313233343536373839"
+                                            "4041424344454647484950515253545556575859"
+                                            "6061626364656667686970717273747576777879"
+                                            "8081828384858687888990919293949596979899";
+
+static const char format_hex_lower[16] = "0123456789abcdef";
+static const char format_hex_upper[16] = "0123456789ABCDEF";
+
+/// @brief Characters used to pad fields, written out a block at a time.
+#define FORMAT_PAD_BLOCK 16
+static const char format_spaces[FORMAT_PAD_BLOCK] = "                ";
+static const char format_zeros[FORMAT_PAD_BLOCK]  = "0000000000000000";
+
+/**
+ * @brief Write the two digits of a value below 100 in front of `head`.
+ *
+ * @param head One past where the second digit goes.
+ * @param value The value, less than 100.
+ * @return char* The first digit written.
+ */
+static inline char* format_pair(char* head, u32_t value) {
+    const char* pair = format_digit_pairs + value * 2;
+
+    head -= 2;
+    head[0] = pair[0];
+    head[1] = pair[1];
+    return head;
+}
+
+/**
+ * @brief Convert an unsigned integer to decimal, writing backwards from `end`.
+ *
+ * @param end One past the last character to write, with at least 10 characters before it.
+ * @param value The value to convert.
+ * @return char* The first digit. The digits are not null terminated.
+ */
+char* format_decimal_u32(char* end, u32_t value) {
+    char* head = end;
+
+    while (value >= 100) {
+        u32_t quotient = divide_u32_by_100(value);
+        head           = format_pair(head, value - quotient * 100);
+        value          = quotient;
+    }
+
+    if (value >= 10) {
+        return format_pair(head, value);
+    }
+    *--head = (char)('0' + value);
+    return head;
+}
+
+/**
+ * @brief Convert a long unsigned integer to decimal, writing backwards from `end`.
+ *
+ * Pairs are peeled off with the 64 bit reciprocal only until the rest fits in 32 bits.
+ *
+ * @param end One past the last character to write, with at least 20 characters before it.
+ * @param value The value to convert.
+ * @return char* The first digit. The digits are not null terminated.
+ */
+char* format_decimal_u64(char* end, u64_t value) {
+    char* head = end;
+
+    while (value >> 32) {
+        u64_t quotient = divide_u64_by_100(value);
+        head           = format_pair(head, (u32_t)(value - quotient * 100));
+        value          = quotient;
+    }
+
+    return format_decimal_u32(head, (u32_t)value);
+}
+
+/**
+ * @brief Convert a long unsigned integer to hexadecimal, writing backwards from `end`.
+ *
+ * @param end One past the last character to write, with at least 16 characters before it.
+ * @param value The value to convert.
+ * @param upper Use upper case digits.
+ * @return char* The first digit. The digits are not null terminated.
+ */
+char* format_hexadecimal(char* end, u64_t value, bool upper) {
+    const char* digits = upper ? format_hex_upper : format_hex_lower;
+    char* head         = end;
+
+    do {
+        *--head = digits[value & 0xf];
+        value >>= 4;
+    } while (value);
+
+    return head;
+}
+
+/// @brief Conversion flags.
+enum FormatFlags {
+    FORMAT_LEFT = 1 << 0, // '-', pad on the right.
+    FORMAT_ZERO = 1 << 1, // '0', pad numbers with zeros.
+};
+
+/**
+ * @brief State of one call to `format_vprint`.
+ */
+struct format_output_t {
+    format_sink_t sink;
+    void* context;
+    u32_t written;
+};
+
+static void format_emit(struct format_output_t* out, const char* data, u32_t length) {
+    if (length) {
+        out->sink(out->context, data, length);
+        out->written += length;
+    }
+}
+
+static void format_pad(struct format_output_t* out, const char* block, u32_t count) {
+    while (count > FORMAT_PAD_BLOCK) {
+        format_emit(out, block, FORMAT_PAD_BLOCK);
+        count -= FORMAT_PAD_BLOCK;
+    }
+    format_emit(out, block, count);
+}
+
+/**
+ * @brief Write one converted field, padded to its width.
+ *
+ * @param out The output.
+ * @param prefix Sign or radix prefix, which zero padding goes after.
+ * @param text The converted value.
+ * @param length Length of the converted value.
+ * @param width Minimum width of the whole field.
+ * @param flags The flags of the conversion.
+ */
+static void format_field(struct format_output_t* out, const char* prefix, const char* text,
+                         u32_t length, u32_t width, u32_t flags) {
+    u32_t prefixLength = (u32_t)strlen(prefix);
+    u32_t total        = prefixLength + length;
+    u32_t padding      = width > total ? width - total : 0;
+
+    if (flags & FORMAT_LEFT) {
+        format_emit(out, prefix, prefixLength);
+        format_emit(out, text, length);
+        format_pad(out, format_spaces, padding);
+    } else if (flags & FORMAT_ZERO) {
+        format_emit(out, prefix, prefixLength);
+        format_pad(out, format_zeros, padding);
+        format_emit(out, text, length);
+    } else {
+        format_pad(out, format_spaces, padding);
+        format_emit(out, prefix, prefixLength);
+        format_emit(out, text, length);
+    }
+}
+
+/**
+ * @brief Format a string and its arguments into a sink.
+ *
+ * Literal text is passed on in runs rather than a character at a time. An unknown conversion is
+ * written out as it is.
+ *
+ * @param sink Receives the output.
+ * @param context Passed to the sink.
+ * @param format The format string.
+ * @param ap The arguments.
+ * @return int The number of characters written.
+ */
+int format_vprint(format_sink_t sink, void* context, const char* format, va_list ap) {
+    struct format_output_t out = {sink, context, 0};
+
+    while (*format != '\0') {
+        const char* run = format;
+        while (*format != '\0' && *format != '%') {
+            format++;
+        }
+        format_emit(&out, run, (u32_t)(format - run));
+        if (*format == '\0') {
+            break;
+        }
+        const char* conversion = format++;
+
+        u32_t flags = 0;
+        for (;; format++) {
+            if (*format == '-') {
+                flags |= FORMAT_LEFT;
+            } else if (*format == '0') {
+                flags |= FORMAT_ZERO;
+            } else {
+                break;
+            }
+        }
+
+        u32_t width = 0;
+        if (*format == '*') {
+            int argument = va_arg(ap, int);
+            if (argument < 0) {
+                flags |= FORMAT_LEFT;
+                argument = -argument;
+            }
+            width = (u32_t)argument;
+            format++;
+        } else {
+            while (*format >= '0' && *format <= '9') {
+                width = width * 10 + (u32_t)(*format++ - '0');
+            }
+        }
+
+        u32_t longs = 0;
+        while (*format == 'l') {
+            longs++;
+            format++;
+        }
+
+        char number[FORMAT_NUMBER_SIZE];
+        char* end          = number + FORMAT_NUMBER_SIZE;
+        const char* prefix = "";
+        const char* text   = end;
+        u64_t value        = 0;
+
+        switch (*format) {
+        case 'd':
+        case 'i': {
+            i64_t signedValue;
+            if (longs >= 2) {
+                signedValue = va_arg(ap, long long);
+            } else if (longs == 1) {
+                signedValue = va_arg(ap, long);
+            } else {
+                signedValue = va_arg(ap, int);
+            }
+            value = signedValue < 0 ? -(u64_t)signedValue : (u64_t)signedValue;
+            if (signedValue < 0) {
+                prefix = "-";
+            }
+            text = format_decimal_u64(end, value);
+            break;
+        }
+        case 'u':
+        case 'x':
+        case 'X':
+            if (longs >= 2) {
+                value = va_arg(ap, unsigned long long);
+            } else if (longs == 1) {
+                value = va_arg(ap, unsigned long);
+            } else {
+                value = va_arg(ap, unsigned int);
+            }
+            if (*format == 'u') {
+                text = format_decimal_u64(end, value);
+            } else {
+                text = format_hexadecimal(end, value, *format == 'X');
+            }
+            break;
+        case 'p':
+            prefix = "0x";
+            text   = format_hexadecimal(end, (uintptr_t)va_arg(ap, void*), false);
+            break;
+        case 's':
+            text = va_arg(ap, const char*);
+            if (text == NULL) {
+                text = "(null)";
+            }
+            end = (char*)text + strlen(text);
+            flags &= ~FORMAT_ZERO;
+            break;
+        case 'c':
+            number[0] = (char)va_arg(ap, int);
+            text      = number;
+            end       = number + 1;
+            flags &= ~FORMAT_ZERO;
+            break;
+        case '%':
+            format_emit(&out, "%", 1);
+            format++;
+            continue;
+        default:
+            // Unknown or truncated conversion, written out unchanged.
+            if (*format != '\0') {
+                format++;
+            }
+            format_emit(&out, conversion, (u32_t)(format - conversion));
+            continue;
+        }
+
+        format_field(&out, prefix, text, (u32_t)(end - text), width, flags);
+        format++;
+    }
+
+    return (int)out.written;
+}
+
+/**
+ * @brief Format a string and its arguments into a sink.
+ *
+ * @param sink Receives the output.
+ * @param context Passed to the sink.
+ * @param format The format string.
+ * @return int The number of characters written.
+ */
+int format_print(format_sink_t sink, void* context, const char* format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    int written = format_vprint(sink, context, format, ap);
+    va_end(ap);
+    return written;
+}
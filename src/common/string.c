@@ -38,17 +38,19 @@ const char* strchr(const char* str, char c) {
  * @return >0 If the first string is greater than the second.
  * @return <0 If the second string is greater than the first.
  */
-int strncmp(const char* fst, const char* snd, unsigned int n) {
-    char c;
-    while(n-- > 0 && (c = *fst++) == *snd++) {
+int strncmp(const char* fst, const char* snd, size_t n) {
+    while (n-- > 0) {
+        char c = *fst++;
+        char d = *snd++;
+        if (c != d) {
+            return (u8_t)c > (u8_t)d ? 1 : -1;
+        }
         if (c == '\0') {
             return 0;
         }
     }
 
-    return n == 0 ? 0 : (
-        *--fst > *--snd ? 1 : -1
-    );
+    return 0;
 }
 
 char* strncpy(char* destination, const char* source, size_t num) {
@@ -1,25 +1,52 @@
 #include "drivers/clock.h"
 #include "common/mmio.h"
+#include "drivers/dt.h"
 
-enum ClockPhysicalAddress {
-    CLOCK_BASE                = 0x20003000,
-    CLOCK_CONTROL_REG         = (CLOCK_BASE + 0x00),
-    CLOCK_SYS_TIMER_LOW       = (CLOCK_BASE + 0x04),
-    CLOCK_SYS_TIMER_HIGH      = (CLOCK_BASE + 0x08),
-    CLOCK_SYS_TIMER_COMPARE_0 = (CLOCK_BASE + 0x0c),
-    CLOCK_SYS_TIMER_COMPARE_1 = (CLOCK_BASE + 0x10),
-    CLOCK_SYS_TIMER_COMPARE_2 = (CLOCK_BASE + 0x14),
-    CLOCK_SYS_TIMER_COMPARE_3 = (CLOCK_BASE + 0x18),
+/**
+ * @brief Default physical base address of the system timer, used until the device tree has been
+ * probed.
+ */
+#define CLOCK_DEFAULT_BASE 0x20003000
+
+/**
+ * @brief Register offsets for the system timer, from the system timer base address.
+ */
+enum ClockRegisterOffset {
+    CLOCK_CONTROL_REG         = 0x00,
+    CLOCK_SYS_TIMER_LOW       = 0x04,
+    CLOCK_SYS_TIMER_HIGH      = 0x08,
+    CLOCK_SYS_TIMER_COMPARE_0 = 0x0c,
+    CLOCK_SYS_TIMER_COMPARE_1 = 0x10,
+    CLOCK_SYS_TIMER_COMPARE_2 = 0x14,
+    CLOCK_SYS_TIMER_COMPARE_3 = 0x18,
 };
 
+/// @brief Physical base address of the system timer registers.
+static ptr_t clock_base = CLOCK_DEFAULT_BASE;
+
+/**
+ * @brief Device tree probe, records the system timer base address.
+ *
+ * @param node The system timer node.
+ * @return enum dt_return_value_t Return value.
+ */
+static enum dt_return_value_t clock_probe(const struct dt_node_iter_t* node) {
+    return dt_iter_mmio_base(node, &clock_base);
+}
+
+static const char* const clock_compatible[] = {"brcm,bcm2835-system-timer", NULL};
+
+/// @brief BCM2835 system timer driver.
+const struct dt_driver_t clock_driver = {"clock", clock_compatible, clock_probe};
+
 /**
  * @brief Get the current system clock in microseconds.
  *
  * @return u64_t Microseconds since power on.
  */
 u64_t clock_micros(void) {
-    u64_t time =
-        (u64_t)read_mmion(CLOCK_SYS_TIMER_LOW) | ((u64_t)read_mmion(CLOCK_SYS_TIMER_HIGH) << 32);
+    u64_t time = (u64_t)read_mmion(clock_base + CLOCK_SYS_TIMER_LOW) |
+                 ((u64_t)read_mmion(clock_base + CLOCK_SYS_TIMER_HIGH) << 32);
     __read_barrier();
     return time;
 }
\ No newline at end of file
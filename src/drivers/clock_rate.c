@@ -0,0 +1,222 @@
+/**
+ * @file clock_rate.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Rates of the clocks that the VideoCore firmware controls.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "drivers/clock_rate.h"
+#include "common/common.h"
+#include "common/types.h"
+#include "drivers/clock.h"
+#include "drivers/mbox.h"
+#include "drivers/uart.h"
+
+/// @brief Iterations of `spin_delay` between reads of the system timer while calibrating.
+#define CLOCK_RATE_CALIBRATION_LOOPS 1024
+
+/// @brief Length of the calibration window in microseconds, 2^CLOCK_RATE_CALIBRATION_SHIFT.
+#define CLOCK_RATE_CALIBRATION_SHIFT 12
+
+/// @brief The rates of every clock, as last read from or set through the mailbox.
+static struct ClockRates clock_rates[CLOCK_ID_COUNT];
+
+/**
+ * @brief Add the current, minimum and maximum rate requests of a clock to a message.
+ *
+ * @param message The message.
+ * @param clock The clock.
+ * @param tags Set to the handles of the current, minimum and maximum rate tags.
+ */
+static void clock_rate_add_queries(struct MailboxMessage* message, enum ClockId clock,
+                                   mailbox_tag_t tags[3]) {
+    tags[0] = mailbox_message_add_clock_rate(message, MBOX_GET_CLOCK_RATE, clock);
+    tags[1] = mailbox_message_add_clock_rate(message, MBOX_GET_MIN_CLOCK_RATE, clock);
+    tags[2] = mailbox_message_add_clock_rate(message, MBOX_GET_MAX_CLOCK_RATE, clock);
+}
+
+/**
+ * @brief Decode the responses to `clock_rate_add_queries`.
+ *
+ * @param message The sent message.
+ * @param tags The handles of the tags.
+ * @param rates Set to the rates.
+ * @return enum ClockRateReturn Return value.
+ */
+static enum ClockRateReturn clock_rate_read_queries(const struct MailboxMessage* message,
+                                                    const mailbox_tag_t tags[3],
+                                                    struct ClockRates* rates) {
+    u32_t value[3][2];
+
+    for (u32_t i = 0; i < 3; i++) {
+        if (mailbox_message_result(message, tags[i], value[i], sizeof(value[i])) != MBOX_GOOD) {
+            return CLOCK_RATE_MAILBOX_ERROR;
+        }
+    }
+
+    rates->current = value[0][1];
+    rates->min     = value[1][1];
+    rates->max     = value[2][1];
+    return CLOCK_RATE_GOOD;
+}
+
+/**
+ * @brief Measure how many iterations of `spin_delay` take a microsecond, against the system timer.
+ *
+ * Counts whole batches of iterations within a fixed window, so it needs no division.
+ *
+ * @return u32_t Iterations per microsecond.
+ */
+static u32_t clock_rate_measure_delay(void) {
+    u32_t batches = 0;
+    u64_t start   = clock_micros();
+
+    while (clock_micros() - start < (1 << CLOCK_RATE_CALIBRATION_SHIFT)) {
+        spin_delay(CLOCK_RATE_CALIBRATION_LOOPS);
+        batches++;
+    }
+
+    return (batches * CLOCK_RATE_CALIBRATION_LOOPS) >> CLOCK_RATE_CALIBRATION_SHIFT;
+}
+
+/**
+ * @brief Whether changing a clock may change the UART reference clock.
+ */
+static bool clock_rate_moves_uart(enum ClockId clock) {
+    return clock == CLOCK_ID_ARM || clock == CLOCK_ID_CORE || clock == CLOCK_ID_UART;
+}
+
+/**
+ * @brief Bring everything that depends on a clock rate in line with the current rates.
+ *
+ * The UART must have been flushed before the rates changed, see `uart_set_clock`.
+ */
+static void clock_rate_update_dependents(void) {
+    uart_set_clock(clock_rates[CLOCK_ID_UART].current);
+    spin_delay_calibrate(clock_rate_measure_delay());
+}
+
+/**
+ * @brief Read the rates of every clock in one mailbox message, raise the ARM clock to its maximum
+ * unless built with CLOCK_RATE_KEEP_ARM, then recompute the UART divisor and the delay
+ * calibration from the real rates.
+ *
+ * @return enum ClockRateReturn Return value.
+ */
+enum ClockRateReturn clock_rate_init(void) {
+    struct MailboxMessage message;
+    mailbox_tag_t tags[CLOCK_ID_COUNT][3];
+    enum ClockRateReturn status;
+
+    mailbox_message_init(&message);
+    for (u32_t clock = CLOCK_ID_EMMC; clock < CLOCK_ID_COUNT; clock++) {
+        clock_rate_add_queries(&message, clock, tags[clock]);
+    }
+
+    if (mailbox_message_send(&message) != MBOX_GOOD) {
+        return CLOCK_RATE_MAILBOX_ERROR;
+    }
+    for (u32_t clock = CLOCK_ID_EMMC; clock < CLOCK_ID_COUNT; clock++) {
+        if ((status = clock_rate_read_queries(&message, tags[clock], &clock_rates[clock])) !=
+            CLOCK_RATE_GOOD) {
+            return status;
+        }
+    }
+
+#ifndef CLOCK_RATE_KEEP_ARM
+    if (clock_rates[CLOCK_ID_ARM].current < clock_rates[CLOCK_ID_ARM].max) {
+        // Also updates the dependents.
+        return clock_rate_set(CLOCK_ID_ARM, clock_rates[CLOCK_ID_ARM].max);
+    }
+#endif
+
+    // The divisor is rewritten with the UART disabled, so nothing may be left in flight.
+    uart_flush();
+    clock_rate_update_dependents();
+    return CLOCK_RATE_GOOD;
+}
+
+/**
+ * @brief Read the current, minimum and maximum rates of a clock from the firmware.
+ *
+ * @param clock The clock.
+ * @param rates Set to the rates.
+ * @return enum ClockRateReturn Return value.
+ */
+enum ClockRateReturn clock_rate_query(enum ClockId clock, struct ClockRates* rates) {
+    struct MailboxMessage message;
+    mailbox_tag_t tags[3];
+    enum ClockRateReturn status;
+
+    if (clock < CLOCK_ID_EMMC || clock >= CLOCK_ID_COUNT) {
+        return CLOCK_RATE_BAD_CLOCK;
+    }
+
+    mailbox_message_init(&message);
+    clock_rate_add_queries(&message, clock, tags);
+    if (mailbox_message_send(&message) != MBOX_GOOD) {
+        return CLOCK_RATE_MAILBOX_ERROR;
+    }
+    if ((status = clock_rate_read_queries(&message, tags, rates)) != CLOCK_RATE_GOOD) {
+        return status;
+    }
+
+    clock_rates[clock] = *rates;
+    return CLOCK_RATE_GOOD;
+}
+
+/**
+ * @brief Change the rate of a clock.
+ *
+ * The firmware clamps the rate to what the clock supports. Changing the ARM, core or UART clock
+ * may change the UART reference clock and always changes how long a spin takes, so the UART is
+ * flushed first, and the rates are read back in the same message and the dependents updated.
+ *
+ * @param clock The clock.
+ * @param rate The rate in Hz.
+ * @return enum ClockRateReturn Return value.
+ */
+enum ClockRateReturn clock_rate_set(enum ClockId clock, u32_t rate) {
+    struct MailboxMessage message;
+    u32_t value[2][2];
+
+    if (clock < CLOCK_ID_EMMC || clock >= CLOCK_ID_COUNT) {
+        return CLOCK_RATE_BAD_CLOCK;
+    }
+
+    if (clock_rate_moves_uart(clock)) {
+        // Everything queued must leave at the bit rate it was queued for.
+        uart_flush();
+    }
+
+    mailbox_message_init(&message);
+    mailbox_tag_t set  = mailbox_message_add_set_clock_rate(&message, clock, rate);
+    mailbox_tag_t uart = mailbox_message_add_clock_rate(&message, MBOX_GET_CLOCK_RATE,
+                                                        CLOCK_ID_UART);
+
+    if (mailbox_message_send(&message) != MBOX_GOOD ||
+        mailbox_message_result(&message, set, value[0], sizeof(value[0])) != MBOX_GOOD ||
+        mailbox_message_result(&message, uart, value[1], sizeof(value[1])) != MBOX_GOOD) {
+        return CLOCK_RATE_MAILBOX_ERROR;
+    }
+
+    clock_rates[clock].current         = value[0][1];
+    clock_rates[CLOCK_ID_UART].current = value[1][1];
+    clock_rate_update_dependents();
+    return CLOCK_RATE_GOOD;
+}
+
+/**
+ * @brief The rate of a clock as last read or set, without a mailbox round trip.
+ *
+ * @param clock The clock.
+ * @return u32_t The rate in Hz, 0 if it has not been read yet.
+ */
+u32_t clock_rate_current(enum ClockId clock) {
+    if (clock < CLOCK_ID_EMMC || clock >= CLOCK_ID_COUNT) {
+        return 0;
+    }
+    return clock_rates[clock].current;
+}
@@ -0,0 +1,252 @@
+/**
+ * @file dma.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief BCM2835 DMA controller driver.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "drivers/dma.h"
+#include "common/cache.h"
+#include "common/common.h"
+#include "common/mmio.h"
+#include "common/types.h"
+#include "drivers/dt.h"
+#include "drivers/irq.h"
+
+/**
+ * @brief Default physical base address of the DMA controller, used until the device tree has been
+ * probed.
+ */
+#define DMA_DEFAULT_BASE 0x20007000
+
+/// @brief Distance between the registers of two channels.
+#define DMA_CHANNEL_STRIDE 0x100
+
+/**
+ * @brief Register offsets of a channel, from the base of the channel.
+ */
+enum DmaRegisterOffset {
+    DMA_CS        = 0x00, // Control and status.
+    DMA_CONBLK_AD = 0x04, // Bus address of the current control block.
+    DMA_TI        = 0x08,
+    DMA_SOURCE_AD = 0x0c,
+    DMA_DEST_AD   = 0x10,
+    DMA_TXFR_LEN  = 0x14,
+    DMA_STRIDE    = 0x18,
+    DMA_NEXTCONBK = 0x1c,
+    DMA_DEBUG     = 0x20,
+};
+
+/// @brief Offset of the global enable register, one bit per channel, from the DMA base address.
+#define DMA_ENABLE 0xff0
+
+/**
+ * @brief Control and status register bits.
+ */
+enum DmaStatusBits {
+    DMA_CS_ACTIVE          = 1 << 0,
+    DMA_CS_END             = 1 << 1, // Write 1 to clear.
+    DMA_CS_INT             = 1 << 2, // Write 1 to clear.
+    DMA_CS_ERROR           = 1 << 8,
+    DMA_CS_WAIT_FOR_WRITES = 1 << 28,
+    DMA_CS_RESET           = 1u << 31,
+};
+
+/// @brief AXI priority of the transfers, and the priority they get while the VideoCore panics.
+#define DMA_CS_PRIORITY(p)       ((u32_t)(p) << 16)
+#define DMA_CS_PANIC_PRIORITY(p) ((u32_t)(p) << 20)
+
+/// @brief Debug register error bits, write 1 to clear.
+#define DMA_DEBUG_ERRORS 0x7
+
+/**
+ * @brief State of a channel.
+ */
+struct dma_channel_t {
+    dma_callback_t callback;
+    void* context;
+    bool busy;
+};
+
+/// @brief Physical base address of the DMA registers.
+static ptr_t dma_base = DMA_DEFAULT_BASE;
+
+/// @brief Every channel.
+static struct dma_channel_t dma_channels[DMA_CHANNELS];
+
+/// @brief Channels the ARM may use, and those already taken by `dma_channel_claim`.
+static u32_t dma_channel_mask = DMA_DEFAULT_CHANNEL_MASK;
+static u32_t dma_claimed;
+
+/**
+ * @brief Device tree probe, records the DMA controller base address and the channels the firmware
+ * leaves to the ARM.
+ *
+ * @param node The DMA controller node.
+ * @return enum dt_return_value_t Return value.
+ */
+static enum dt_return_value_t dma_probe(const struct dt_node_iter_t* node) {
+    struct dt_prop_iter_t prop;
+    u32_t mask;
+
+    if (dt_iter_get_prop(node, "brcm,dma-channel-mask", &prop) == DT_GOOD &&
+        dt_prop_read_u32(&prop, 0, &mask) == DT_GOOD) {
+        dma_channel_mask = mask & ((1u << DMA_CHANNELS) - 1);
+    }
+    return dt_iter_mmio_base(node, &dma_base);
+}
+
+static const char* const dma_compatible[] = {"brcm,bcm2835-dma", NULL};
+
+/// @brief BCM2835 DMA controller driver.
+const struct dt_driver_t dma_driver = {"dma", dma_compatible, dma_probe};
+
+/// @brief Physical address of a register of a channel.
+static inline u32_t dma_register(u32_t channel, enum DmaRegisterOffset offset) {
+    return dma_base + channel * DMA_CHANNEL_STRIDE + offset;
+}
+
+/**
+ * @brief Finish the transfer on a channel if the engine has stopped.
+ *
+ * Must be called with IRQs masked.
+ */
+static void dma_complete(u32_t channel) {
+    struct dma_channel_t* state = &dma_channels[channel];
+
+    __read_barrier();
+    u32_t status = read_mmion(dma_register(channel, DMA_CS));
+    if (!state->busy || !(status & (DMA_CS_END | DMA_CS_ERROR))) {
+        return;
+    }
+
+    __write_barrier();
+    write_mmion(dma_register(channel, DMA_CS), DMA_CS_END | DMA_CS_INT);
+    if (status & DMA_CS_ERROR) {
+        write_mmion(dma_register(channel, DMA_DEBUG), DMA_DEBUG_ERRORS);
+    }
+
+    state->busy = false;
+    if (state->callback) {
+        state->callback(channel, status & DMA_CS_ERROR ? DMA_ERROR : DMA_GOOD, state->context);
+    }
+}
+
+/**
+ * @brief DMA interrupt handler, one per channel.
+ */
+static void dma_irq(void* context) {
+    dma_complete((u32_t)(uintptr_t)context);
+}
+
+/**
+ * @brief Take the lowest channel that the device tree leaves to the ARM and nobody has claimed.
+ *
+ * @param channel Set to the channel.
+ * @return enum DmaReturn DMA_NO_CHANNEL if every usable channel is taken.
+ */
+enum DmaReturn dma_channel_claim(u32_t* channel) {
+    u32_t flags = irq_save();
+    u32_t free  = dma_channel_mask & ~dma_claimed;
+    if (free == 0) {
+        irq_restore(flags);
+        return DMA_NO_CHANNEL;
+    }
+
+    *channel     = (u32_t)__builtin_ctz(free);
+    dma_claimed |= 1u << *channel;
+    irq_restore(flags);
+    return DMA_GOOD;
+}
+
+/**
+ * @brief Reset a channel and route its interrupt.
+ *
+ * Requires the interrupt controller to have been probed.
+ *
+ * @param channel The channel.
+ * @return enum DmaReturn Return value.
+ */
+enum DmaReturn dma_channel_init(u32_t channel) {
+    if (channel >= DMA_CHANNELS) {
+        return DMA_BAD_CHANNEL;
+    }
+
+    u32_t irq = IRQ_DMA_0 + channel;
+    if (irq_register(irq, dma_irq, (void*)(uintptr_t)channel) != IRQ_GOOD) {
+        return DMA_NO_IRQ;
+    }
+
+    __write_barrier();
+    write_mmion(dma_base + DMA_ENABLE, read_mmion(dma_base + DMA_ENABLE) | (1 << channel));
+    write_mmion(dma_register(channel, DMA_CS), DMA_CS_RESET);
+    write_mmion(dma_register(channel, DMA_CS), DMA_CS_END | DMA_CS_INT);
+    write_mmion(dma_register(channel, DMA_DEBUG), DMA_DEBUG_ERRORS);
+
+    dma_channels[channel].busy = false;
+    if (irq_enable(irq) != IRQ_GOOD) {
+        return DMA_NO_IRQ;
+    }
+    return DMA_GOOD;
+}
+
+/**
+ * @brief Start a chain of control blocks on a channel.
+ *
+ * Only the control blocks with DMA_TI_INTEN raise an interrupt, so the last one in the chain must
+ * have it for the callback to run.
+ *
+ * @param channel The channel, set up with `dma_channel_init`.
+ * @param controlBlock Bus address of the first control block.
+ * @param callback Called from the DMA interrupt once the chain is done, may be NULL.
+ * @param context Passed to the callback.
+ * @return enum DmaReturn DMA_BUSY if the channel is still running a transfer.
+ */
+enum DmaReturn dma_start(u32_t channel, u32_t controlBlock, dma_callback_t callback,
+                         void* context) {
+    if (channel >= DMA_CHANNELS) {
+        return DMA_BAD_CHANNEL;
+    }
+
+    struct dma_channel_t* state = &dma_channels[channel];
+    u32_t flags                 = irq_save();
+    if (state->busy) {
+        irq_restore(flags);
+        return DMA_BUSY;
+    }
+
+    state->busy     = true;
+    state->callback = callback;
+    state->context  = context;
+
+    // The control blocks and the data must reach memory before the engine reads them.
+    __data_sync_barrier();
+    write_mmion(dma_register(channel, DMA_CONBLK_AD), controlBlock);
+    write_mmion(dma_register(channel, DMA_CS), DMA_CS_ACTIVE | DMA_CS_WAIT_FOR_WRITES |
+                                                   DMA_CS_PRIORITY(8) | DMA_CS_PANIC_PRIORITY(15));
+    irq_restore(flags);
+    return DMA_GOOD;
+}
+
+/**
+ * @brief Whether a channel is still running a transfer.
+ */
+bool dma_busy(u32_t channel) {
+    return channel < DMA_CHANNELS && dma_channels[channel].busy;
+}
+
+/**
+ * @brief Finish the transfer on a channel if the engine has stopped, for callers that wait with
+ * IRQs masked.
+ */
+void dma_poll(u32_t channel) {
+    if (channel >= DMA_CHANNELS) {
+        return;
+    }
+
+    u32_t flags = irq_save();
+    dma_complete(channel);
+    irq_restore(flags);
+}
@@ -0,0 +1,33 @@
+/**
+ * @file drivers.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Registry of device tree probed drivers.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "drivers/drivers.h"
+#include "drivers/clock.h"
+#include "drivers/dma.h"
+#include "drivers/dt.h"
+#include "drivers/gpio.h"
+#include "drivers/irq.h"
+#include "drivers/mbox.h"
+#include "drivers/uart.h"
+
+/// @brief Every driver that is bound from the device tree.
+static const struct dt_driver_t* const drivers[] = {
+    &irq_driver,
+    &gpio_driver,
+    &uart_driver,
+    &mbox_driver,
+    &clock_driver,
+    &dma_driver,
+};
+
+#define DRIVER_COUNT (sizeof(drivers) / sizeof(drivers[0]))
+
+enum dt_return_value_t drivers_probe(void) {
+    return dt_probe_drivers(drivers, DRIVER_COUNT);
+}
@@ -13,7 +13,9 @@
 #include "common/defines.h"
 #include "common/string.h"
 #include "common/types.h"
+#include "drivers/dt_tables.h"
 #include "drivers/uart.h"
+#include "kernel/arena.h"
 
 /* ----- Tokens ----- */
 /* Each token is 32 bit aligned, which means padding the previous token with 0x0. */
@@ -154,29 +156,102 @@ struct dt_prop_t {
     u8_t data[];   // Property data.
 } MEMORY_STRUCT;
 
+/**
+ * @brief Smallest number of slots in any of the hash tables.
+ */
+#define DT_MIN_TABLE_SIZE 16
+
+/**
+ * @brief Allocate `count` entries of `type` from the boot arena.
+ */
+#define DT_ALLOC(type, count) ((type*)arena_alloc((count) * sizeof(type), _Alignof(type)))
+
+/**
+ * @brief Number of slots in the compatible string table used while probing drivers.
+ *
+ * Must be a power of two, and at least twice the number of compatible strings registered.
+ */
+#define DT_COMPAT_TABLE_SIZE 64
+
+/**
+ * @brief Default number of address and size cells for a bus without `#address-cells` or
+ * `#size-cells`, as given by the devicetree specification.
+ */
+#define DT_DEFAULT_ADDRESS_CELLS 2
+#define DT_DEFAULT_SIZE_CELLS    1
+
+/**
+ * @brief Sentinel node index used for a missing parent, child or sibling.
+ */
+#define DT_NO_NODE 0xffff
+
+/**
+ * @brief Sentinel property index for a property that a node does not have.
+ */
+#define DT_NO_PROP 0xffffffff
+
+/**
+ * @brief FNV-1a offset basis and prime used for hashing node paths.
+ */
+#define DT_HASH_SEED  0x811c9dc5
+#define DT_HASH_PRIME 0x01000193
+
 /**
  * @brief Structure representing the entire flattened device tree.
  *
  */
 struct dt_t {
+    const void* blob;                        // The blob itself.
     struct dt_header_t header;               // Info containing header.
     struct dt_reserve_entry_t* reserved_mem; // A list of reserved memory entries.
     void* structure_block;                   // Device tree structure.
     const char* strings;                     // The strings block.
+    struct dt_node_t* nodes;                 // Node table, in depth first order.
+    u32_t node_count;                        // Number of entries in the node table.
+    struct dt_prop_entry_t* props;           // Property table, grouped by node.
+    u32_t prop_count;                        // Number of entries in the property table.
+    u16_t* path_table;                       // Open addressed table of node indices by path hash.
+    u32_t path_table_mask;                   // Number of slots in `path_table` minus one.
+    struct dt_phandle_entry_t* phandles;     // Open addressed table of nodes by phandle.
+    u32_t phandle_table_mask;                // Number of slots in `phandles` minus one.
+    struct dt_name_entry_t* names;           // Open addressed table of strings by name hash.
+    u32_t name_table_mask;                   // Number of slots in `names` minus one.
+    struct dt_reg_entry_t* regs;             // Translated `reg` entries, grouped by node.
+    u16_t* reg_first;                        // Index of the first entry of each node in `regs`.
+    u32_t reg_count;                         // Number of entries in `regs`.
+    dt_prop_name_t address_cells_name;       // Pre-resolved "#address-cells".
+    dt_prop_name_t size_cells_name;          // Pre-resolved "#size-cells".
+    dt_prop_name_t reg_name;                 // Pre-resolved "reg".
+    dt_prop_name_t ranges_name;              // Pre-resolved "ranges".
+    dt_prop_name_t compatible_name;          // Pre-resolved "compatible".
+    dt_prop_name_t status_name;              // Pre-resolved "status".
+    dt_prop_name_t interrupts_name;          // Pre-resolved "interrupts".
+    dt_prop_name_t interrupt_parent_name;    // Pre-resolved "interrupt-parent".
+    dt_prop_name_t interrupt_cells_name;     // Pre-resolved "#interrupt-cells".
 };
 
 /**
- * @brief Structure to store information about a node iterator.
+ * @brief A single slot in the compatible string table used while probing drivers.
  *
  */
-struct dt_node_iter_t {
-    const struct dt_t* device_tree; // Device tree of the node.
-    const u32_t* node_ptr;          // Pointer to the FDT_BEGIN_NODE tag of this node.
+struct dt_compat_entry_t {
+    u32_t hash;                      // FNV-1a hash of the compatible string.
+    const char* compatible;          // The compatible string, NULL for an empty slot.
+    const struct dt_driver_t* owner; // The driver that registered the compatible string.
 };
 
 // Forward decls
 
 static enum dt_return_value_t dt_parse_blob(void* fdt, struct dt_t* result);
+static enum dt_return_value_t dt_alloc_tables(struct dt_t* dt);
+static enum dt_return_value_t dt_build_index(struct dt_t* dt, u32_t maxNodes, u32_t maxProps);
+static void dt_build_path_table(struct dt_t* dt);
+static void dt_build_phandle_table(struct dt_t* dt);
+static void dt_build_name_table(struct dt_t* dt);
+static void dt_cache_cells(struct dt_t* dt);
+static void dt_resolve_names(struct dt_t* dt);
+static enum dt_return_value_t dt_build_reg_table(struct dt_t* dt);
+static dt_prop_name_t dt_lookup_name(const struct dt_t* dt, const char* name);
 
 /// @brief Global instance of the system fdt.
 struct dt_t system_dt;
@@ -184,132 +259,290 @@ struct dt_t system_dt;
 /**
  * @brief Initialise the global `dt_t` instance with a given fdt.
  *
+ * This parses the header and then unflattens the structure block into the node and property
+ * tables in a single linear pass. Every other device tree function runs against those tables.
+ *
+ * The tables are allocated from the boot arena, sized exactly for the blob by counting its nodes,
+ * properties and names first, so the arena must be initialised.
+ *
+ * When the kernel is built with `DT_PRECOMPILE=1` and `fdt` is the blob the tables were generated
+ * from, the precompiled tables are used instead and nothing is parsed.
+ *
  * @param fdt Pointer to the flattened device tree blob.
  * @return enum dt_return_value_t The return value
  */
-enum dt_return_value_t dt_init(void* fdt) { return dt_parse_blob(fdt, &system_dt); }
+enum dt_return_value_t dt_init(void* fdt) {
+#ifdef DT_PRECOMPILED
+    if (dt_init_from_tables(fdt, &dt_precompiled_tables) == DT_GOOD) {
+        return DT_GOOD;
+    }
+#endif
+
+    enum dt_return_value_t status = dt_parse_blob(fdt, &system_dt);
+    if (status != DT_GOOD) {
+        return status;
+    }
+
+    // Nothing allocated by a failed attempt is kept.
+    u32_t mark = arena_mark();
+
+    if ((status = dt_alloc_tables(&system_dt)) != DT_GOOD) {
+        arena_release(mark);
+        return status;
+    }
+
+    dt_build_name_table(&system_dt);
+    dt_resolve_names(&system_dt);
+    dt_cache_cells(&system_dt);
+    dt_build_path_table(&system_dt);
+    dt_build_phandle_table(&system_dt);
+
+    if ((status = dt_build_reg_table(&system_dt)) != DT_GOOD) {
+        arena_release(mark);
+    }
+    return status;
+}
+
+/**
+ * @brief Checksum a device tree blob, to tell whether it is the blob that a set of precompiled
+ * tables was built from.
+ *
+ * This is FNV-1a over whole words, which is a few cycles per word, far less than parsing the blob.
+ *
+ * @param fdt Pointer to the flattened device tree blob, with a valid header.
+ * @return u32_t The checksum.
+ */
+u32_t dt_blob_checksum(const void* fdt) {
+    u32_t size        = beth(((const struct dt_header_t*)fdt)->totalsize);
+    const u32_t* word = (const u32_t*)fdt;
+    u32_t hash        = DT_HASH_SEED;
+
+    for (u32_t i = 0; i < size / sizeof(u32_t); i++) {
+        hash = (hash ^ word[i]) * DT_HASH_PRIME;
+    }
 
-const char* rootName = "/";
+    const u8_t* tail = (const u8_t*)(word + size / sizeof(u32_t));
+    for (u32_t i = 0; i < size % sizeof(u32_t); i++) {
+        hash = (hash ^ tail[i]) * DT_HASH_PRIME;
+    }
 
-static bool verify_node_iter(struct dt_node_iter_t* iter) {
-    return beth(*iter->node_ptr) == FDT_BEGIN_NODE;
+    return hash;
 }
 
 /**
- * @brief Initialise given node iterator to point at the root node, '/'.
+ * @brief Get the tables built by the last `dt_init`, for `tools/dt_compile` to emit.
  *
- * @param iter The node iterator.
- * @return enum dt_return_value_t Return value.
+ * @param tables Where to write the tables. They point at the live tables of the system fdt.
  */
-enum dt_return_value_t dt_iter_init_node(struct dt_node_iter_t* iter) {
-    iter->device_tree           = &system_dt;
-    const u32_t* structureStart = (const u32_t*)system_dt.structure_block;
+void dt_get_tables(struct dt_tables_t* tables) {
+    tables->checksum           = dt_blob_checksum(system_dt.blob);
+    tables->totalsize          = system_dt.header.totalsize;
+    tables->nodes              = system_dt.nodes;
+    tables->node_count         = system_dt.node_count;
+    tables->props              = system_dt.props;
+    tables->prop_count         = system_dt.prop_count;
+    tables->path_table         = system_dt.path_table;
+    tables->path_table_mask    = system_dt.path_table_mask;
+    tables->phandles           = system_dt.phandles;
+    tables->phandle_table_mask = system_dt.phandle_table_mask;
+    tables->names              = system_dt.names;
+    tables->name_table_mask    = system_dt.name_table_mask;
+    tables->regs               = system_dt.regs;
+    tables->reg_first          = system_dt.reg_first;
+    tables->reg_count          = system_dt.reg_count;
+}
 
-    // Skip possible NOPS
-    while (beth(*structureStart) == FDT_NOP) {
-        structureStart++;
+/**
+ * @brief Initialise the global `dt_t` instance with a given fdt and tables built from it ahead of
+ * time.
+ *
+ * @param fdt Pointer to the flattened device tree blob.
+ * @param tables The tables, which are only used if they were built from exactly this blob.
+ * @return enum dt_return_value_t The return value, DT_BAD_CHECKSUM if the tables were built from a
+ * different blob.
+ */
+enum dt_return_value_t dt_init_from_tables(void* fdt, const struct dt_tables_t* tables) {
+    enum dt_return_value_t status = dt_parse_blob(fdt, &system_dt);
+    if (status != DT_GOOD) {
+        return status;
     }
 
-    if (beth(*structureStart) != FDT_BEGIN_NODE) {
-        return DT_INVALID_TOKEN;
+    if (system_dt.header.totalsize != tables->totalsize ||
+        dt_blob_checksum(fdt) != tables->checksum) {
+        return DT_BAD_CHECKSUM;
     }
 
-    iter->node_ptr = structureStart;
+    // The tables are never written after they are built, so they can live in read only memory.
+    system_dt.nodes              = (struct dt_node_t*)tables->nodes;
+    system_dt.node_count         = tables->node_count;
+    system_dt.props              = (struct dt_prop_entry_t*)tables->props;
+    system_dt.prop_count         = tables->prop_count;
+    system_dt.path_table         = (u16_t*)tables->path_table;
+    system_dt.path_table_mask    = tables->path_table_mask;
+    system_dt.phandles           = (struct dt_phandle_entry_t*)tables->phandles;
+    system_dt.phandle_table_mask = tables->phandle_table_mask;
+    system_dt.names              = (struct dt_name_entry_t*)tables->names;
+    system_dt.name_table_mask    = tables->name_table_mask;
+    system_dt.regs               = (struct dt_reg_entry_t*)tables->regs;
+    system_dt.reg_first          = (u16_t*)tables->reg_first;
+    system_dt.reg_count          = tables->reg_count;
+
+    dt_resolve_names(&system_dt);
     return DT_GOOD;
 }
 
 /**
- * @brief Advance the iterator to the next sibling of the node pointed to by the current iterator.
+ * @brief Resolve the property names that the driver itself looks up.
  *
- * @param iter The iterator to move.
- * @return enum dt_return_value_t Return value.
+ * @param dt The device tree, with a built name table.
  */
-enum dt_return_value_t dt_iter_next_sibling(struct dt_node_iter_t* iter) {
-    const u32_t* nodePtr = iter->node_ptr;
+static void dt_resolve_names(struct dt_t* dt) {
+    dt->address_cells_name    = dt_lookup_name(dt, "#address-cells");
+    dt->size_cells_name       = dt_lookup_name(dt, "#size-cells");
+    dt->reg_name              = dt_lookup_name(dt, "reg");
+    dt->ranges_name           = dt_lookup_name(dt, "ranges");
+    dt->compatible_name       = dt_lookup_name(dt, "compatible");
+    dt->status_name           = dt_lookup_name(dt, "status");
+    dt->interrupts_name       = dt_lookup_name(dt, "interrupts");
+    dt->interrupt_parent_name = dt_lookup_name(dt, "interrupt-parent");
+    dt->interrupt_cells_name  = dt_lookup_name(dt, "#interrupt-cells");
+}
 
-    if (!verify_node_iter(iter)) {
-        return DT_INVALID_ITER;
+/**
+ * @brief Get the memory occupied by the device tree blob, which must not be reused while the device
+ * tree is in use.
+ *
+ * @param base Where to write the address of the blob.
+ * @param size Where to write the size of the blob in bytes.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_blob_region(ptr_t* base, u32_t* size) {
+    if (system_dt.node_count == 0) {
+        return DT_INVALID_TOKEN;
     }
 
-    u32_t token;
-    int level = 0;
+    *base = (ptr_t)(uintptr_t)system_dt.blob;
+    *size = system_dt.header.totalsize;
+    return DT_GOOD;
+}
 
-    while ((token = *nodePtr++) != FDT_END) {
-        if (token == FDT_BEGIN_NODE) {
-            level++;
-        }
-        if (token == FDT_END_NODE) {
-            level--;
-            if (level == 0) {
-                break;
-            }
-        }
-        if (token == FDT_PROP) {
-            // Skip over the property
-            struct dt_prop_t* prop = (struct dt_prop_t*)nodePtr;
-            int bytesToSkip        = (sizeof(struct dt_prop_t) + beth(prop->len) + 3) & ~0x3;
-            nodePtr                = (const u32_t*)((u8_t*)nodePtr + bytesToSkip);
-        }
+/**
+ * @brief Read entry `index` of the memory reservation block of the blob.
+ *
+ * @param index The index of the entry.
+ * @param address Where to write the address of the reserved region.
+ * @param size Where to write the size of the reserved region.
+ * @return enum dt_return_value_t Return value, DT_NO_MORE_RESERVED after the last entry.
+ */
+enum dt_return_value_t dt_memreserve(u32_t index, u64_t* address, u64_t* size) {
+    if (system_dt.node_count == 0) {
+        return DT_INVALID_TOKEN;
     }
 
-    if (token == FDT_END) {
-        return DT_NO_MORE_SIBLINGS;
+    // The block is terminated by an entry with a zero address and size.
+    for (u32_t i = 0; i <= index; i++) {
+        if (system_dt.reserved_mem[i].address == 0 && system_dt.reserved_mem[i].size == 0) {
+            return DT_NO_MORE_RESERVED;
+        }
     }
 
-    // Skip over nop
-    while (beth(*nodePtr) == FDT_NOP) {
-        nodePtr++;
+    *address = bethl(system_dt.reserved_mem[index].address);
+    *size    = bethl(system_dt.reserved_mem[index].size);
+    return DT_GOOD;
+}
+
+static bool verify_node_iter(const struct dt_node_iter_t* iter) {
+    return iter->device_tree != NULL && iter->index < iter->device_tree->node_count;
+}
+
+/**
+ * @brief Move the iterator onto node `index`, or return `err` if there is no such node.
+ */
+static enum dt_return_value_t dt_iter_move(struct dt_node_iter_t* iter, u16_t index,
+                                           enum dt_return_value_t err) {
+    if (index == DT_NO_NODE) {
+        return err;
     }
 
-    if (beth(*nodePtr) != FDT_BEGIN_NODE) {
+    iter->index = index;
+    return DT_GOOD;
+}
+
+/**
+ * @brief Initialise given node iterator to point at the root node, '/'.
+ *
+ * @param iter The node iterator.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_iter_init_node(struct dt_node_iter_t* iter) {
+    iter->device_tree = &system_dt;
+    iter->index       = 0;
+
+    if (system_dt.node_count == 0) {
         return DT_INVALID_TOKEN;
     }
 
-    iter->node_ptr = nodePtr;
     return DT_GOOD;
 }
 
 /**
- * @brief Advance the iterator into the node, and onto the first child of the node.
+ * @brief Advance the iterator to the next sibling of the node pointed to by the current iterator.
  *
  * @param iter The iterator to move.
- * @return enum dt_return_value_t Return value. TODO (whole file)
+ * @return enum dt_return_value_t Return value.
  */
-enum dt_return_value_t dt_iter_first_child(struct dt_node_iter_t* iter) {
-    const u32_t* nodePtr = iter->node_ptr;
-
+enum dt_return_value_t dt_iter_next_sibling(struct dt_node_iter_t* iter) {
     if (!verify_node_iter(iter)) {
         return DT_INVALID_ITER;
     }
 
-    u32_t token;
+    return dt_iter_move(iter, iter->device_tree->nodes[iter->index].next_sibling,
+                        DT_NO_MORE_SIBLINGS);
+}
 
-    // Skip over possible properties
-    while ((token = *nodePtr++) != FDT_END) {
-        if (token == FDT_END_NODE) {
-            return DT_NO_CHILDREN;
-        }
+/**
+ * @brief Advance the iterator into the node, and onto the first child of the node.
+ *
+ * @param iter The iterator to move.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_iter_first_child(struct dt_node_iter_t* iter) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
+    }
 
-        if (token == FDT_PROP) {
-            // Skip over the property
-            struct dt_prop_t* prop = (struct dt_prop_t*)nodePtr;
-            int bytesToSkip        = (sizeof(struct dt_prop_t) + beth(prop->len) + 3) & ~0x3;
-            nodePtr                = (const u32_t*)((u8_t*)nodePtr + bytesToSkip);
-        }
+    return dt_iter_move(iter, iter->device_tree->nodes[iter->index].first_child, DT_NO_CHILDREN);
+}
 
-        if (token == FDT_BEGIN_NODE) {
-            nodePtr--; // Move nodePtr back onto tag
-            break;
-        }
+/**
+ * @brief Move the iterator up onto the parent of the current node.
+ *
+ * @param iter The iterator to move.
+ * @return enum dt_return_value_t Return value, DT_INVALID_PATH if the iterator is at the root.
+ */
+enum dt_return_value_t dt_iter_parent(struct dt_node_iter_t* iter) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
     }
 
-    if (token == FDT_END) {
-        return DT_NO_CHILDREN;
-    }
+    return dt_iter_move(iter, iter->device_tree->nodes[iter->index].parent, DT_INVALID_PATH);
+}
 
-    iter->node_ptr = nodePtr;
+/**
+ * @brief Get the name of the node that `iter` is pointing to.
+ *
+ * The name points directly into the structure block so it lives as long as the device tree.
+ *
+ * @param iter The node iterator.
+ * @return const char* The null terminated node name, or NULL if the iterator is invalid.
+ */
+const char* dt_iter_name(const struct dt_node_iter_t* iter) {
+    if (!verify_node_iter(iter)) {
+        return NULL;
+    }
 
-    return DT_GOOD;
+    const struct dt_t* dt = iter->device_tree;
+    return (const char*)dt->structure_block + dt->nodes[iter->index].name_off;
 }
 
 /**
@@ -326,7 +559,7 @@ enum dt_return_value_t dt_iter_namen(struct dt_node_iter_t* iter, char* out, siz
         return DT_INVALID_ITER;
     }
 
-    strncpy(out, (const char*)(++iter->node_ptr), n);
+    strncpy(out, dt_iter_name(iter), n);
 
     return DT_GOOD;
 }
@@ -341,6 +574,7 @@ enum dt_return_value_t dt_iter_namen(struct dt_node_iter_t* iter, char* out, siz
 static enum dt_return_value_t dt_parse_blob(void* fdt, struct dt_t* result) {
     // The header structure should be located at the start of the blob.
     struct dt_header_t* dtHeader = (struct dt_header_t*)fdt;
+    result->blob                 = fdt;
     result->header               = *dtHeader;
 
     // The values are stored as little endian so translate all of the values.
@@ -378,53 +612,1170 @@ static enum dt_return_value_t dt_parse_blob(void* fdt, struct dt_t* result) {
 }
 
 /**
- * @brief Get a node by path.
+ * @brief Count the nodes and properties in the structure block of `dt`, without building anything.
  *
- * @param path The null terminated node name.
  * @return enum dt_return_value_t Return value.
  */
-enum dt_return_value_t dt_get_node_by_path(const char* path, struct dt_node_iter_t* node) {
-    struct dt_node_iter_t iter;
-    enum dt_return_value_t status = dt_iter_init_node(&iter);
-    if (status != DT_GOOD) {
-        return status;
+static enum dt_return_value_t dt_count_structure(const struct dt_t* dt, u32_t* nodes,
+                                                 u32_t* props) {
+    const u8_t* structStart = (const u8_t*)dt->structure_block;
+    const u32_t* tokenPtr   = (const u32_t*)structStart;
+    const u32_t* structEnd  = (const u32_t*)(structStart + dt->header.size_dt_struct);
+
+    *nodes = 0;
+    *props = 0;
+
+    while (tokenPtr < structEnd) {
+        switch (beth(*tokenPtr++)) {
+        case FDT_NOP:
+        case FDT_END_NODE:
+            break;
+        case FDT_BEGIN_NODE: {
+            const char* namePtr = (const char*)tokenPtr;
+            while (*namePtr++)
+                ;
+            u32_t nameEnd = (u32_t)((const u8_t*)namePtr - structStart);
+            tokenPtr      = (const u32_t*)(structStart + ((nameEnd + 3) & ~0x3));
+            (*nodes)++;
+            break;
+        }
+        case FDT_PROP: {
+            u32_t len = beth(((const struct dt_prop_t*)tokenPtr)->len);
+            tokenPtr  = (const u32_t*)((const u8_t*)tokenPtr +
+                                      ((sizeof(struct dt_prop_t) + len + 3) & ~0x3));
+            (*props)++;
+            break;
+        }
+        case FDT_END:
+            return DT_GOOD;
+        default:
+            return DT_INVALID_TOKEN;
+        }
+    }
+
+    return DT_INVALID_TOKEN;
+}
+
+/**
+ * @brief Count the names in the strings block of `dt`, an upper bound on the distinct property
+ * names as dtc never stores a name twice.
+ */
+static u32_t dt_count_strings(const struct dt_t* dt) {
+    u32_t count = 0;
+    for (u32_t offset = 0; offset < dt->header.size_dt_strings; offset++) {
+        if (dt->strings[offset] == '\0') {
+            count++;
+        }
     }
+    return count;
+}
 
-    // Node name buffer (255 chars + 1 null terminator)
-    char name[256];
+/**
+ * @brief Get the number of slots for a hash table of `entries`, a power of two that keeps the
+ * table at most half full.
+ */
+static u32_t dt_table_slots(u32_t entries) {
+    u32_t slots = DT_MIN_TABLE_SIZE;
+    while (slots < entries * 2) {
+        slots <<= 1;
+    }
+    return slots;
+}
 
-    int pathInd = 0;
+/**
+ * @brief Allocate the node, property and hash tables of `dt` from the boot arena, sized exactly
+ * for its blob, and unflatten the structure block into them.
+ *
+ * @return enum dt_return_value_t Return value, DT_NO_MEMORY if the arena is full.
+ */
+static enum dt_return_value_t dt_alloc_tables(struct dt_t* dt) {
+    u32_t nodes;
+    u32_t props;
 
-    // Write name of root node into the buffer
-    status = dt_iter_namen(&iter, name, sizeof(name));
+    enum dt_return_value_t status = dt_count_structure(dt, &nodes, &props);
     if (status != DT_GOOD) {
         return status;
     }
 
-    while (pathInd < strlen(path)) {
-        // Compare the name to the path
-        if (strncmp(name, path, strlen(name)) == 0) {
-            // If the name and the path is the same, then either go to children, or return.
-            if (pathInd + strlen(name) == strlen(path)) {
-                // If the path is the same, then return the node.
-                *node = iter;
-                return DT_GOOD;
+    // Node indices are 16 bits, and DT_NO_NODE is reserved.
+    if (nodes >= DT_NO_NODE) {
+        return DT_TOO_MANY_NODES;
+    }
+
+    u32_t pathSlots = dt_table_slots(nodes);
+    u32_t nameSlots = dt_table_slots(dt_count_strings(dt));
+
+    dt->nodes              = DT_ALLOC(struct dt_node_t, nodes);
+    dt->props              = DT_ALLOC(struct dt_prop_entry_t, props);
+    dt->path_table         = DT_ALLOC(u16_t, pathSlots);
+    dt->path_table_mask    = pathSlots - 1;
+    dt->phandles           = DT_ALLOC(struct dt_phandle_entry_t, pathSlots);
+    dt->phandle_table_mask = pathSlots - 1;
+    dt->names              = DT_ALLOC(struct dt_name_entry_t, nameSlots);
+    dt->name_table_mask    = nameSlots - 1;
+    dt->reg_first          = DT_ALLOC(u16_t, nodes + 1);
+
+    if (!dt->nodes || !dt->props || !dt->path_table || !dt->phandles || !dt->names ||
+        !dt->reg_first) {
+        return DT_NO_MEMORY;
+    }
+
+    return dt_build_index(dt, nodes, props);
+}
+
+/**
+ * @brief Unflatten the structure block of `dt` into its node and property tables.
+ *
+ * This is the only place that walks the raw token stream. Nodes are appended in depth first order,
+ * and each node is linked to its previous sibling when it is opened. The most recently closed node
+ * is always the previous sibling of the next node opened under the same parent, so no stack is
+ * needed.
+ *
+ * @param dt The device tree, with a parsed header and allocated tables.
+ * @param maxNodes The number of entries in the node table.
+ * @param maxProps The number of entries in the property table.
+ * @return enum dt_return_value_t Return value.
+ */
+static enum dt_return_value_t dt_build_index(struct dt_t* dt, u32_t maxNodes, u32_t maxProps) {
+    const u8_t* structStart = (const u8_t*)dt->structure_block;
+    const u32_t* tokenPtr   = (const u32_t*)structStart;
+    const u32_t* structEnd  = (const u32_t*)(structStart + dt->header.size_dt_struct);
+
+    u16_t current    = DT_NO_NODE;
+    u16_t lastClosed = DT_NO_NODE;
+
+    dt->node_count = 0;
+    dt->prop_count = 0;
+
+    while (tokenPtr < structEnd) {
+        u32_t token = beth(*tokenPtr++);
+
+        switch (token) {
+        case FDT_NOP:
+            break;
+        case FDT_BEGIN_NODE: {
+            if (dt->node_count >= maxNodes) {
+                return DT_TOO_MANY_NODES;
             }
-            return DT_GOOD;
+
+            // Only the root may be opened outside of another node.
+            if (current == DT_NO_NODE && dt->node_count != 0) {
+                return DT_INVALID_TOKEN;
+            }
+
+            u16_t index            = (u16_t)dt->node_count++;
+            struct dt_node_t* node = &dt->nodes[index];
+            node->name_off         = (u32_t)((const u8_t*)tokenPtr - structStart);
+            node->first_prop       = dt->prop_count;
+            node->prop_count       = 0;
+            node->parent           = current;
+            node->first_child      = DT_NO_NODE;
+            node->next_sibling     = DT_NO_NODE;
+
+            if (lastClosed != DT_NO_NODE && dt->nodes[lastClosed].parent == current) {
+                dt->nodes[lastClosed].next_sibling = index;
+            } else if (current != DT_NO_NODE) {
+                dt->nodes[current].first_child = index;
+            }
+
+            // Skip over the name and move to the next 4 byte boundary.
+            const char* namePtr = (const char*)tokenPtr;
+            while (*namePtr++)
+                ;
+            u32_t nameEnd = (u32_t)((const u8_t*)namePtr - structStart);
+            tokenPtr      = (const u32_t*)(structStart + ((nameEnd + 3) & ~0x3));
+            current       = index;
+            lastClosed    = DT_NO_NODE;
+            break;
         }
+        case FDT_END_NODE:
+            if (current == DT_NO_NODE) {
+                return DT_INVALID_TOKEN;
+            }
+            lastClosed = current;
+            current    = dt->nodes[current].parent;
+            break;
+        case FDT_PROP: {
+            // Properties must precede all subnodes, so that each node owns a contiguous run of the
+            // property table.
+            if (current == DT_NO_NODE || dt->nodes[current].first_child != DT_NO_NODE) {
+                return DT_INVALID_TOKEN;
+            }
+            if (dt->prop_count >= maxProps) {
+                return DT_TOO_MANY_NODES;
+            }
 
-        // Move to the next sibling
-        status = dt_iter_next_sibling(&iter);
-        if (status != DT_GOOD) {
-            return status;
+            const struct dt_prop_t* prop  = (const struct dt_prop_t*)tokenPtr;
+            struct dt_prop_entry_t* entry = &dt->props[dt->prop_count++];
+            entry->nameoff                = beth(prop->nameoff);
+            entry->len                    = beth(prop->len);
+            entry->data_off               = (u32_t)(prop->data - structStart);
+            dt->nodes[current].prop_count++;
+
+            tokenPtr = (const u32_t*)((const u8_t*)tokenPtr +
+                                      ((sizeof(struct dt_prop_t) + entry->len + 3) & ~0x3));
+            break;
+        }
+        case FDT_END:
+            return current == DT_NO_NODE && dt->node_count != 0 ? DT_GOOD : DT_INVALID_TOKEN;
+        default:
+            return DT_INVALID_TOKEN;
         }
     }
 
-    return DT_PATH_NOT_FOUND;
+    // Ran off the end of the structure block without an FDT_END.
+    return DT_INVALID_TOKEN;
+}
+
+/**
+ * @brief Continue an FNV-1a hash over `len` bytes of `str`.
+ */
+static u32_t dt_hash_bytes(u32_t hash, const char* str, size_t len) {
+    while (len-- > 0) {
+        hash = (hash ^ (u8_t)*str++) * DT_HASH_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash the absolute path of every node and insert it into the path table.
+ *
+ * Parents always precede their children in the node table, so each path hash is the parent's
+ * hash extended by "/name" and the whole table is built in one forward pass.
+ *
+ * @param dt The device tree, with a built node table.
+ */
+static void dt_build_path_table(struct dt_t* dt) {
+    for (u32_t slot = 0; slot <= dt->path_table_mask; slot++) {
+        dt->path_table[slot] = DT_NO_NODE;
+    }
+
+    for (u32_t index = 0; index < dt->node_count; index++) {
+        struct dt_node_t* node = &dt->nodes[index];
+        const char* name       = (const char*)dt->structure_block + node->name_off;
+
+        if (node->parent == DT_NO_NODE) {
+            node->path_hash = dt_hash_bytes(DT_HASH_SEED, "/", 1);
+        } else {
+            u32_t hash = dt->nodes[node->parent].path_hash;
+            // Children of the root share its separator.
+            if (dt->nodes[node->parent].parent != DT_NO_NODE) {
+                hash = dt_hash_bytes(hash, "/", 1);
+            }
+            node->path_hash = dt_hash_bytes(hash, name, strlen(name));
+        }
+
+        u32_t slot = node->path_hash & dt->path_table_mask;
+        while (dt->path_table[slot] != DT_NO_NODE) {
+            slot = (slot + 1) & dt->path_table_mask;
+        }
+        dt->path_table[slot] = (u16_t)index;
+    }
+}
+
+/**
+ * @brief Intern every name in the strings block, keyed by the hash of the name.
+ *
+ * dtc deduplicates the strings block, so every property with a given name shares one `nameoff`.
+ * Interning maps a name to that offset, after which properties are matched by integer compares.
+ *
+ * @param dt The device tree, with a parsed header.
+ */
+static void dt_build_name_table(struct dt_t* dt) {
+    for (u32_t slot = 0; slot <= dt->name_table_mask; slot++) {
+        dt->names[slot].nameoff = DT_PROP_NAME_INVALID;
+    }
+
+    u32_t offset   = 0;
+    u32_t interned = 0;
+
+    // Keep the table at most half full, any names left over are found by the slow path.
+    while (offset < dt->header.size_dt_strings && interned <= dt->name_table_mask / 2) {
+        const char* name = dt->strings + offset;
+        size_t len       = strlen(name);
+        u32_t hash       = dt_hash_bytes(DT_HASH_SEED, name, len);
+
+        u32_t slot = hash & dt->name_table_mask;
+        while (dt->names[slot].nameoff != DT_PROP_NAME_INVALID) {
+            slot = (slot + 1) & dt->name_table_mask;
+        }
+        dt->names[slot].hash    = hash;
+        dt->names[slot].nameoff = offset;
+
+        interned++;
+        offset += len + 1;
+    }
 }
 
+/**
+ * @brief Find the strings block offset that properties called `name` use.
+ *
+ * @return dt_prop_name_t The handle, DT_PROP_NAME_INVALID if the strings block has no such name.
+ */
+static dt_prop_name_t dt_lookup_name(const struct dt_t* dt, const char* name) {
+    size_t len = strlen(name);
+    u32_t hash = dt_hash_bytes(DT_HASH_SEED, name, len);
+    u32_t slot = hash & dt->name_table_mask;
+
+    while (dt->names[slot].nameoff != DT_PROP_NAME_INVALID) {
+        if (dt->names[slot].hash == hash &&
+            strncmp(dt->strings + dt->names[slot].nameoff, name, len + 1) == 0) {
+            return dt->names[slot].nameoff;
+        }
+        slot = (slot + 1) & dt->name_table_mask;
+    }
+
+    // dtc also merges names that are the tail of another, e.g. "phandle" in "linux,phandle", and
+    // those never start a string. Fall back to a scan, which is fine as handles are resolved once.
+    u32_t offset = 0;
+    while (offset < dt->header.size_dt_strings) {
+        const char* string = dt->strings + offset;
+        size_t stringLen   = strlen(string);
 
+        if (stringLen >= len && strncmp(string + stringLen - len, name, len + 1) == 0) {
+            return offset + (u32_t)(stringLen - len);
+        }
 
+        offset += stringLen + 1;
+    }
+
+    return DT_PROP_NAME_INVALID;
+}
+
+/**
+ * @brief Collect the `phandle` (or legacy `linux,phandle`) of every node into the phandle table.
+ *
+ * dtc numbers phandles sequentially from 1, so the low bits of the phandle are used directly as the
+ * slot and probe sequences are almost always of length one.
+ *
+ * @param dt The device tree, with a built node, property and name table.
+ */
+static void dt_build_phandle_table(struct dt_t* dt) {
+    for (u32_t slot = 0; slot <= dt->phandle_table_mask; slot++) {
+        dt->phandles[slot].node = DT_NO_NODE;
+    }
+
+    dt_prop_name_t phandleName      = dt_lookup_name(dt, "phandle");
+    dt_prop_name_t linuxPhandleName = dt_lookup_name(dt, "linux,phandle");
+
+    for (u32_t index = 0; index < dt->node_count; index++) {
+        const struct dt_node_t* node = &dt->nodes[index];
+
+        for (u32_t p = node->first_prop; p < node->first_prop + node->prop_count; p++) {
+            const struct dt_prop_entry_t* prop = &dt->props[p];
+
+            if (prop->len != sizeof(u32_t) ||
+                (prop->nameoff != phandleName && prop->nameoff != linuxPhandleName)) {
+                continue;
+            }
+
+            const u8_t* data = (const u8_t*)dt->structure_block + prop->data_off;
+            u32_t phandle    = beth(*(const u32_t*)data);
+            if (phandle == 0 || phandle == 0xffffffff) {
+                continue;
+            }
+
+            // Nodes may carry both properties with the same value, only insert them once.
+            u32_t slot = phandle & dt->phandle_table_mask;
+            while (dt->phandles[slot].node != DT_NO_NODE && dt->phandles[slot].phandle != phandle) {
+                slot = (slot + 1) & dt->phandle_table_mask;
+            }
+            dt->phandles[slot].phandle = phandle;
+            dt->phandles[slot].node    = (u16_t)index;
+        }
+    }
+}
+
+/**
+ * @brief Check that the absolute path of node `index` is exactly the first `len` bytes of `path`.
+ *
+ * Components are compared from the leaf upwards, following parent links, so a hash collision can
+ * never resolve to the wrong node.
+ */
+static bool dt_node_matches_path(const struct dt_t* dt, u16_t index, const char* path, size_t len) {
+    while (dt->nodes[index].parent != DT_NO_NODE) {
+        const char* name = (const char*)dt->structure_block + dt->nodes[index].name_off;
+        size_t nameLen   = strlen(name);
+
+        if (nameLen + 1 > len || path[len - nameLen - 1] != '/' ||
+            strncmp(path + len - nameLen, name, nameLen) != 0) {
+            return false;
+        }
+
+        len -= nameLen + 1;
+        index = dt->nodes[index].parent;
+    }
+
+    return len == 0;
+}
+
+/**
+ * @brief Get a node by its absolute path, e.g. "/soc/gpio@7e200000".
+ *
+ * The path is hashed once and looked up in the path table built by `dt_init`, so resolving a path
+ * does not walk the tree. A single trailing '/' is ignored.
+ *
+ * @param path The null terminated absolute path of the node.
+ * @param node The iterator to point at the node if it is found.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_get_node_by_path(const char* path, struct dt_node_iter_t* node) {
+    const struct dt_t* dt = &system_dt;
+
+    if (path == NULL || path[0] != '/') {
+        return DT_INVALID_PATH;
+    }
+
+    if (dt->node_count == 0) {
+        return DT_INVALID_TOKEN;
+    }
+
+    size_t len = strlen(path);
+    if (len > 1 && path[len - 1] == '/') {
+        len--;
+    }
+
+    if (len == 1) {
+        node->device_tree = dt;
+        node->index       = 0;
+        return DT_GOOD;
+    }
+
+    u32_t hash = dt_hash_bytes(DT_HASH_SEED, path, len);
+    u32_t slot = hash & dt->path_table_mask;
+    u16_t index;
+
+    while ((index = dt->path_table[slot]) != DT_NO_NODE) {
+        if (dt->nodes[index].path_hash == hash && dt_node_matches_path(dt, index, path, len)) {
+            node->device_tree = dt;
+            node->index       = index;
+            return DT_GOOD;
+        }
+        slot = (slot + 1) & dt->path_table_mask;
+    }
+
+    return DT_PATH_NOT_FOUND;
+}
+
+/**
+ * @brief Get the node referenced by a phandle, e.g. the value of an `interrupt-parent` property.
+ *
+ * @param phandle The phandle to resolve.
+ * @param node The iterator to point at the node if it is found.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_resolve_phandle(u32_t phandle, struct dt_node_iter_t* node) {
+    const struct dt_t* dt = &system_dt;
+
+    if (dt->node_count == 0) {
+        return DT_INVALID_TOKEN;
+    }
+
+    u32_t slot = phandle & dt->phandle_table_mask;
+    while (dt->phandles[slot].node != DT_NO_NODE) {
+        if (dt->phandles[slot].phandle == phandle) {
+            node->device_tree = dt;
+            node->index       = dt->phandles[slot].node;
+            return DT_GOOD;
+        }
+        slot = (slot + 1) & dt->phandle_table_mask;
+    }
+
+    return DT_PHANDLE_NOT_FOUND;
+}
+
+/**
+ * @brief Find a property of node `index` by pre-resolved name.
+ *
+ * @return u32_t The index of the property in the property table, DT_NO_PROP if there is none.
+ */
+static u32_t dt_node_find_prop(const struct dt_t* dt, u32_t index, dt_prop_name_t name) {
+    const struct dt_node_t* node = &dt->nodes[index];
+    u32_t end                    = node->first_prop + node->prop_count;
+
+    for (u32_t prop = node->first_prop; prop < end; prop++) {
+        if (dt->props[prop].nameoff == name) {
+            return prop;
+        }
+    }
+
+    return DT_NO_PROP;
+}
+
+/**
+ * @brief Get a pointer to the value of property `prop` in the structure block.
+ */
+static const u32_t* dt_prop_cells(const struct dt_t* dt, u32_t prop) {
+    return (const u32_t*)((const u8_t*)dt->structure_block + dt->props[prop].data_off);
+}
+
+/**
+ * @brief Read a single cell property of node `index`, or return `fallback` if it has none.
+ */
+static u32_t dt_node_read_u32(const struct dt_t* dt, u32_t index, dt_prop_name_t name,
+                              u32_t fallback) {
+    u32_t prop = dt_node_find_prop(dt, index, name);
+    if (prop == DT_NO_PROP || dt->props[prop].len < sizeof(u32_t)) {
+        return fallback;
+    }
+
+    return beth(*dt_prop_cells(dt, prop));
+}
+
+/**
+ * @brief Cache the `#address-cells` and `#size-cells` of every node in the node table, so decoding
+ * `reg` and `ranges` never has to search for them.
+ */
+static void dt_cache_cells(struct dt_t* dt) {
+    for (u32_t index = 0; index < dt->node_count; index++) {
+        u32_t addressCells =
+            dt_node_read_u32(dt, index, dt->address_cells_name, DT_DEFAULT_ADDRESS_CELLS);
+        u32_t sizeCells = dt_node_read_u32(dt, index, dt->size_cells_name, DT_DEFAULT_SIZE_CELLS);
+
+        // Anything wider than 4 cells is malformed, and would overflow the cached fields.
+        dt->nodes[index].address_cells = addressCells > 4 ? 4 : (u8_t)addressCells;
+        dt->nodes[index].size_cells    = sizeCells > 4 ? 4 : (u8_t)sizeCells;
+    }
+}
+
+/**
+ * @brief Read a big endian value of `cells` cells. Values wider than 64 bits keep the low bits.
+ *
+ * Almost every bus uses one or two cells, which are decoded without looping.
+ */
+static inline u64_t dt_read_cells(const u32_t* data, u32_t cells) {
+    switch (cells) {
+    case 0:
+        return 0;
+    case 1:
+        return beth(data[0]);
+    case 2:
+        return ((u64_t)beth(data[0]) << 32) | beth(data[1]);
+    default: {
+        u64_t value = 0;
+        while (cells-- > 0) {
+            value = (value << 32) | beth(*data++);
+        }
+        return value;
+    }
+    }
+}
+
+/**
+ * @brief Translate a bus address of a child of node `bus` into the address space of its parent.
+ *
+ * @return enum dt_return_value_t Return value, DT_NO_TRANSLATION if the address is not mapped.
+ */
+static enum dt_return_value_t dt_translate_one(const struct dt_t* dt, u32_t bus, u64_t* address) {
+    u32_t prop = dt_node_find_prop(dt, bus, dt->ranges_name);
+    if (prop == DT_NO_PROP) {
+        return DT_NO_TRANSLATION;
+    }
+
+    // An empty ranges property maps the child address space straight through.
+    if (dt->props[prop].len == 0) {
+        return DT_GOOD;
+    }
+
+    u32_t parent = dt->nodes[bus].parent;
+    if (parent == DT_NO_NODE) {
+        return DT_NO_TRANSLATION;
+    }
+
+    u32_t childCells  = dt->nodes[bus].address_cells;
+    u32_t sizeCells   = dt->nodes[bus].size_cells;
+    u32_t parentCells = dt->nodes[parent].address_cells;
+    u32_t entryCells  = childCells + parentCells + sizeCells;
+    u32_t entries     = dt->props[prop].len / (entryCells * sizeof(u32_t));
+    const u32_t* data = dt_prop_cells(dt, prop);
+
+    for (u32_t entry = 0; entry < entries; entry++, data += entryCells) {
+        u64_t childBase = dt_read_cells(data, childCells);
+        u64_t size      = dt_read_cells(data + childCells + parentCells, sizeCells);
+
+        if (*address >= childBase && *address - childBase < size) {
+            *address = *address - childBase + dt_read_cells(data + childCells, parentCells);
+            return DT_GOOD;
+        }
+    }
+
+    return DT_NO_TRANSLATION;
+}
+
+/**
+ * @brief Resolve a property name, such as "reg" or "#address-cells", to a reusable handle.
+ *
+ * Handles stay valid for as long as the device tree does, so drivers should resolve the names they
+ * use once and keep the handles, rather than resolving them on every lookup.
+ *
+ * @param name The null terminated property name.
+ * @param handle Where to write the handle. DT_PROP_NAME_INVALID is written if no property uses the
+ * name, which is still safe to pass to `dt_iter_find_prop`.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_prop_name_resolve(const char* name, dt_prop_name_t* handle) {
+    *handle = DT_PROP_NAME_INVALID;
+
+    if (system_dt.node_count == 0) {
+        return DT_INVALID_TOKEN;
+    }
+
+    *handle = dt_lookup_name(&system_dt, name);
+    return *handle == DT_PROP_NAME_INVALID ? DT_PROP_NOT_FOUND : DT_GOOD;
+}
+
+/**
+ * @brief Find the property of a node with a pre-resolved name.
+ *
+ * @param iter The node to search.
+ * @param name The property name handle, from `dt_prop_name_resolve`.
+ * @param prop The property iterator to point at the property if it is found.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_iter_find_prop(const struct dt_node_iter_t* iter, dt_prop_name_t name,
+                                         struct dt_prop_iter_t* prop) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
+    }
+
+    const struct dt_t* dt        = iter->device_tree;
+    const struct dt_node_t* node = &dt->nodes[iter->index];
+    u32_t index                  = dt_node_find_prop(dt, iter->index, name);
+
+    if (index == DT_NO_PROP) {
+        return DT_PROP_NOT_FOUND;
+    }
+
+    prop->device_tree = dt;
+    prop->index       = index;
+    prop->end         = node->first_prop + node->prop_count;
+    return DT_GOOD;
+}
+
+/**
+ * @brief Find the property of a node by name.
+ *
+ * This resolves the name on every call, prefer `dt_iter_find_prop` for repeated lookups.
+ *
+ * @param iter The node to search.
+ * @param name The null terminated property name.
+ * @param prop The property iterator to point at the property if it is found.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_iter_get_prop(const struct dt_node_iter_t* iter, const char* name,
+                                        struct dt_prop_iter_t* prop) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
+    }
+
+    return dt_iter_find_prop(iter, dt_lookup_name(iter->device_tree, name), prop);
+}
+
+/**
+ * @brief Point a property iterator at the first property of a node.
+ *
+ * @param iter The node whose properties to iterate.
+ * @param prop The property iterator.
+ * @return enum dt_return_value_t Return value, DT_NO_MORE_PROPS if the node has no properties.
+ */
+enum dt_return_value_t dt_iter_first_prop(const struct dt_node_iter_t* iter,
+                                          struct dt_prop_iter_t* prop) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
+    }
+
+    const struct dt_node_t* node = &iter->device_tree->nodes[iter->index];
+    if (node->prop_count == 0) {
+        return DT_NO_MORE_PROPS;
+    }
+
+    prop->device_tree = iter->device_tree;
+    prop->index       = node->first_prop;
+    prop->end         = node->first_prop + node->prop_count;
+    return DT_GOOD;
+}
+
+/**
+ * @brief Advance a property iterator to the next property of the same node.
+ *
+ * @param prop The property iterator.
+ * @return enum dt_return_value_t Return value, DT_NO_MORE_PROPS after the last property.
+ */
+enum dt_return_value_t dt_prop_next(struct dt_prop_iter_t* prop) {
+    if (prop->index + 1 >= prop->end) {
+        return DT_NO_MORE_PROPS;
+    }
+
+    prop->index++;
+    return DT_GOOD;
+}
+
+/**
+ * @brief Get the name of a property.
+ *
+ * @param prop The property iterator.
+ * @return const char* The null terminated name, pointing into the strings block.
+ */
+const char* dt_prop_name(const struct dt_prop_iter_t* prop) {
+    return prop->device_tree->strings + prop->device_tree->props[prop->index].nameoff;
+}
+
+/**
+ * @brief Get the raw value of a property. Multi byte values are stored big endian.
+ *
+ * @param prop The property iterator.
+ * @return const void* Pointer to the value, in the structure block.
+ */
+const void* dt_prop_data(const struct dt_prop_iter_t* prop) {
+    return (const u8_t*)prop->device_tree->structure_block +
+           prop->device_tree->props[prop->index].data_off;
+}
+
+/**
+ * @brief Get the length of the value of a property in bytes.
+ *
+ * @param prop The property iterator.
+ * @return u32_t The length, 0 for an empty property.
+ */
+u32_t dt_prop_len(const struct dt_prop_iter_t* prop) {
+    return prop->device_tree->props[prop->index].len;
+}
+
+/**
+ * @brief Read cell `index` of a property value, translated to host endian.
+ *
+ * @param prop The property iterator.
+ * @param index The index of the 32 bit cell to read.
+ * @param out Where to write the value.
+ * @return enum dt_return_value_t Return value, DT_PROP_TOO_SHORT if the property has no such cell.
+ */
+enum dt_return_value_t dt_prop_read_u32(const struct dt_prop_iter_t* prop, u32_t index,
+                                        u32_t* out) {
+    if ((index + 1) * sizeof(u32_t) > dt_prop_len(prop)) {
+        return DT_PROP_TOO_SHORT;
+    }
+
+    *out = beth(((const u32_t*)dt_prop_data(prop))[index]);
+    return DT_GOOD;
+}
+
+/**
+ * @brief Decode entry `index` of the `reg` property of node `index`, and translate it through the
+ * `ranges` of every bus up to the root.
+ */
+static enum dt_return_value_t dt_node_reg_address(const struct dt_t* dt, u32_t node, u32_t index,
+                                                  u64_t* address, u64_t* size) {
+    u32_t bus  = dt->nodes[node].parent;
+    u32_t prop = dt_node_find_prop(dt, node, dt->reg_name);
+
+    if (prop == DT_NO_PROP) {
+        return DT_PROP_NOT_FOUND;
+    }
+    if (bus == DT_NO_NODE) {
+        return DT_NO_TRANSLATION;
+    }
+
+    u32_t addressCells = dt->nodes[bus].address_cells;
+    u32_t sizeCells    = dt->nodes[bus].size_cells;
+    u32_t entryCells   = addressCells + sizeCells;
+
+    if (entryCells == 0 || (index + 1) * entryCells * sizeof(u32_t) > dt->props[prop].len) {
+        return DT_PROP_TOO_SHORT;
+    }
+
+    const u32_t* data = dt_prop_cells(dt, prop) + index * entryCells;
+    u64_t translated  = dt_read_cells(data, addressCells);
+
+    *size = dt_read_cells(data + addressCells, sizeCells);
+
+    // Walk up through every bus, the root address space is the CPU physical address space.
+    while (dt->nodes[bus].parent != DT_NO_NODE) {
+        enum dt_return_value_t status = dt_translate_one(dt, bus, &translated);
+        if (status != DT_GOOD) {
+            return status;
+        }
+        bus = dt->nodes[bus].parent;
+    }
+
+    *address = translated;
+    return DT_GOOD;
+}
+
+/**
+ * @brief Get the number of entries in the `reg` property of a node.
+ */
+static u32_t dt_node_reg_entries(const struct dt_t* dt, u32_t node) {
+    u32_t prop = dt_node_find_prop(dt, node, dt->reg_name);
+    u32_t bus  = dt->nodes[node].parent;
+
+    if (prop == DT_NO_PROP || bus == DT_NO_NODE) {
+        return 0;
+    }
+
+    u32_t entryCells = dt->nodes[bus].address_cells + dt->nodes[bus].size_cells;
+    return entryCells == 0 ? 0 : dt->props[prop].len / (entryCells * sizeof(u32_t));
+}
+
+/**
+ * @brief Translate every `reg` entry of every node up front, so drivers look their registers up
+ * rather than walking `ranges` while probing.
+ *
+ * @param dt The device tree, with built node, property and name tables and cached cell counts.
+ * @return enum dt_return_value_t Return value, DT_TOO_MANY_REGS if there are too many entries to
+ * index.
+ */
+static enum dt_return_value_t dt_build_reg_table(struct dt_t* dt) {
+    u32_t total = 0;
+
+    for (u32_t node = 0; node < dt->node_count; node++) {
+        total += dt_node_reg_entries(dt, node);
+    }
+
+    // Entries are indexed by the 16 bit `reg_first`.
+    if (total > 0xffff) {
+        return DT_TOO_MANY_REGS;
+    }
+    if (!(dt->regs = DT_ALLOC(struct dt_reg_entry_t, total))) {
+        return DT_NO_MEMORY;
+    }
+
+    dt->reg_count = 0;
+    for (u32_t node = 0; node < dt->node_count; node++) {
+        dt->reg_first[node] = (u16_t)dt->reg_count;
+        u32_t entries       = dt_node_reg_entries(dt, node);
+
+        for (u32_t index = 0; index < entries; index++) {
+            struct dt_reg_entry_t* entry = &dt->regs[dt->reg_count++];
+            entry->address               = 0;
+            entry->status = dt_node_reg_address(dt, node, index, &entry->address, &entry->size);
+        }
+    }
+
+    dt->reg_first[dt->node_count] = (u16_t)dt->reg_count;
+    return DT_GOOD;
+}
+
+/**
+ * @brief Read entry `index` of the `reg` property of a node, translated to a CPU physical address.
+ *
+ * The entry is decoded with the `#address-cells` and `#size-cells` of the parent, and the address
+ * is translated through the `ranges` of every bus up to the root. For example the BCM2835 UART at
+ * bus address 0x7e201000 translates to 0x20201000. Every entry is translated by `dt_init`, so this
+ * is a table lookup.
+ *
+ * @param iter The node.
+ * @param index The index of the entry in the `reg` property.
+ * @param address Where to write the translated address.
+ * @param size Where to write the size of the region, may be NULL.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_iter_reg_address(const struct dt_node_iter_t* iter, u32_t index,
+                                           u64_t* address, u64_t* size) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
+    }
+
+    const struct dt_t* dt = iter->device_tree;
+    u32_t first           = dt->reg_first[iter->index];
+
+    if (index >= (u32_t)(dt->reg_first[iter->index + 1] - first)) {
+        // Not in the table, decode it again only to find out why.
+        u64_t ignored;
+        return dt_node_reg_address(dt, iter->index, index, &ignored, &ignored);
+    }
+
+    const struct dt_reg_entry_t* entry = &dt->regs[first + index];
+    if (entry->status != DT_GOOD) {
+        return entry->status;
+    }
+
+    *address = entry->address;
+    if (size != NULL) {
+        *size = entry->size;
+    }
+    return DT_GOOD;
+}
+
+/**
+ * @brief Get the CPU physical base address of the first `reg` entry of a node, for drivers that
+ * map a single block of registers.
+ *
+ * @param iter The node.
+ * @param base Where to write the base address.
+ * @return enum dt_return_value_t Return value, DT_NO_TRANSLATION if the address does not fit in a
+ * pointer.
+ */
+enum dt_return_value_t dt_iter_mmio_base(const struct dt_node_iter_t* iter, ptr_t* base) {
+    u64_t address;
+    enum dt_return_value_t status = dt_iter_reg_address(iter, 0, &address, NULL);
+    if (status != DT_GOOD) {
+        return status;
+    }
+
+    if (address > (ptr_t)~0) {
+        return DT_NO_TRANSLATION;
+    }
+
+    *base = (ptr_t)address;
+    return DT_GOOD;
+}
+
+/**
+ * @brief Decode the `reg` property of a node into native address and size pairs, using the
+ * `#address-cells` and `#size-cells` of its parent. Addresses are left in the parent bus address
+ * space, use `dt_iter_reg_address` for translated addresses.
+ *
+ * @param iter The node.
+ * @param out Where to write the decoded entries.
+ * @param max The number of entries that fit in `out`.
+ * @param count Where to write the number of entries in the property, which may be more than `max`.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_iter_decode_reg(const struct dt_node_iter_t* iter, struct dt_reg_t* out,
+                                          u32_t max, u32_t* count) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
+    }
+
+    const struct dt_t* dt = iter->device_tree;
+    u32_t bus             = dt->nodes[iter->index].parent;
+    u32_t prop            = dt_node_find_prop(dt, iter->index, dt->reg_name);
+
+    if (prop == DT_NO_PROP) {
+        return DT_PROP_NOT_FOUND;
+    }
+    if (bus == DT_NO_NODE) {
+        return DT_NO_TRANSLATION;
+    }
+
+    u32_t addressCells = dt->nodes[bus].address_cells;
+    u32_t sizeCells    = dt->nodes[bus].size_cells;
+    u32_t entryCells   = addressCells + sizeCells;
+    const u32_t* data  = dt_prop_cells(dt, prop);
+
+    if (entryCells == 0) {
+        return DT_PROP_TOO_SHORT;
+    }
+
+    *count = dt->props[prop].len / (entryCells * sizeof(u32_t));
+    for (u32_t entry = 0; entry < *count && entry < max; entry++, data += entryCells) {
+        out[entry].address = dt_read_cells(data, addressCells);
+        out[entry].size    = dt_read_cells(data + addressCells, sizeCells);
+    }
+
+    return DT_GOOD;
+}
+
+/**
+ * @brief Decode the `ranges` property of a bus node into native child, parent and size triples.
+ *
+ * @param iter The bus node.
+ * @param out Where to write the decoded entries.
+ * @param max The number of entries that fit in `out`.
+ * @param count Where to write the number of entries in the property, which may be more than `max`.
+ * Zero for an empty `ranges`, which maps the child address space straight through.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_iter_decode_ranges(const struct dt_node_iter_t* iter,
+                                             struct dt_range_t* out, u32_t max, u32_t* count) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
+    }
+
+    const struct dt_t* dt = iter->device_tree;
+    u32_t parent          = dt->nodes[iter->index].parent;
+    u32_t prop            = dt_node_find_prop(dt, iter->index, dt->ranges_name);
+
+    if (prop == DT_NO_PROP) {
+        return DT_PROP_NOT_FOUND;
+    }
+    if (parent == DT_NO_NODE) {
+        return DT_NO_TRANSLATION;
+    }
+
+    u32_t childCells  = dt->nodes[iter->index].address_cells;
+    u32_t sizeCells   = dt->nodes[iter->index].size_cells;
+    u32_t parentCells = dt->nodes[parent].address_cells;
+    u32_t entryCells  = childCells + parentCells + sizeCells;
+    const u32_t* data = dt_prop_cells(dt, prop);
+
+    if (entryCells == 0) {
+        return DT_PROP_TOO_SHORT;
+    }
+
+    *count = dt->props[prop].len / (entryCells * sizeof(u32_t));
+    for (u32_t entry = 0; entry < *count && entry < max; entry++, data += entryCells) {
+        out[entry].child  = dt_read_cells(data, childCells);
+        out[entry].parent = dt_read_cells(data + childCells, parentCells);
+        out[entry].size   = dt_read_cells(data + childCells + parentCells, sizeCells);
+    }
+
+    return DT_GOOD;
+}
+
+/**
+ * @brief Decode the `interrupts` property of a node into native cells.
+ *
+ * The number of cells in each interrupt specifier is the `#interrupt-cells` of the interrupt
+ * parent, which is found through the nearest `interrupt-parent` of the node or its ancestors, or
+ * is the parent node if there is none.
+ *
+ * @param iter The node.
+ * @param out Where to write the decoded cells, specifiers are stored one after another.
+ * @param max The number of cells that fit in `out`.
+ * @param cells Where to write the number of cells in each specifier.
+ * @param count Where to write the number of specifiers in the property. Only the specifiers that
+ * fit entirely in `out` are written.
+ * @return enum dt_return_value_t Return value.
+ */
+enum dt_return_value_t dt_iter_decode_interrupts(const struct dt_node_iter_t* iter, u32_t* out,
+                                                 u32_t max, u32_t* cells, u32_t* count) {
+    if (!verify_node_iter(iter)) {
+        return DT_INVALID_ITER;
+    }
+
+    const struct dt_t* dt = iter->device_tree;
+    u32_t prop            = dt_node_find_prop(dt, iter->index, dt->interrupts_name);
+
+    if (prop == DT_NO_PROP) {
+        return DT_PROP_NOT_FOUND;
+    }
+
+    // Find the interrupt controller that the interrupts are routed to.
+    struct dt_node_iter_t controller = {dt, dt->nodes[iter->index].parent};
+    for (u32_t index = iter->index; index != DT_NO_NODE; index = dt->nodes[index].parent) {
+        u32_t parent = dt_node_find_prop(dt, index, dt->interrupt_parent_name);
+        if (parent != DT_NO_PROP && dt->props[parent].len >= sizeof(u32_t)) {
+            enum dt_return_value_t status =
+                dt_resolve_phandle(beth(*dt_prop_cells(dt, parent)), &controller);
+            if (status != DT_GOOD) {
+                return status;
+            }
+            break;
+        }
+    }
+
+    if (controller.index == DT_NO_NODE) {
+        return DT_NO_TRANSLATION;
+    }
+
+    *cells = dt_node_read_u32(dt, controller.index, dt->interrupt_cells_name, 1);
+    if (*cells == 0) {
+        return DT_PROP_TOO_SHORT;
+    }
+
+    const u32_t* data = dt_prop_cells(dt, prop);
+    u32_t total       = dt->props[prop].len / sizeof(u32_t);
+    u32_t limit       = max - max % *cells;
+
+    *count = total / *cells;
+    for (u32_t cell = 0; cell < total && cell < limit; cell++) {
+        out[cell] = beth(data[cell]);
+    }
+
+    return DT_GOOD;
+}
+
+/**
+ * @brief Check whether node `index` is enabled, i.e. it has no `status` or it is "okay".
+ */
+static bool dt_node_enabled(const struct dt_t* dt, u32_t index) {
+    u32_t prop = dt_node_find_prop(dt, index, dt->status_name);
+    if (prop == DT_NO_PROP) {
+        return true;
+    }
+
+    const char* status = (const char*)dt_prop_cells(dt, prop);
+    return strncmp(status, "okay", 5) == 0 || strncmp(status, "ok", 3) == 0;
+}
+
+/**
+ * @brief Probe every registered driver against the device tree in one pass.
+ *
+ * The compatible strings of all drivers are first hashed into a table. Then every enabled node is
+ * visited once, and each entry of its `compatible` list, most specific first, is looked up in the
+ * table. The first match has its probe function called with the node. This way the cost grows with
+ * the size of the device tree, not with the size of the device tree times the number of drivers.
+ *
+ * @param drivers The drivers to probe.
+ * @param count The number of drivers.
+ * @return enum dt_return_value_t Return value, DT_TOO_MANY_COMPATIBLES if the drivers list more
+ * compatible strings than the table holds, otherwise the last error returned by a probe function
+ * if any failed. A failing probe does not stop the remaining nodes from being probed.
+ */
+enum dt_return_value_t dt_probe_drivers(const struct dt_driver_t* const* drivers, size_t count) {
+    const struct dt_t* dt = &system_dt;
+    struct dt_compat_entry_t table[DT_COMPAT_TABLE_SIZE];
+    u32_t registered = 0;
+
+    if (dt->node_count == 0) {
+        return DT_INVALID_TOKEN;
+    }
+
+    for (u32_t slot = 0; slot < DT_COMPAT_TABLE_SIZE; slot++) {
+        table[slot].compatible = NULL;
+    }
+
+    for (size_t driver = 0; driver < count; driver++) {
+        for (const char* const* compat = drivers[driver]->compatible; *compat != NULL; compat++) {
+            if (registered >= DT_COMPAT_TABLE_SIZE / 2) {
+                return DT_TOO_MANY_COMPATIBLES;
+            }
+
+            u32_t hash = dt_hash_bytes(DT_HASH_SEED, *compat, strlen(*compat));
+            u32_t slot = hash & (DT_COMPAT_TABLE_SIZE - 1);
+            while (table[slot].compatible != NULL) {
+                slot = (slot + 1) & (DT_COMPAT_TABLE_SIZE - 1);
+            }
+
+            table[slot].hash       = hash;
+            table[slot].compatible = *compat;
+            table[slot].owner      = drivers[driver];
+            registered++;
+        }
+    }
+
+    enum dt_return_value_t result = DT_GOOD;
+
+    for (u32_t index = 0; index < dt->node_count; index++) {
+        u32_t prop = dt_node_find_prop(dt, index, dt->compatible_name);
+        if (prop == DT_NO_PROP || !dt_node_enabled(dt, index)) {
+            continue;
+        }
+
+        // The compatible property is a list of null terminated strings.
+        const char* compat              = (const char*)dt_prop_cells(dt, prop);
+        const char* end                 = compat + dt->props[prop].len;
+        const struct dt_driver_t* match = NULL;
+
+        while (compat < end && match == NULL) {
+            size_t len = strlen(compat);
+            u32_t hash = dt_hash_bytes(DT_HASH_SEED, compat, len);
+            u32_t slot = hash & (DT_COMPAT_TABLE_SIZE - 1);
+
+            while (table[slot].compatible != NULL) {
+                if (table[slot].hash == hash &&
+                    strncmp(table[slot].compatible, compat, len + 1) == 0) {
+                    match = table[slot].owner;
+                    break;
+                }
+                slot = (slot + 1) & (DT_COMPAT_TABLE_SIZE - 1);
+            }
+
+            compat += len + 1;
+        }
+
+        if (match != NULL) {
+            struct dt_node_iter_t node    = {dt, index};
+            enum dt_return_value_t status = match->probe(&node);
+            if (status != DT_GOOD) {
+                result = status;
+            }
+        }
+    }
+
+    return result;
+}
 
 #define print_tabs(n)                                                                              \
     if (true) {                                                                                    \
@@ -492,7 +1843,8 @@ static enum dt_return_value_t dt_print_node(struct dt_t* fdt, const u32_t* nodeP
                 ;
 
             // Move ptr to 4 byte boundary
-            nodePtr = (const u32_t*)(((ptr_t)namePtr + 3) & ~0x3);
+            nodePtr = (const u32_t*)((const u8_t*)nodePtr +
+                                     ((namePtr - (const char*)nodePtr + 3) & ~0x3));
             level += TAB_INDENT;
             break;
         case FDT_END_NODE:
@@ -0,0 +1,111 @@
+/**
+ * @file firmware.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Board and firmware properties reported by the VideoCore.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "drivers/firmware.h"
+#include "common/types.h"
+#include "drivers/mbox.h"
+
+/**
+ * @brief Every property, as the VideoCore reported it.
+ */
+struct firmware_info_t {
+    u32_t revision;
+    u32_t boardModel;
+    u32_t boardRevision;
+    u8_t mac[FIRMWARE_MAC_LENGTH];
+    u64_t serial;
+    struct FirmwareMemory arm;
+    struct FirmwareMemory vc;
+};
+
+/// @brief The properties, zero until `firmware_init`.
+static struct firmware_info_t firmware_info;
+
+/**
+ * @brief Fetch every property from the VideoCore, in one mailbox round trip.
+ *
+ * @return enum FirmwareReturn FIRMWARE_MAILBOX_ERROR if any property could not be read, in which
+ * case none are kept.
+ */
+enum FirmwareReturn firmware_init(void) {
+    struct MailboxMessage message;
+    struct firmware_info_t info;
+    u32_t serial[2];
+
+    mailbox_message_init(&message);
+    mailbox_tag_t revision      = mailbox_message_add_property(&message, MBOX_GET_FIRMWARE_MODEL);
+    mailbox_tag_t boardModel    = mailbox_message_add_property(&message, MBOX_GET_BOARD_MODEL);
+    mailbox_tag_t boardRevision = mailbox_message_add_property(&message, MBOX_GET_BOARD_REVISION);
+    mailbox_tag_t mac           = mailbox_message_add_property(&message, MBOX_GET_BOARD_MAC_ADDR);
+    mailbox_tag_t boardSerial   = mailbox_message_add_property(&message, MBOX_GET_BOARD_SERIAL);
+    mailbox_tag_t arm           = mailbox_message_add_property(&message, MBOX_GET_ARM_MEMORY);
+    mailbox_tag_t vc            = mailbox_message_add_property(&message, MBOX_GET_VC_MEMORY);
+
+    if (mailbox_message_send(&message) != MBOX_GOOD ||
+        mailbox_message_result(&message, revision, &info.revision, sizeof(u32_t)) != MBOX_GOOD ||
+        mailbox_message_result(&message, boardModel, &info.boardModel, sizeof(u32_t)) !=
+            MBOX_GOOD ||
+        mailbox_message_result(&message, boardRevision, &info.boardRevision, sizeof(u32_t)) !=
+            MBOX_GOOD ||
+        mailbox_message_result(&message, mac, info.mac, FIRMWARE_MAC_LENGTH) != MBOX_GOOD ||
+        mailbox_message_result(&message, boardSerial, serial, sizeof(serial)) != MBOX_GOOD ||
+        mailbox_message_result(&message, arm, &info.arm, sizeof(info.arm)) != MBOX_GOOD ||
+        mailbox_message_result(&message, vc, &info.vc, sizeof(info.vc)) != MBOX_GOOD) {
+        return FIRMWARE_MAILBOX_ERROR;
+    }
+
+    info.serial   = (u64_t)serial[0] | ((u64_t)serial[1] << 32);
+    firmware_info = info;
+    return FIRMWARE_GOOD;
+}
+
+/// @brief Firmware revision.
+u32_t firmware_revision(void) {
+    return firmware_info.revision;
+}
+
+/// @brief Board model.
+u32_t firmware_board_model(void) {
+    return firmware_info.boardModel;
+}
+
+/// @brief Board revision, decoded.
+struct MailboxBoardRevision firmware_board_revision(void) {
+    union {
+        u32_t code;
+        struct MailboxBoardRevision decoded;
+    } revision = {firmware_info.boardRevision};
+
+    return revision.decoded;
+}
+
+/// @brief Board revision, as the raw revision code.
+u32_t firmware_board_revision_code(void) {
+    return firmware_info.boardRevision;
+}
+
+/// @brief Board serial number.
+u64_t firmware_board_serial(void) {
+    return firmware_info.serial;
+}
+
+/// @brief MAC address of the board, FIRMWARE_MAC_LENGTH bytes in network order.
+const u8_t* firmware_mac_address(void) {
+    return firmware_info.mac;
+}
+
+/// @brief Memory given to the ARM.
+struct FirmwareMemory firmware_arm_memory(void) {
+    return firmware_info.arm;
+}
+
+/// @brief Memory kept by the VideoCore.
+struct FirmwareMemory firmware_vc_memory(void) {
+    return firmware_info.vc;
+}
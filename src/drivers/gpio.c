@@ -1 +1,72 @@
+/**
+ * @file gpio.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Low level gpio driver implementation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
 #include "drivers/gpio.h"
+#include "common/common.h"
+#include "common/mmio.h"
+#include "common/types.h"
+#include "drivers/dt.h"
+
+/**
+ * @brief Default physical base address of the GPIO registers, used until the device tree has been
+ * probed.
+ */
+#define GPIO_DEFAULT_BASE 0x20200000
+
+/// @brief Physical base address of the GPIO registers.
+static ptr_t gpio_base = GPIO_DEFAULT_BASE;
+
+/**
+ * @brief Device tree probe, records the GPIO base address.
+ *
+ * @param node The GPIO controller node.
+ * @return enum dt_return_value_t Return value.
+ */
+static enum dt_return_value_t gpio_probe(const struct dt_node_iter_t* node) {
+    return dt_iter_mmio_base(node, &gpio_base);
+}
+
+static const char* const gpio_compatible[] = {"brcm,bcm2835-gpio", NULL};
+
+/// @brief BCM2835 GPIO controller driver.
+const struct dt_driver_t gpio_driver = {"gpio", gpio_compatible, gpio_probe};
+
+void gpio_pin_mode(int pin, enum pinMode_t mode) {
+    // Each function select register holds 3 bits for each of 10 pins.
+    u32_t reg   = gpio_base + GPIO_GPFSEL0 + (u32_t)(pin / 10) * 4;
+    u32_t shift = (u32_t)(pin % 10) * 3;
+
+    __write_barrier();
+    u32_t value = read_mmion(reg) & ~(0x7 << shift);
+    write_mmion(reg, value | ((mode == GPIO_OUTPUT ? 0x1 : 0x0) << shift));
+}
+
+void gpio_set_pin(int pin, enum pinLevel_t level) {
+    u32_t reg = gpio_base + (level == GPIO_HIGH ? GPIO_GPSET0 : GPIO_GPCLR0) + (pin >> 5) * 4;
+
+    __write_barrier();
+    write_mmion(reg, 1 << (pin & 31));
+}
+
+void gpio_pin_pull(int pin, enum pinPull_t pull) {
+    u32_t clock = gpio_base + GPIO_GPPUDCLK0 + (pin >> 5) * 4;
+
+    // Set the control signal & wait 150 clock cycles for it to setup.
+    __write_barrier();
+    write_mmion(gpio_base + GPIO_GPPUD, pull);
+    spin_delay(150);
+
+    // Propagate the control signal to the pin.
+    write_mmion(clock, 1 << (pin & 31));
+    spin_delay(150);
+
+    // Clear control and clock signal.
+    write_mmion(gpio_base + GPIO_GPPUD, 0x0);
+    write_mmion(clock, 0x0);
+}
@@ -0,0 +1,174 @@
+/**
+ * @file irq.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief BCM2835 interrupt controller driver.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "drivers/irq.h"
+#include "common/common.h"
+#include "common/mmio.h"
+#include "common/types.h"
+#include "drivers/dt.h"
+#include "kernel/trace.h"
+
+/**
+ * @brief Default physical base address of the interrupt controller, used until the device tree has
+ * been probed.
+ */
+#define IRQ_DEFAULT_BASE 0x2000B200
+
+/// @brief Number of banks of 32 interrupts.
+#define IRQ_BANKS 3
+
+/**
+ * @brief Register offsets for the interrupt controller, from the interrupt controller base
+ * address.
+ */
+enum IrqRegisterOffset {
+    IRQ_BASIC_PENDING = 0x00,
+    IRQ_PENDING_1     = 0x04,
+    IRQ_PENDING_2     = 0x08,
+    IRQ_FIQ_CONTROL   = 0x0c,
+    IRQ_ENABLE_1      = 0x10,
+    IRQ_ENABLE_2      = 0x14,
+    IRQ_ENABLE_BASIC  = 0x18,
+    IRQ_DISABLE_1     = 0x1c,
+    IRQ_DISABLE_2     = 0x20,
+    IRQ_DISABLE_BASIC = 0x24,
+};
+
+/// @brief The ARM basic interrupts, the bits of the basic registers below the GPU summary bits.
+#define IRQ_BASIC_MASK 0xff
+
+/// @brief Pending, enable and disable registers of each bank.
+static const u32_t irq_pending_regs[IRQ_BANKS] = {IRQ_BASIC_PENDING, IRQ_PENDING_1, IRQ_PENDING_2};
+static const u32_t irq_enable_regs[IRQ_BANKS]  = {IRQ_ENABLE_BASIC, IRQ_ENABLE_1, IRQ_ENABLE_2};
+static const u32_t irq_disable_regs[IRQ_BANKS] = {IRQ_DISABLE_BASIC, IRQ_DISABLE_1, IRQ_DISABLE_2};
+
+/// @brief Physical base address of the interrupt controller registers.
+static ptr_t irq_base = IRQ_DEFAULT_BASE;
+
+/// @brief The registered handler and its context for every interrupt.
+static irq_handler_t irq_handlers[IRQ_COUNT];
+static void* irq_contexts[IRQ_COUNT];
+
+/**
+ * @brief The enabled interrupts of each bank.
+ *
+ * Only these are looked at by `irq_dispatch`, as the basic pending register also holds summary and
+ * shortcut bits for GPU interrupts that are already covered by the other two banks.
+ */
+static u32_t irq_enabled[IRQ_BANKS];
+
+/**
+ * @brief Device tree probe, records the interrupt controller base address.
+ *
+ * @param node The interrupt controller node.
+ * @return enum dt_return_value_t Return value.
+ */
+static enum dt_return_value_t irq_probe(const struct dt_node_iter_t* node) {
+    return dt_iter_mmio_base(node, &irq_base);
+}
+
+static const char* const irq_compatible[] = {"brcm,bcm2835-armctrl-ic", NULL};
+
+/// @brief BCM2835 interrupt controller driver.
+const struct dt_driver_t irq_driver = {"irq", irq_compatible, irq_probe};
+
+/**
+ * @brief Register the handler of an interrupt. The interrupt stays disabled until `irq_enable`.
+ *
+ * @param irq The interrupt number.
+ * @param handler The handler, or NULL to remove the current one.
+ * @param context Passed to the handler.
+ * @return enum IrqReturn IRQ_IN_USE if another handler is already registered.
+ */
+enum IrqReturn irq_register(u32_t irq, irq_handler_t handler, void* context) {
+    if (irq >= IRQ_COUNT || ((irq >> 5) == 0 && (1u << irq) & ~IRQ_BASIC_MASK)) {
+        return IRQ_BAD_NUMBER;
+    }
+    if (handler && irq_handlers[irq] && irq_handlers[irq] != handler) {
+        return IRQ_IN_USE;
+    }
+
+    u32_t flags       = irq_save();
+    irq_handlers[irq] = handler;
+    irq_contexts[irq] = context;
+    irq_restore(flags);
+    return IRQ_GOOD;
+}
+
+/**
+ * @brief Unmask an interrupt at the controller.
+ *
+ * @param irq The interrupt number, which must have a handler.
+ * @return enum IrqReturn Return value.
+ */
+enum IrqReturn irq_enable(u32_t irq) {
+    if (irq >= IRQ_COUNT || !irq_handlers[irq]) {
+        return IRQ_BAD_NUMBER;
+    }
+
+    u32_t bank = irq >> 5;
+    u32_t bit  = 1u << (irq & 31);
+
+    u32_t flags = irq_save();
+    irq_enabled[bank] |= bit;
+    __write_barrier();
+    write_mmion(irq_base + irq_enable_regs[bank], bit);
+    irq_restore(flags);
+    return IRQ_GOOD;
+}
+
+/**
+ * @brief Mask an interrupt at the controller.
+ *
+ * @param irq The interrupt number.
+ * @return enum IrqReturn Return value.
+ */
+enum IrqReturn irq_disable(u32_t irq) {
+    if (irq >= IRQ_COUNT) {
+        return IRQ_BAD_NUMBER;
+    }
+
+    u32_t bank = irq >> 5;
+    u32_t bit  = 1u << (irq & 31);
+
+    u32_t flags = irq_save();
+    irq_enabled[bank] &= ~bit;
+    __write_barrier();
+    write_mmion(irq_base + irq_disable_regs[bank], bit);
+    irq_restore(flags);
+    return IRQ_GOOD;
+}
+
+/**
+ * @brief Run the handler of every pending interrupt, called from the IRQ vector.
+ */
+void irq_dispatch(void) {
+    __read_barrier();
+
+    for (u32_t bank = 0; bank < IRQ_BANKS; bank++) {
+        if (!irq_enabled[bank]) {
+            continue;
+        }
+
+        u32_t pending = read_mmion(irq_base + irq_pending_regs[bank]) & irq_enabled[bank];
+        while (pending) {
+            u32_t bit = 31 - (u32_t)__builtin_clz(pending);
+            u32_t irq = (bank << 5) + bit;
+            pending &= ~(1u << bit);
+
+            if (irq_handlers[irq]) {
+                trace_irq(TRACE_IRQ_BEGIN, irq);
+                irq_handlers[irq](irq_contexts[irq]);
+                trace_irq(TRACE_IRQ_END, irq);
+            }
+        }
+    }
+
+    __write_barrier();
+}
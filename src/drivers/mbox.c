@@ -9,13 +9,24 @@
  */
 
 #include "drivers/mbox.h"
+#include "common/cache.h"
 #include "common/common.h"
 #include "common/mmio.h"
 #include "common/types.h"
+#include "drivers/dt.h"
+#include "drivers/irq.h"
 #include "drivers/uart.h"
+#include "kernel/coherent.h"
+#include "kernel/trace.h"
 
 /**
- * @brief Physical addresses for the VideoCore mailbox.
+ * @brief Default physical base address of the VideoCore mailbox, used until the device tree has
+ * been probed.
+ */
+#define MBOX_DEFAULT_BASE 0x2000B880
+
+/**
+ * @brief Register offsets for the VideoCore mailbox, from the mailbox base address.
  *
  * The mailbox is setup in such a way that the CPU communicates to the VC through Mailbox 1 and the
  * VC to the CPU in Mailbox 0.
@@ -23,136 +34,499 @@
  * This means that the CPU should never write to Mailbox 0, and the CPU should never read from
  * Mailbox 1.
  */
-enum MailboxPhysicalAddress {
-    MBOX_BASE     = 0x2000B880,
-    MBOX_0_READ   = (MBOX_BASE + 0x00),
-    MBOX_0_POLL   = (MBOX_BASE + 0x10),
-    MBOX_0_SEND   = (MBOX_BASE + 0x14),
-    MBOX_0_STATUS = (MBOX_BASE + 0x18),
-    MBOX_0_CONFIG = (MBOX_BASE + 0x1c),
-    MBOX_1_WRITE  = (MBOX_BASE + 0x20),
-    MBOX_1_POLL   = (MBOX_BASE + 0x30),
-    MBOX_1_SEND   = (MBOX_BASE + 0x34),
-    MBOX_1_STATUS = (MBOX_BASE + 0x38),
-    MBOX_1_CONFIG = (MBOX_BASE + 0x3c)
+enum MailboxRegisterOffset {
+    MBOX_0_READ   = 0x00,
+    MBOX_0_POLL   = 0x10,
+    MBOX_0_SEND   = 0x14,
+    MBOX_0_STATUS = 0x18,
+    MBOX_0_CONFIG = 0x1c,
+    MBOX_1_WRITE  = 0x20,
+    MBOX_1_POLL   = 0x30,
+    MBOX_1_SEND   = 0x34,
+    MBOX_1_STATUS = 0x38,
+    MBOX_1_CONFIG = 0x3c
 };
 
+/// @brief Physical base address of the mailbox registers.
+static ptr_t mbox_base = MBOX_DEFAULT_BASE;
+
+/**
+ * @brief Device tree probe, records the mailbox base address.
+ *
+ * @param node The mailbox node.
+ * @return enum dt_return_value_t Return value.
+ */
+static enum dt_return_value_t mailbox_probe(const struct dt_node_iter_t* node) {
+    return dt_iter_mmio_base(node, &mbox_base);
+}
+
+static const char* const mailbox_compatible[] = {"brcm,bcm2835-mbox", NULL};
+
+/// @brief BCM2835 VideoCore mailbox driver.
+const struct dt_driver_t mbox_driver = {"mbox", mailbox_compatible, mailbox_probe};
+
 enum MailboxCodes {
     MBOX_REQUEST_CODE     = 0x00000000,
-    MBOX_REQUEST_SUCCEED  = 0x8000000,
-    MBOX_REQUEST_FAILED   = 0x8000001,
+    MBOX_REQUEST_SUCCEED  = 0x80000000,
+    MBOX_REQUEST_FAILED   = 0x80000001,
+    MBOX_TAG_RESPONSE     = 0x80000000,
     MBOX_TAG_REQUEST_CODE = 0x00000000,
     MBOX_END_TAG          = 0x00000000
 };
 
 enum MailboxStatus { MBOX_EMPTY = (0x1 << 30), MBOX_FULL = (0x1 << 31) };
 
-#define MAX_MBOX_BUFFER 16
+/// @brief Words in the message header, the buffer size and the request code.
+#define MBOX_HEADER_WORDS 2
 
-static u32_t mailbox_read(enum MailboxChannels channel) {
-    // Make sure that the message is from the right channel
-    u32_t result;
-    u32_t status;
-    do {
-        // Make sure there is mail to recieve
-        do {
-            status = read_mmion(MBOX_0_STATUS);
-        } while (status & MBOX_EMPTY);
+/// @brief Words in a tag header, the tag id, the value buffer size and the request code.
+#define MBOX_TAG_HEADER_WORDS 3
 
-        // Get the message
-        result = read_mmion(MBOX_0_READ);
-    } while ((result & 0xf) != channel);
+/// @brief Mailbox 0 configuration bit that raises an interrupt while there is mail for the ARM.
+#define MBOX_CONFIG_DATA_IRQ 0x1
 
-    return result;
-}
+/**
+ * @brief An in-flight request.
+ */
+struct mailbox_slot_t {
+    struct MailboxCompletion* completion;
+    struct MailboxMessage* message; // Property message to update with the reply, or NULL.
+    u32_t* buffer;                  // Buffer handed to the VideoCore for `message`.
+};
+
+/**
+ * @brief The requests in flight on a channel, oldest first.
+ *
+ * The VideoCore answers the requests on a channel in the order they were sent, so each reply
+ * completes the oldest request of its channel.
+ */
+struct mailbox_channel_t {
+    struct mailbox_slot_t slots[MBOX_IN_FLIGHT];
+    u32_t head;
+    u32_t count;
+};
+
+/// @brief In-flight requests of every channel.
+static struct mailbox_channel_t mbox_channels[MBOX_CHANNELS];
+
+/// @brief Message buffers in the coherent pool, one per property channel slot.
+static struct coherent_buffer_t mbox_property_buffers[MBOX_IN_FLIGHT];
+
+/// @brief Set once the mailbox interrupt completes requests, until then waiting polls.
+static bool mbox_irq_enabled;
 
+/// @brief Replies that arrived on a channel with nothing in flight.
+static u32_t mbox_stray_replies;
+
+/**
+ * @brief Write a message to the VideoCore.
+ *
+ * Spins while the write FIFO is full, which the VideoCore drains as fast as it takes requests, so
+ * it never waits for a reply.
+ *
+ * @param msg The data and channel.
+ */
 static void mailbox_send(u32_t msg) {
-    u32_t status;
+    while (read_mmion(mbox_base + MBOX_1_STATUS) & MBOX_FULL)
+        ;
+
+    __write_barrier();
+    write_mmion(mbox_base + MBOX_1_WRITE, msg);
+}
+
+/**
+ * @brief Complete the oldest request of the channel of a reply.
+ *
+ * Must be called with IRQs masked.
+ *
+ * @param reply The reply read from the mailbox.
+ */
+static void mailbox_complete(u32_t reply) {
+    struct mailbox_channel_t* channel = &mbox_channels[reply & 0xf];
+    if (channel->count == 0) {
+        mbox_stray_replies++;
+        return;
+    }
 
-    // Make sure you can send mail
-    do {
-        status = read_mmion(MBOX_0_STATUS);
-    } while (status & MBOX_FULL);
+    struct mailbox_slot_t* slot = &channel->slots[channel->head];
+    channel->head               = (channel->head + 1) & (MBOX_IN_FLIGHT - 1);
+    channel->count--;
+
+    struct MailboxMessage* message = slot->message;
+    if (message && slot->buffer == message->buffer) {
+        // The VideoCore wrote the reply to memory, under any stale lines of the message.
+        cache_invalidate_range(message->buffer, message->buffer[0]);
+    } else if (message) {
+        for (u32_t i = 0; i <= message->words; i++) {
+            message->buffer[i] = slot->buffer[i];
+        }
+    }
 
-    // Send the message
-    write_mmion(MBOX_1_WRITE, msg);
+    struct MailboxCompletion* completion = slot->completion;
+    completion->reply                    = reply & ~0xf;
+    completion->state                    = MBOX_COMPLETION_DONE;
+    trace(TRACE_MAILBOX_COMPLETE, (u32_t)(ptr_t)completion, reply & 0xf);
+    if (completion->callback) {
+        completion->callback(completion, completion->context);
+    }
 }
 
 /**
- * @brief Call mailbox with specified buffer.
+ * @brief Complete a request for every reply waiting in the mailbox.
  *
- * This function must be given a buffer aligned to a 16 byte boundary.
+ * Must be called with IRQs masked.
+ */
+static void mailbox_service(void) {
+    while (!(read_mmion(mbox_base + MBOX_0_STATUS) & MBOX_EMPTY)) {
+        mailbox_complete(read_mmion(mbox_base + MBOX_0_READ));
+    }
+    __read_barrier();
+}
+
+/**
+ * @brief Mailbox interrupt handler, raised while there is mail for the ARM.
+ */
+static void mailbox_irq(void* context) {
+    (void)context;
+    mailbox_service();
+}
+
+/**
+ * @brief Complete mailbox requests from the mailbox interrupt from now on.
  *
- * @param buffer The mailbox buffer.
+ * Requires the interrupt controller to have been probed. Until this is called, and whenever the
+ * caller has IRQs masked, `mailbox_wait` polls the mailbox instead.
+ *
+ * The property message buffers are taken from the coherent pool here, once, as completion callbacks
+ * may submit from the interrupt and the pool can not be allocated from there. Without the pool
+ * messages are cleaned out of the cache instead.
+ *
+ * @return enum MailboxReturnStatus MBOX_ERROR_NO_IRQ if the interrupt could not be registered,
+ * MBOX_ERROR_NO_MEMORY if the message buffers could not be allocated.
  */
-static void mailbox_call(u32_t* buffer, enum MailboxChannels channel) {
-    // Get upper 28 bits of message address and combine with lower 4 bits
-    // containing 4 bits of channel number.
-    u32_t message = ((u32_t)buffer & ~0xf) | ((u32_t)channel & 0xf);
+enum MailboxReturnStatus mailbox_enable_irq(void) {
+    for (u32_t i = 0; i < MBOX_IN_FLIGHT && coherent_ready(); i++) {
+        if (!mbox_property_buffers[i].cpu &&
+            coherent_alloc(MBOX_MESSAGE_WORDS * sizeof(u32_t), &mbox_property_buffers[i]) !=
+                COHERENT_GOOD) {
+            mbox_property_buffers[i].cpu = NULL;
+            return MBOX_ERROR_NO_MEMORY;
+        }
+    }
+
+    if (irq_register(IRQ_MAILBOX, mailbox_irq, NULL) != IRQ_GOOD) {
+        return MBOX_ERROR_NO_IRQ;
+    }
 
-    mailbox_send(message);
-    mailbox_read(channel);
+    __write_barrier();
+    write_mmion(mbox_base + MBOX_0_CONFIG, MBOX_CONFIG_DATA_IRQ);
+
+    if (irq_enable(IRQ_MAILBOX) != IRQ_GOOD) {
+        return MBOX_ERROR_NO_IRQ;
+    }
+    mbox_irq_enabled = true;
+    return MBOX_GOOD;
 }
 
 /**
- * @brief Request a property through the mailbox interface. Returns an integer status code,
- * MailboxReturnStatus.
+ * @brief Set up a completion handle before submitting a request with it.
  *
- * @param code The mailbox property to request.
- * @param buffer Return buffer, this must be large enough to support the full buffer. The size of
- * the required buffer can be found out by calling mailbox_resolve_buffer_size()
+ * @param completion The handle.
+ * @param callback Called from the mailbox interrupt once the request completes, may be NULL.
+ * @param context Passed to the callback.
  */
-enum MailboxReturnStatus mailbox_request_property(enum MailboxRequestCodes code, u8_t* buffer) {
-    u32_t mboxBuffer[MAX_MBOX_BUFFER] __attribute__((aligned(16)));
+void mailbox_completion_init(struct MailboxCompletion* completion, mailbox_callback_t callback,
+                             void* context) {
+    completion->state    = MBOX_COMPLETION_IDLE;
+    completion->reply    = 0;
+    completion->callback = callback;
+    completion->context  = context;
+}
+
+/**
+ * @brief Add a request to the in-flight table of its channel and send it, without waiting.
+ *
+ * Must be called with IRQs masked and a free slot on the channel.
+ *
+ * @param channel The channel.
+ * @param data The data to send, its low 4 bits must be clear.
+ * @param completion The completion handle of the request.
+ * @param message The property message to update with the reply, or NULL.
+ * @param buffer The buffer handed to the VideoCore for `message`.
+ */
+static void mailbox_push(u32_t channel, u32_t data, struct MailboxCompletion* completion,
+                         struct MailboxMessage* message, u32_t* buffer) {
+    struct mailbox_channel_t* queue = &mbox_channels[channel];
+    struct mailbox_slot_t* slot =
+        &queue->slots[(queue->head + queue->count) & (MBOX_IN_FLIGHT - 1)];
+
+    slot->completion = completion;
+    slot->message    = message;
+    slot->buffer     = buffer;
+    queue->count++;
+
+    completion->state = MBOX_COMPLETION_PENDING;
+    trace(TRACE_MAILBOX_SUBMIT, (u32_t)(ptr_t)completion, channel);
+    mailbox_send((data & ~0xf) | channel);
+}
+
+/**
+ * @brief Send a request on a channel and return without waiting for the reply.
+ *
+ * Any memory that `data` points to must already be visible to the VideoCore, either in the
+ * coherent pool or cleaned out of the data cache.
+ *
+ * @param channel The channel.
+ * @param data The data to send, usually a bus address, its low 4 bits must be clear.
+ * @param completion The completion handle, the reply data is left in it.
+ * @return enum MailboxReturnStatus MBOX_ERROR_BUSY if the channel has too many requests in flight.
+ */
+enum MailboxReturnStatus mailbox_submit(enum MailboxChannels channel, u32_t data,
+                                        struct MailboxCompletion* completion) {
+    u32_t flags = irq_save();
+    if (mbox_channels[channel & 0xf].count >= MBOX_IN_FLIGHT) {
+        irq_restore(flags);
+        return MBOX_ERROR_BUSY;
+    }
+
+    mailbox_push(channel & 0xf, data, completion, NULL, NULL);
+    irq_restore(flags);
+    return MBOX_GOOD;
+}
+
+/**
+ * @brief Check whether a request has completed.
+ *
+ * @param completion The completion handle of the request.
+ * @return bool True once the request has completed.
+ */
+bool mailbox_poll(struct MailboxCompletion* completion) {
+    if (!mbox_irq_enabled) {
+        u32_t flags = irq_save();
+        mailbox_service();
+        irq_restore(flags);
+    }
+    return completion->state == MBOX_COMPLETION_DONE;
+}
+
+/**
+ * @brief Wait for a request to complete.
+ *
+ * Sleeps until the next interrupt while the mailbox interrupt is enabled, and polls the mailbox
+ * otherwise.
+ *
+ * @param completion The completion handle of the request.
+ */
+void mailbox_wait(struct MailboxCompletion* completion) {
+    while (true) {
+        // Checked with IRQs masked so the reply can not slip in between the check and the sleep,
+        // a pending IRQ still wakes the core and is taken once the mask is restored.
+        u32_t flags = irq_save();
+        if (completion->state != MBOX_COMPLETION_PENDING) {
+            irq_restore(flags);
+            return;
+        }
 
-    u8_t valueBufferSize = mailbox_resolve_request_buffer_size(code);
-    u32_t* mbuf_32       = mboxBuffer;
-    u8_t* vbuf_8         = (u8_t*)(mbuf_32 + 5);
+        if (mbox_irq_enabled && !(flags & IRQ_CPSR_MASK)) {
+            __irq_wait();
+        } else {
+            mailbox_service();
+        }
+        irq_restore(flags);
+    }
+}
 
-    // Setup header
-    mbuf_32[0] = (0x6 * 4) + ((valueBufferSize + 3) &
-                              ~0x3); // This code rounds valueBufferSize up to the nearest
-                                     // multiple of 4 to account for padding to 32 bits.
+/**
+ * @brief Start an empty property message.
+ *
+ * @param message The message.
+ */
+void mailbox_message_init(struct MailboxMessage* message) {
+    message->words    = MBOX_HEADER_WORDS;
+    message->overflow = false;
+}
 
-    // Request from the mailbox.
-    mbuf_32[1] = MBOX_REQUEST_CODE;
+/**
+ * @brief Add a tag to a property message.
+ *
+ * The value buffer of the tag is large enough for both the request and the response, and is
+ * padded to a whole number of words.
+ *
+ * @param message The message to add to.
+ * @param code The property to request.
+ * @param request Request arguments, may be NULL if `requestWords` is 0.
+ * @param requestWords Number of words in `request`.
+ * @param valueSize Size of the response in bytes.
+ * @return mailbox_tag_t Handle of the tag, MBOX_NO_TAG if it did not fit, in which case the message
+ * is marked as overflowed and will not be sent.
+ */
+mailbox_tag_t mailbox_message_add(struct MailboxMessage* message, enum MailboxRequestCodes code,
+                                  const u32_t* request, u32_t requestWords, u32_t valueSize) {
+    u32_t valueWords = (valueSize + 3) >> 2;
+    if (valueWords < requestWords) {
+        valueWords = requestWords;
+    }
 
-    // Tag id.
-    mbuf_32[2] = code;
+    // Leave room for the end tag.
+    if (message->words + MBOX_TAG_HEADER_WORDS + valueWords + 1 > MBOX_MESSAGE_WORDS) {
+        message->overflow = true;
+        return MBOX_NO_TAG;
+    }
 
-    // Value buffer size in bytes.
-    mbuf_32[3] = valueBufferSize;
+    u32_t* tag = message->buffer + message->words;
+    tag[0]     = code;
+    tag[1]     = valueWords * sizeof(u32_t);
+    tag[2]     = MBOX_TAG_REQUEST_CODE;
+    for (u32_t i = 0; i < valueWords; i++) {
+        tag[MBOX_TAG_HEADER_WORDS + i] = i < requestWords ? request[i] : 0;
+    }
 
-    // Request code.
-    mbuf_32[4] = MBOX_TAG_REQUEST_CODE;
+    mailbox_tag_t handle = message->words;
+    message->words += MBOX_TAG_HEADER_WORDS + valueWords;
+    return handle;
+}
 
-    // Init value buffer to 0x0
-    for (int i = 0; i < valueBufferSize; i++) {
-        vbuf_8[i] = 0x0;
+/**
+ * @brief Send a property message to the VideoCore and return without waiting for the reply.
+ *
+ * Once `mailbox_enable_irq` has set up the coherent buffers the message goes through one, copying
+ * a few words being cheaper than cleaning and invalidating the cache lines of the message. Nothing
+ * is allocated here, so callbacks may submit from the mailbox interrupt. The message is updated
+ * with the reply before the request completes, and must stay alive until then.
+ *
+ * @param message The message.
+ * @param completion The completion handle.
+ * @return enum MailboxReturnStatus MBOX_ERROR_BUSY if too many messages are in flight.
+ */
+enum MailboxReturnStatus mailbox_message_submit(struct MailboxMessage* message,
+                                                struct MailboxCompletion* completion) {
+    if (message->overflow) {
+        return MBOX_ERROR_MESSAGE_FULL;
     }
 
-    // Padding goes here.
-    // Setup footer.
-    mbuf_32[5 + valueBufferSize / 4] = MBOX_END_TAG;
+    u32_t words                = message->words + 1;
+    message->buffer[0]         = words * sizeof(u32_t);
+    message->buffer[1]         = MBOX_REQUEST_CODE;
+    message->buffer[words - 1] = MBOX_END_TAG;
 
-    mailbox_call(mboxBuffer, MBOX_PROPERTY_CHANNEL);
+    u32_t flags                       = irq_save();
+    struct mailbox_channel_t* channel = &mbox_channels[MBOX_PROPERTY_CHANNEL];
+    if (channel->count >= MBOX_IN_FLIGHT) {
+        irq_restore(flags);
+        return MBOX_ERROR_BUSY;
+    }
 
-    if ((mbuf_32[4] & (1 << 31)) == 0) {
-        return MBOX_ERROR_NO_RESPONSE;
+    u32_t slot    = (channel->head + channel->count) & (MBOX_IN_FLIGHT - 1);
+    u32_t* buffer = mbox_property_buffers[slot].cpu;
+    if (buffer) {
+        for (u32_t i = 0; i < words; i++) {
+            buffer[i] = message->buffer[i];
+        }
+    } else {
+        // The VideoCore reads the message from memory, not the ARM cache.
+        buffer = message->buffer;
+        cache_clean_range(buffer, words * sizeof(u32_t));
     }
+    __data_sync_barrier();
+
+    mailbox_push(MBOX_PROPERTY_CHANNEL, coherent_bus_address(buffer), completion, message, buffer);
+    irq_restore(flags);
+    return MBOX_GOOD;
+}
 
-    if (mbuf_32[1] == MBOX_REQUEST_FAILED) {
+/**
+ * @brief Check whether the VideoCore parsed a completed property message.
+ *
+ * @param message The message.
+ * @return enum MailboxReturnStatus MBOX_GOOD if the VideoCore parsed the message.
+ */
+enum MailboxReturnStatus mailbox_message_status(const struct MailboxMessage* message) {
+    if (message->buffer[1] != MBOX_REQUEST_SUCCEED) {
         return MBOX_ERROR_PARSING_REQUEST;
     }
+    return MBOX_GOOD;
+}
+
+/**
+ * @brief Send a property message to the VideoCore and wait for the responses to all of its tags.
+ *
+ * @param message The message.
+ * @return enum MailboxReturnStatus MBOX_GOOD if the VideoCore parsed the message.
+ */
+enum MailboxReturnStatus mailbox_message_send(struct MailboxMessage* message) {
+    struct MailboxCompletion completion;
+    enum MailboxReturnStatus status;
+
+    mailbox_completion_init(&completion, NULL, NULL);
+    if ((status = mailbox_message_submit(message, &completion)) != MBOX_GOOD) {
+        return status;
+    }
+
+    mailbox_wait(&completion);
+    return mailbox_message_status(message);
+}
 
-    // Write output into buffer
-    for (int i = 0; i < (int)(mbuf_32[4] & ~(1 << 31)); i++) {
-        buffer[i] = vbuf_8[i];
+/**
+ * @brief Read back the response to a tag of a sent message.
+ *
+ * @param message The message, after `mailbox_message_send`.
+ * @param tag Handle of the tag, from `mailbox_message_add`.
+ * @param value Buffer for the response, may be NULL to only check that there was a response.
+ * @param size Size of `value` in bytes, a longer response is truncated.
+ * @return enum MailboxReturnStatus MBOX_ERROR_NO_RESPONSE if the VideoCore did not answer the tag.
+ */
+enum MailboxReturnStatus mailbox_message_result(const struct MailboxMessage* message,
+                                                mailbox_tag_t tag, void* value, u32_t size) {
+    if (tag == MBOX_NO_TAG || tag >= message->words) {
+        return MBOX_ERROR_PARSING_REQUEST;
     }
 
+    const u32_t* header = message->buffer + tag;
+    if ((header[2] & MBOX_TAG_RESPONSE) == 0) {
+        return MBOX_ERROR_NO_RESPONSE;
+    }
+
+    // The response length may be longer than the value buffer if it was truncated.
+    u32_t length = header[2] & ~MBOX_TAG_RESPONSE;
+    if (length > header[1]) {
+        length = header[1];
+    }
+    if (length > size) {
+        length = size;
+    }
+
+    const u8_t* response = (const u8_t*)(header + MBOX_TAG_HEADER_WORDS);
+    u8_t* out            = value;
+    for (u32_t i = 0; value && i < length; i++) {
+        out[i] = response[i];
+    }
     return MBOX_GOOD;
 }
 
+/**
+ * @brief Request a property through the mailbox interface. Returns an integer status code,
+ * MailboxReturnStatus.
+ *
+ * To request several properties at once, build a message with `mailbox_message_add` instead.
+ *
+ * @param code The mailbox property to request.
+ * @param buffer Return buffer, this must be large enough to support the full buffer. The size of
+ * the required buffer can be found out by calling mailbox_resolve_request_buffer_size()
+ */
+enum MailboxReturnStatus mailbox_request_property(enum MailboxRequestCodes code, u8_t* buffer) {
+    struct MailboxMessage message;
+    enum MailboxReturnStatus status;
+
+    mailbox_message_init(&message);
+    mailbox_tag_t tag = mailbox_message_add_property(&message, code);
+
+    if ((status = mailbox_message_send(&message)) != MBOX_GOOD) {
+        return status;
+    }
+    return mailbox_message_result(&message, tag, buffer,
+                                  (u32_t)mailbox_resolve_request_buffer_size(code));
+}
+
 /**
  * @brief Find out how large of a buffer must be allocated to store a request to the mailbox with
  * this code.
@@ -189,65 +563,17 @@ int mailbox_resolve_request_buffer_size(enum MailboxRequestCodes code) {
     case MBOX_GET_CLOCKS:
         return 0x8;
         break;
+    case MBOX_GET_CLOCK_RATE:
+    case MBOX_GET_MAX_CLOCK_RATE:
+    case MBOX_GET_MIN_CLOCK_RATE:
+        return 0x8;
+        break;
+    case MBOX_SET_CLOCK_RATE:
+        return 0xc;
+        break;
 
     default:
         return 0;
         break;
     }
 }
-
-/**
- * @brief Initialise the mailbox memory iterator.
- * 
- * This function initialises the iterator to the -1st element.
- *
- * @param iter The iterator to be used to iterate through the memory information.
- * @return enum MailboxReturnStatus The status of the request.
- */
-enum MailboxReturnStatus mailbox_mem_iter_init(struct MailboxMemoryIterator* iter, bool is_arm) {
-    iter->is_arm = is_arm;
-    iter->index  = -1;
-    iter->base   = 0;
-    iter->size   = 0;
-    return MBOX_GOOD;
-}
-
-/**
- * @brief Get the next memory segment from the mailbox.
- *
- * This function will return the next memory segment from the mailbox. The iterator must be
- * initialised before this function is called.
- *
- * @param iter The iterator to be used to iterate through the memory information.
- * @return enum MailboxReturnStatus The status of the request.
- */
-enum MailboxReturnStatus mailbox_mem_iter_next(struct MailboxMemoryIterator* iter) {
-    // For now only request the first arm / vc memory segment.
-    if (iter->index == 0) {
-        return MBOX_ITER_NO_MORE_SEGMENTS;
-    }
-    if (iter->is_arm) {
-        u32_t buf[2];
-        enum MailboxReturnStatus status = mailbox_request_property(MBOX_GET_ARM_MEMORY, (u8_t*)&buf);
-        if (status != MBOX_GOOD) {
-            return status;
-        }
-
-        iter->base = *(u32_t*)&buf[0];
-        iter->size = *(u32_t*)&buf[4];
-        iter->index = 0;
-
-    } else {
-        u32_t buf[2];
-        enum MailboxReturnStatus status = mailbox_request_property(MBOX_GET_VC_MEMORY, (u8_t*)&buf);
-        if (status != MBOX_GOOD) {
-            return status;
-        }
-
-        iter->base = *(u32_t*)&buf[0];
-        iter->size = *(u32_t*)&buf[4];
-        iter->index = 0;
-    }
-
-    return MBOX_GOOD;
-}
\ No newline at end of file
@@ -9,159 +9,781 @@
  */
 #include "drivers/uart.h"
 #include "common/common.h"
+#include "common/format.h"
 #include "common/mmio.h"
+#include "common/ring.h"
 #include "common/types.h"
+#include "drivers/clock_rate.h"
+#include "drivers/dma.h"
+#include "drivers/dt.h"
 #include "drivers/gpio.h"
+#include "drivers/irq.h"
+#include "kernel/coherent.h"
+#include "kernel/trace.h"
 
 /**
- * @brief Addresses for UART peripheral memory mapped IO.
+ * @brief Default physical base address of the UART, used until the device tree has been probed.
  *
  * Peripheral bus addresses start at 0x7E000000
  * Mapped physical addresses start at 0x20000000
  */
-enum UartPhysicalAddress {
-    UART0_BASE   = 0x20201000,          // Base address
-    UART0_DR     = (UART0_BASE + 0x00), // Data register
-    UART0_RSRECR = (UART0_BASE + 0x04), // Receive status register / error clear register
-    UART0_FR     = (UART0_BASE + 0x18), // Flag register
-    UART0_ILPR   = (UART0_BASE + 0x20), // Integer baud rate divisor
-    UART0_IBRD   = (UART0_BASE + 0x24), // Integer baud rate divisor
-    UART0_FBRD   = (UART0_BASE + 0x28), // Fractional baud rate divisor
-    UART0_LCRH   = (UART0_BASE + 0x2C), // Line control register
-    UART0_CR     = (UART0_BASE + 0x30), // Control register
-    UART0_IFLS   = (UART0_BASE + 0x34), // Interrupt FIFO level select register
-    UART0_IMSC   = (UART0_BASE + 0x38), // Interrupt mask set clear register
-    UART0_RIS    = (UART0_BASE + 0x3C), // Raw interrupt status register
-    UART0_MIS    = (UART0_BASE + 0x40), // Masked interrupt status register
-    UART0_ICR    = (UART0_BASE + 0x44), // Interrupt clear register
-    UART0_DMACR  = (UART0_BASE + 0x48), // DMA control register
-    UART0_ITCR   = (UART0_BASE + 0x80), // Test control register
-    UART0_ITIP   = (UART0_BASE + 0x84), // Integration test input register
-    UART0_ITOP   = (UART0_BASE + 0x88), // Integration test output register
-    UART0_TDR    = (UART0_BASE + 0x8C), // Test data register
+#define UART0_DEFAULT_BASE 0x20201000
+
+/**
+ * @brief Register offsets for UART peripheral memory mapped IO, from the UART base address.
+ */
+enum UartRegisterOffset {
+    UART0_DR     = 0x00, // Data register
+    UART0_RSRECR = 0x04, // Receive status register / error clear register
+    UART0_FR     = 0x18, // Flag register
+    UART0_ILPR   = 0x20, // Integer baud rate divisor
+    UART0_IBRD   = 0x24, // Integer baud rate divisor
+    UART0_FBRD   = 0x28, // Fractional baud rate divisor
+    UART0_LCRH   = 0x2C, // Line control register
+    UART0_CR     = 0x30, // Control register
+    UART0_IFLS   = 0x34, // Interrupt FIFO level select register
+    UART0_IMSC   = 0x38, // Interrupt mask set clear register
+    UART0_RIS    = 0x3C, // Raw interrupt status register
+    UART0_MIS    = 0x40, // Masked interrupt status register
+    UART0_ICR    = 0x44, // Interrupt clear register
+    UART0_DMACR  = 0x48, // DMA control register
+    UART0_ITCR   = 0x80, // Test control register
+    UART0_ITIP   = 0x84, // Integration test input register
+    UART0_ITOP   = 0x88, // Integration test output register
+    UART0_TDR    = 0x8C, // Test data register
+};
+
+/// @brief Rate of the UART reference clock that the firmware sets up by default, 3MHz.
+#define UART_DEFAULT_CLOCK 3000000
+
+/**
+ * @brief Rate the UART reference clock is raised to for UART_HIGH_SPEED_BAUD and above, 48MHz. It
+ * divides exactly into 3000000 baud and is within 0.2% of 921600 baud.
+ */
+#define UART_HIGH_SPEED_CLOCK 48000000
+
+/// @brief Largest integer part of the baud rate divisor.
+#define UART_MAX_IBRD 0xffff
+
+/// @brief Flag register bits.
+enum UartFlags {
+    UART0_FR_BUSY = 1 << 3,
+    UART0_FR_RXFE = 1 << 4,
+    UART0_FR_TXFF = 1 << 5,
+};
+
+/// @brief Interrupt bits, shared by the mask, status and clear registers.
+enum UartInterrupts {
+    UART0_INT_RX = 1 << 4,  // Receive FIFO at or above its level.
+    UART0_INT_TX = 1 << 5,  // Transmit FIFO at or below its level.
+    UART0_INT_RT = 1 << 6,  // Receive FIFO not empty and idle for 32 bits.
+    UART0_INT_OE = 1 << 10, // Receive overrun.
+};
+
+/**
+ * @brief FIFO levels of the interrupts (UART0_IFLS). The transmit interrupt fires with a quarter of
+ * the FIFO still to send, so the line never idles while the handler refills it, and the receive
+ * interrupt at half full, with the timeout picking up anything less.
+ */
+#define UART0_IFLS_TX_QUARTER 0x1
+#define UART0_IFLS_RX_HALF    (0x2 << 3)
+
+/// @brief DMA control register bit that lets the transmit FIFO request data from the DMA engine.
+#define UART0_DMACR_TXDMAE (1 << 1)
+
+/// @brief Bytes sent per DMA pass, each takes a word of the bounce buffer.
+#define UART_DMA_BOUNCE_SIZE 512
+
+/**
+ * @brief Writes of at least this many bytes go through the DMA engine once it is set up, which
+ * costs one interrupt per pass rather than one per FIFO refill.
+ */
+#define UART_DMA_MIN_WRITE 32
+
+/// @brief Size of the transmit ring, a power of two.
+#define UART_TX_RING_SIZE 4096
+
+/// @brief Size of the receive ring, a power of two.
+#define UART_RX_RING_SIZE 256
+
+/// @brief Physical base address of the UART registers.
+static ptr_t uart_base = UART0_DEFAULT_BASE;
+
+/// @brief Rate of the UART reference clock in Hz.
+static u32_t uart_clock = UART_DEFAULT_CLOCK;
+
+/// @brief Line speed in bits per second.
+static u32_t uart_baud_rate = UART_BOOT_BAUD;
+
+/**
+ * @brief Bytes waiting to be sent.
+ *
+ * Produced by `uart_putch` and consumed by the interrupt handler, or by `uart_tx_kick` with IRQs
+ * masked, so there is only ever one consumer running.
+ */
+static u8_t uart_tx_buffer[UART_TX_RING_SIZE];
+static struct ring_t uart_tx;
+
+/**
+ * @brief Bytes received and not yet read.
+ *
+ * Produced by the interrupt handler, or by `uart_getch` with IRQs masked, and consumed by
+ * `uart_getch`.
+ */
+static u8_t uart_rx_buffer[UART_RX_RING_SIZE];
+static struct ring_t uart_rx;
+
+/// @brief Set once the rings are in use, until then every byte goes straight to the FIFO.
+static bool uart_irq_enabled;
+
+/// @brief The current interrupt mask (UART0_IMSC).
+static u32_t uart_interrupts;
+
+/**
+ * @brief What the DMA engine reads for a bulk transmit, in the coherent pool.
+ *
+ * The DMA engine writes whole words to the data register, which keeps only the low byte of each, so
+ * the segments are sent through `words` one byte per word, in as many passes as they need.
+ */
+struct uart_dma_bounce_t {
+    struct dma_control_block_t block;
+    u32_t words[UART_DMA_BOUNCE_SIZE];
 };
 
+static struct coherent_buffer_t uart_dma_buffer;
+
+/// @brief Set once `uart_enable_dma` has succeeded.
+static bool uart_dma_enabled;
+
+/// @brief DMA channel used for bulk transmit, claimed by `uart_enable_dma`.
+static u32_t uart_dma_channel;
+
+/// @brief The segments of the current bulk transmit, and how far through them the passes are.
+static struct uart_dma_segment_t uart_dma_segments[UART_DMA_MAX_SEGMENTS];
+static u32_t uart_dma_count;
+static u32_t uart_dma_segment;
+static u32_t uart_dma_offset;
+
+/// @brief Set while a bulk transmit owns the transmit FIFO, the ring waits until it is done.
+static volatile bool uart_dma_active;
+
+/// @brief Completion callback of the current bulk transmit.
+static uart_dma_callback_t uart_dma_callback;
+static void* uart_dma_context;
+
+/**
+ * @brief Device tree probe, records the UART base address.
+ *
+ * @param node The UART node.
+ * @return enum dt_return_value_t Return value.
+ */
+static enum dt_return_value_t uart_probe(const struct dt_node_iter_t* node) {
+    return dt_iter_mmio_base(node, &uart_base);
+}
+
+static const char* const uart_compatible[] = {"brcm,bcm2835-pl011", "arm,pl011", NULL};
+
+/// @brief PL011 UART driver.
+const struct dt_driver_t uart_driver = {"uart", uart_compatible, uart_probe};
+
+/**
+ * @brief Work out the baud rate divisor for a line speed from the rate of the UART reference
+ * clock.
+ *
+ * Baud rate divisor = UART_CLK / (16 * BAUD), held as an integer part and a fraction in 64ths, so
+ * the register pair is UART_CLK * 4 / BAUD rounded to the nearest integer. At 3MHz and 115200 baud
+ * that is 1 + 40 / 64.
+ *
+ * @param clock The rate of the UART reference clock in Hz.
+ * @param baud The line speed in bits per second.
+ * @return u32_t The divisor in 64ths, 0 if the clock can not make the line speed.
+ */
+static u32_t uart_divisor(u32_t clock, u32_t baud) {
+    if (baud == 0) {
+        return 0;
+    }
+
+    u64_t quotient = (((u64_t)clock << 2) + (baud >> 1)) / baud;
+
+    if ((quotient >> 6) == 0 || (quotient >> 6) > UART_MAX_IBRD) {
+        return 0;
+    }
+    return (u32_t)quotient;
+}
+
+/**
+ * @brief Write a baud rate divisor from `uart_divisor`.
+ */
+static void uart_write_divisor(u32_t divisor) {
+    write_mmion(uart_base + UART0_IBRD, divisor >> 6);
+    write_mmion(uart_base + UART0_FBRD, divisor & 0x3f);
+}
+
 /**
  * @brief Initialise the UART peripheral on GPIO pins 14 & 15.
  */
 void uart_init(void) {
     // Disable UART
     __write_barrier();
-    write_mmion(UART0_CR, 0x0);
-
-    // Disable pull-up / pull-down & wait 150 clock cycles for the control signal setup.
-    write_mmion(GPIO_GPPUD, 0x0);
-    spin_delay(150);
+    write_mmion(uart_base + UART0_CR, 0x0);
 
-    // Propagate pulldown signal to pins 14 & 15.
-    write_mmion(GPIO_GPPUDCLK0, (1 << 14) | (1 << 15));
-    spin_delay(150);
-
-    // Clear control and clock signal.
-    write_mmion(GPIO_GPPUD, 0x0);
-    write_mmion(GPIO_GPPUDCLK0, 0x0);
+    // Disable pull-up / pull-down on pins 14 & 15.
+    gpio_pin_pull(14, GPIO_PULL_NONE);
+    gpio_pin_pull(15, GPIO_PULL_NONE);
 
     // Clear pending interrupts.
-    write_mmion(UART0_ICR, 0x7ff);
+    write_mmion(uart_base + UART0_ICR, 0x7ff);
 
-    // Baud rate divisor = UART_CLK / (16 * BAUD_RATE)
-    // BAUD_RATE = 115200
-    // UART_CLK = 3MHz
-    // Baud rate divisor ≈ 1.6276
-    // Integer  = 0x1
-    // Fraction = 0.625 = 101000 (0.5 + 0.125)
-    write_mmion(UART0_IBRD, 0x1);
-    write_mmion(UART0_FBRD, 0b101000);
+    // The real clock rate is only known once the mailbox is up, see uart_set_clock.
+    uart_write_divisor(uart_divisor(uart_clock, uart_baud_rate));
 
     // Set word length to 8 bits and enable FIFO
-    write_mmion(UART0_LCRH, (1 << 4) | (1 << 5) | (1 << 6));
+    write_mmion(uart_base + UART0_LCRH, (1 << 4) | (1 << 5) | (1 << 6));
 
-    // Configure UART interrupts
-    // 1        : Clear to Send interrupt
-    // 4 & 5    : TX / RX ready to send / receive
-    // 6        : Receive timeout mask
-    // 7 - 10   : Error masks
-    write_mmion(UART0_IMSC, (1 << 1) | (1 << 4) | (1 << 5) | (1 << 6) | (1 << 7) | (1 << 8) |
-                                (1 << 9) | (1 << 10));
+    // Interrupts stay masked until uart_enable_irq.
+    write_mmion(uart_base + UART0_IFLS, UART0_IFLS_TX_QUARTER | UART0_IFLS_RX_HALF);
+    write_mmion(uart_base + UART0_IMSC, 0x0);
 
     // Set TX and RX enable
-    write_mmion(UART0_CR, (1 << 8) | (1 << 9));
+    write_mmion(uart_base + UART0_CR, (1 << 8) | (1 << 9));
     // Enable UART
-    write_mmion(UART0_CR, (1 << 0));
+    write_mmion(uart_base + UART0_CR, (1 << 0));
+    __read_barrier();
+}
+
+/**
+ * @brief Switch to a new baud rate divisor.
+ *
+ * The divisor only takes effect once the line control register is written with the UART disabled,
+ * so the caller must have flushed everything queued.
+ *
+ * @param divisor The divisor from `uart_divisor`.
+ */
+static void uart_write_line_speed(u32_t divisor) {
+    u32_t control = read_mmion(uart_base + UART0_CR);
+    u32_t line    = read_mmion(uart_base + UART0_LCRH);
+
+    __write_barrier();
+    write_mmion(uart_base + UART0_CR, 0x0);
+    uart_write_divisor(divisor);
+    write_mmion(uart_base + UART0_LCRH, line);
+    write_mmion(uart_base + UART0_CR, control);
+    __read_barrier();
+}
+
+/**
+ * @brief Recompute the baud rate divisor after the rate of the UART reference clock has changed.
+ *
+ * Only rewrites the divisor, the caller must `uart_flush` before changing the clock, as anything
+ * still queued would go out at the wrong bit rate.
+ *
+ * @param clock The rate of the UART reference clock in Hz.
+ */
+void uart_set_clock(u32_t clock) {
+    if (clock == 0) {
+        return;
+    }
+
+    uart_clock    = clock;
+    u32_t divisor = uart_divisor(clock, uart_baud_rate);
+    if (divisor) {
+        uart_write_line_speed(divisor);
+    }
+}
+
+/**
+ * @brief Change the line speed.
+ *
+ * Speeds of UART_HIGH_SPEED_BAUD and above first raise the UART reference clock through the
+ * mailbox, as the default 3MHz clock tops out at 187500 baud.
+ *
+ * @param baud The line speed in bits per second.
+ * @return enum UartReturn UART_BAD_BAUD if the reference clock can not make the line speed, in
+ * which case the old one is kept.
+ */
+enum UartReturn uart_set_baud(u32_t baud) {
+    // Everything queued must leave at the old line speed, before the clock or divisor changes.
+    uart_flush();
+
+    if (baud >= UART_HIGH_SPEED_BAUD && uart_clock < UART_HIGH_SPEED_CLOCK) {
+        // Calls back into uart_set_clock, which keeps the current line speed at the new clock.
+        clock_rate_set(CLOCK_ID_UART, UART_HIGH_SPEED_CLOCK);
+    }
+
+    u32_t divisor = uart_divisor(uart_clock, baud);
+    if (divisor == 0) {
+        return UART_BAD_BAUD;
+    }
+
+    uart_baud_rate = baud;
+    uart_write_line_speed(divisor);
+    return UART_GOOD;
+}
+
+/**
+ * @brief The current line speed in bits per second.
+ */
+u32_t uart_baud(void) {
+    return uart_baud_rate;
+}
+
+/**
+ * @brief Set the interrupt mask.
+ *
+ * Must be called with IRQs masked.
+ */
+static void uart_write_interrupts(u32_t interrupts) {
+    if (interrupts != uart_interrupts) {
+        uart_interrupts = interrupts;
+        __write_barrier();
+        write_mmion(uart_base + UART0_IMSC, interrupts);
+    }
+}
+
+/**
+ * @brief Move queued bytes into the transmit FIFO until it is full.
+ *
+ * Must be called with IRQs masked.
+ */
+static void uart_tx_fill(void) {
+    u8_t byte;
+
+    if (uart_dma_active) {
+        uart_write_interrupts(uart_interrupts & ~UART0_INT_TX);
+        return;
+    }
+
+    __read_barrier();
+    while (!(read_mmion(uart_base + UART0_FR) & UART0_FR_TXFF) && ring_pop(&uart_tx, &byte)) {
+        write_mmion(uart_base + UART0_DR, byte);
+    }
+
+    // The transmit interrupt only fires as the FIFO drains through its level, so it is unmasked
+    // while there is more to send and masked again once the ring is empty.
+    u32_t interrupts = uart_interrupts & ~UART0_INT_TX;
+    uart_write_interrupts(ring_empty(&uart_tx) ? interrupts : interrupts | UART0_INT_TX);
+}
+
+/**
+ * @brief Move everything in the receive FIFO into the ring.
+ *
+ * Must be called with IRQs masked.
+ */
+static void uart_rx_drain(void) {
     __read_barrier();
+    while (!(read_mmion(uart_base + UART0_FR) & UART0_FR_RXFE)) {
+        // Bytes that arrive while the ring is full are dropped.
+        ring_push(&uart_rx, (u8_t)read_mmion(uart_base + UART0_DR));
+    }
+}
+
+/**
+ * @brief Start sending what has been queued, and optionally wait for the interrupt to make
+ * progress.
+ *
+ * When the caller has IRQs masked the interrupts can not run, so waiting falls back to refilling
+ * the FIFO and finishing bulk transmits by hand.
+ *
+ * @param wait Sleep until the next interrupt if anything is left to send.
+ */
+static void uart_tx_kick(bool wait) {
+    u32_t flags = irq_save();
+    if (uart_dma_active && (flags & IRQ_CPSR_MASK)) {
+        dma_poll(uart_dma_channel);
+    }
+
+    uart_tx_fill();
+    if (wait && !(flags & IRQ_CPSR_MASK) && (uart_dma_active || !ring_empty(&uart_tx))) {
+        __irq_wait();
+    }
+    irq_restore(flags);
+}
+
+/**
+ * @brief UART interrupt handler, moves bytes between the FIFOs and the rings.
+ */
+static void uart_irq(void* context) {
+    (void)context;
+
+    __read_barrier();
+    u32_t status = read_mmion(uart_base + UART0_MIS);
+
+    if (status & (UART0_INT_RX | UART0_INT_RT | UART0_INT_OE)) {
+        uart_rx_drain();
+    }
+    if (status & UART0_INT_TX) {
+        uart_tx_fill();
+    }
+
+    __write_barrier();
+    write_mmion(uart_base + UART0_ICR, status);
+}
+
+/**
+ * @brief Switch from polling the FIFOs to the interrupt driven rings.
+ *
+ * Requires the interrupt controller to have been probed.
+ *
+ * @return enum UartReturn UART_NO_IRQ if the interrupt could not be registered.
+ */
+enum UartReturn uart_enable_irq(void) {
+    ring_init(&uart_tx, uart_tx_buffer, UART_TX_RING_SIZE);
+    ring_init(&uart_rx, uart_rx_buffer, UART_RX_RING_SIZE);
+
+    if (irq_register(IRQ_UART, uart_irq, NULL) != IRQ_GOOD) {
+        return UART_NO_IRQ;
+    }
+
+    u32_t flags = irq_save();
+    uart_write_interrupts(UART0_INT_RX | UART0_INT_RT | UART0_INT_OE);
+    if (irq_enable(IRQ_UART) != IRQ_GOOD) {
+        uart_write_interrupts(0);
+        irq_restore(flags);
+        return UART_NO_IRQ;
+    }
+    uart_irq_enabled = true;
+    irq_restore(flags);
+    return UART_GOOD;
+}
+
+/**
+ * @brief Wait until everything queued has left the UART.
+ */
+void uart_flush(void) {
+    while (uart_irq_enabled && (uart_dma_active || !ring_empty(&uart_tx))) {
+        uart_tx_kick(true);
+    }
+
+    __read_barrier();
+    while (read_mmion(uart_base + UART0_FR) & UART0_FR_BUSY) {
+    }
+}
+
+/**
+ * @brief Set up bulk transmit through the DMA engine.
+ *
+ * Requires the UART interrupt and the coherent pool.
+ *
+ * @return enum UartReturn UART_NO_DMA if the channel or its bounce buffer could not be set up.
+ */
+enum UartReturn uart_enable_dma(void) {
+    if (!uart_irq_enabled) {
+        return UART_NO_IRQ;
+    }
+    if (!uart_dma_buffer.cpu) {
+        if (coherent_alloc(sizeof(struct uart_dma_bounce_t), &uart_dma_buffer) != COHERENT_GOOD) {
+            uart_dma_buffer.cpu = NULL;
+            return UART_NO_DMA;
+        }
+        if (dma_channel_claim(&uart_dma_channel) != DMA_GOOD) {
+            coherent_free(&uart_dma_buffer);
+            uart_dma_buffer.cpu = NULL;
+            return UART_NO_DMA;
+        }
+    }
+    if (dma_channel_init(uart_dma_channel) != DMA_GOOD) {
+        return UART_NO_DMA;
+    }
+
+    __write_barrier();
+    write_mmion(uart_base + UART0_DMACR, UART0_DMACR_TXDMAE);
+    uart_dma_enabled = true;
+    return UART_GOOD;
+}
+
+static void uart_dma_done(u32_t channel, enum DmaReturn status, void* context);
+
+/**
+ * @brief Copy the next bytes of the segments into the bounce buffer, one per word, and start
+ * sending them.
+ *
+ * @return enum DmaReturn Return value of `dma_start`.
+ */
+static enum DmaReturn uart_dma_pass(void) {
+    struct uart_dma_bounce_t* bounce = uart_dma_buffer.cpu;
+    u32_t words                      = 0;
+
+    while (words < UART_DMA_BOUNCE_SIZE && uart_dma_segment < uart_dma_count) {
+        const struct uart_dma_segment_t* segment = &uart_dma_segments[uart_dma_segment];
+        const u8_t* data                         = segment->data;
+
+        while (words < UART_DMA_BOUNCE_SIZE && uart_dma_offset < segment->length) {
+            bounce->words[words++] = data[uart_dma_offset++];
+        }
+        if (uart_dma_offset == segment->length) {
+            uart_dma_segment++;
+            uart_dma_offset = 0;
+        }
+    }
+
+    struct dma_control_block_t* block = &bounce->block;
+
+    block->info   = DMA_TI_WAIT_RESP | DMA_TI_DEST_DREQ | DMA_TI_SRC_INC |
+                    DMA_TI_PERMAP(DMA_DREQ_UART_TX) | DMA_TI_INTEN;
+    block->source = uart_dma_buffer.bus + sizeof(bounce->block);
+    block->dest   = dma_peripheral_bus_address(uart_base + UART0_DR);
+    block->length = words * sizeof(u32_t);
+    block->stride = 0;
+    block->next   = 0;
+
+    return dma_start(uart_dma_channel, uart_dma_buffer.bus, uart_dma_done, NULL);
+}
+
+/**
+ * @brief DMA completion, starts the next pass, or once everything is sent hands the FIFO back to
+ * the ring and reports to the caller.
+ */
+static void uart_dma_done(u32_t channel, enum DmaReturn status, void* context) {
+    (void)context;
+
+    if (status == DMA_GOOD && uart_dma_segment < uart_dma_count) {
+        status = uart_dma_pass();
+        if (status == DMA_GOOD) {
+            return;
+        }
+    }
+
+    trace(TRACE_UART_DMA_END, channel, status);
+    uart_dma_active = false;
+    uart_tx_fill();
+
+    if (uart_dma_callback) {
+        uart_dma_callback(status == DMA_GOOD ? UART_GOOD : UART_DMA_ERROR, uart_dma_context);
+    }
+}
+
+/**
+ * @brief Send a chain of buffers through the DMA engine, paced by the transmit FIFO.
+ *
+ * Anything already queued through `uart_putch` is sent first, and anything queued while the
+ * transfer runs waits in the ring until it is done. The buffers are read, a pass at a time, until
+ * the callback, so they must stay untouched until then.
+ *
+ * @param segments The buffers, in order.
+ * @param count Number of buffers, at most UART_DMA_MAX_SEGMENTS.
+ * @param callback Called from the DMA interrupt once everything is sent, may be NULL.
+ * @param context Passed to the callback.
+ * @return enum UartReturn UART_BUSY if a transfer is already running.
+ */
+enum UartReturn uart_dma_write(const struct uart_dma_segment_t* segments, u32_t count,
+                               uart_dma_callback_t callback, void* context) {
+    if (!uart_dma_enabled) {
+        return UART_NO_DMA;
+    }
+    if (count == 0 || count > UART_DMA_MAX_SEGMENTS) {
+        return UART_BAD_SEGMENTS;
+    }
+
+    u32_t bytes = 0;
+    for (u32_t i = 0; i < count; i++) {
+        if (segments[i].length == 0) {
+            return UART_BAD_SEGMENTS;
+        }
+        bytes += segments[i].length;
+    }
+
+    // Let the ring empty first, so the output stays in order.
+    while (!ring_empty(&uart_tx)) {
+        uart_tx_kick(true);
+    }
+
+    u32_t flags = irq_save();
+    if (uart_dma_active) {
+        irq_restore(flags);
+        return UART_BUSY;
+    }
+
+    for (u32_t i = 0; i < count; i++) {
+        uart_dma_segments[i] = segments[i];
+    }
+    uart_dma_count    = count;
+    uart_dma_segment  = 0;
+    uart_dma_offset   = 0;
+    uart_dma_active   = true;
+    uart_dma_callback = callback;
+    uart_dma_context  = context;
+    if (uart_dma_pass() != DMA_GOOD) {
+        uart_dma_active = false;
+        irq_restore(flags);
+        return UART_BUSY;
+    }
+    trace(TRACE_UART_DMA_BEGIN, uart_dma_channel, bytes);
+
+    irq_restore(flags);
+    return UART_GOOD;
+}
+
+/**
+ * @brief Queue a byte, waiting for room if the ring is full.
+ */
+static void uart_tx_push(u8_t byte) {
+    while (!ring_push(&uart_tx, byte)) {
+        uart_tx_kick(true);
+    }
 }
 
 /**
  * @brief Write a character to the UART connection.
  *
+ * Once the interrupt is enabled this only queues the character, unless the ring is full.
+ *
  * @param c Character to write.
  */
 void uart_putch(const char c) {
+    if (uart_irq_enabled) {
+        uart_tx_push((u8_t)c);
+        uart_tx_kick(false);
+        return;
+    }
+
     // Wait for UART transmit FIFO full to be not full.
-    while (read_mmion(UART0_FR) & (1 << 5)) {
+    while (read_mmion(uart_base + UART0_FR) & UART0_FR_TXFF) {
     }
     __read_barrier();
     __write_barrier();
     // Write character to data register.
-    write_mmion(UART0_DR, (u32_t)c);
+    write_mmion(uart_base + UART0_DR, (u32_t)c);
+}
+
+/**
+ * @brief Take a received character if there is one, without waiting.
+ *
+ * @param c Set to the character.
+ * @return bool Whether a character was received.
+ */
+bool uart_try_getch(unsigned char* c) {
+    if (uart_irq_enabled) {
+        u8_t byte;
+        if (!ring_pop(&uart_rx, &byte)) {
+            return false;
+        }
+        *c = byte;
+        return true;
+    }
+
+    __read_barrier();
+    if (read_mmion(uart_base + UART0_FR) & UART0_FR_RXFE) {
+        return false;
+    }
+    *c = (unsigned char)read_mmion(uart_base + UART0_DR);
+    return true;
 }
 
 /**
  * @brief Receive a character from the UART connection.
  *
  * Note: This is a blocking call and will halt the kernel until a character has been received.
+ * Once the interrupt is enabled the core sleeps while it waits.
  *
  * @return unsigned char The character received.
  */
 unsigned char uart_getch() {
+    if (uart_irq_enabled) {
+        u8_t byte;
+        while (!ring_pop(&uart_rx, &byte)) {
+            // Checked with IRQs masked so a byte can not slip in between the check and the sleep.
+            u32_t flags = irq_save();
+            if (flags & IRQ_CPSR_MASK) {
+                uart_rx_drain();
+            } else if (ring_empty(&uart_rx)) {
+                __irq_wait();
+            }
+            irq_restore(flags);
+        }
+        return byte;
+    }
+
     __read_barrier();
     // Wait for UART receive FIFO to not be empty.
-    while (read_mmion(UART0_FR) & (1 << 4)) {
+    while (read_mmion(uart_base + UART0_FR) & UART0_FR_RXFE) {
     }
     // Read from data register.
-    return read_mmion(UART0_DR);
+    return read_mmion(uart_base + UART0_DR);
 }
 
 /**
  * @brief Write a string to the UART connection.
  *
+ * Once the interrupt is enabled this returns as soon as the string is queued.
+ *
  * @param str The null terminated string to send.
  */
 void uart_puts(const char* str) {
+    if (!uart_irq_enabled) {
+        while (*str != '\0') {
+            uart_putch(*str++);
+        }
+        return;
+    }
+
     while (*str != '\0') {
-        uart_putch(*str++);
+        uart_tx_push((u8_t)*str++);
     }
+    uart_tx_kick(false);
 }
 
-#define abs(x) (x >= 0 ? x : -x)
-
 /**
- * @brief Write a signed integer string to the UART connection.
+ * @brief Send a block through the DMA engine for `uart_write`.
  *
- * @param number The integer to send.
+ * Returns once the last pass has copied the block into the bounce buffer, so the caller can reuse
+ * it while the DMA engine is still sending.
+ *
+ * @return bool False if a bulk transmit is already running, the block then goes through the ring.
  */
-void uart_puti(i32_t number) {
+static bool uart_write_dma(const char* data, u32_t length) {
+    struct uart_dma_segment_t segment = {data, length};
 
-    if (number == 0) {
-        uart_putch('0');
-        return;
+    if (uart_dma_write(&segment, 1, NULL, NULL) != UART_GOOD) {
+        return false;
     }
+    while (uart_dma_active && uart_dma_segment < uart_dma_count) {
+        uart_tx_kick(true);
+    }
+    return true;
+}
 
-    char buffer[12]; // 10 decimal digits, 1 '-' and 1 null terminator.
-    char* head = buffer + 11;
-    i32_t save = number;
-    *head--    = '\0';
-    while (number != 0) {
-        *head-- = '0' + abs(number % 10);
-        number /= 10;
+/**
+ * @brief Write a block of characters to the UART connection, the sink of the console files.
+ *
+ * Once the interrupt is enabled the whole block is queued before the transmitter is kicked once,
+ * and blocks of UART_DMA_MIN_WRITE bytes or more go through the DMA engine when it is set up.
+ *
+ * @param data The characters to send.
+ * @param length The number of characters.
+ * @return u32_t The number of characters written, always `length`.
+ */
+u32_t uart_write(const char* data, u32_t length) {
+    if (!uart_irq_enabled) {
+        for (u32_t i = 0; i < length; i++) {
+            uart_putch(data[i]);
+        }
+        return length;
+    }
+    if (uart_dma_enabled && length >= UART_DMA_MIN_WRITE && uart_write_dma(data, length)) {
+        return length;
     }
 
-    if (save < 0) {
-        *head = '-';
-    } else {
-        head++;
+    for (u32_t i = 0; i < length; i++) {
+        uart_tx_push((u8_t)data[i]);
     }
+    uart_tx_kick(false);
+    return length;
+}
 
+/**
+ * @brief Write a signed integer string to the UART connection.
+ *
+ * @param number The integer to send.
+ */
+void uart_puti(i32_t number) {
+    char buffer[FORMAT_NUMBER_SIZE];
+    char* end  = buffer + FORMAT_NUMBER_SIZE - 1;
+    char* head = format_decimal_u32(end, number < 0 ? -(u32_t)number : (u32_t)number);
+
+    *end = '\0';
+    if (number < 0) {
+        *--head = '-';
+    }
     uart_puts(head);
 }
 
@@ -171,24 +793,11 @@ void uart_puti(i32_t number) {
  * @param number The unsigned number to send.
  */
 void uart_putu(u32_t number) {
+    char buffer[FORMAT_NUMBER_SIZE];
+    char* end = buffer + FORMAT_NUMBER_SIZE - 1;
 
-    if (number == 0) {
-        uart_putch('0');
-        return;
-    }
-
-    char buffer[11]; // 10 decimal digits and 1 null terminator.
-    char* head = buffer + 10;
-
-    *head-- = '\0';
-    while (number != 0) {
-        *head-- = '0' + (number % 10);
-        number /= 10;
-    }
-
-    head++;
-
-    uart_puts(head);
+    *end = '\0';
+    uart_puts(format_decimal_u32(end, number));
 }
 
 /**
@@ -196,57 +805,30 @@ void uart_putu(u32_t number) {
  *
  * @param number The long signed number to send.
  */
-// void uart_putil(i64_t number) {
-
-//     if (number == 0) {
-//         uart_putch('0');
-//         return;
-//     }
-
-//     char buffer[21]; // 19 decimal digits, 1 '-' and 1 null terminator.
-//     char* head = buffer + 20;
-//     i64_t save = number;
-
-//     *head-- = '\0';
-//     while (number != 0) {
-//         *head-- = '0' + abs(number % 10);
-//         number /= 10;
-//     }
-
-//     if (save < 0) {
-//         *head = '-';
-//     } else {
-//         head++;
-//     }
-
-//     uart_puts(head);
-// }
+void uart_putil(i64_t number) {
+    char buffer[FORMAT_NUMBER_SIZE];
+    char* end  = buffer + FORMAT_NUMBER_SIZE - 1;
+    char* head = format_decimal_u64(end, number < 0 ? -(u64_t)number : (u64_t)number);
+
+    *end = '\0';
+    if (number < 0) {
+        *--head = '-';
+    }
+    uart_puts(head);
+}
 
 /**
  * @brief Write a long unsigned integer to the UART connection.
  *
  * @param number The long unsigned number to send.
  */
-// void uart_putul(u64_t number) {
+void uart_putul(u64_t number) {
+    char buffer[FORMAT_NUMBER_SIZE];
+    char* end = buffer + FORMAT_NUMBER_SIZE - 1;
 
-//     if (number == 0) {
-//         uart_putch('0');
-//         return;
-//     }
-
-//     char buffer[20]; // 19 decimal digits and 1 null terminator.
-//     char* head = buffer + 19;
-
-//     *head-- = '\0';
-//     while (number != 0) {
-//         *head-- = '0' + (number % 10);
-//         number /= 10;
-//     }
-
-//     head++;
-
-//     uart_puts(head);
-// }
+    *end = '\0';
+    uart_puts(format_decimal_u64(end, number));
+}
 
 #define format_hex(x) ((x < 10) ? ('0' + x) : ('A' + (x - 10)))
 
@@ -276,6 +858,11 @@ void uart_puth(u32_t number) {
     uart_puts(head);
 }
 
+/**
+ * @brief Write a hex formatted long unsigned integer to the UART connection.
+ *
+ * @param number The long unsigned integer to send.
+ */
 void uart_puthl(u64_t number) {
     if (!number) {
         uart_puts("0x0");
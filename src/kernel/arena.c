@@ -0,0 +1,93 @@
+/**
+ * @file arena.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Boot time bump allocator implementation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/arena.h"
+#include "common/types.h"
+
+/// @brief Start of the arena.
+static u8_t* arena_start;
+
+/// @brief Number of bytes of the arena in use, the next allocation starts here.
+static u32_t arena_top;
+
+/// @brief Size of the arena in bytes.
+static u32_t arena_size;
+
+/// @brief Set once the arena has been handed over to the page allocator.
+static bool arena_retired;
+
+/**
+ * @brief Initialise the arena over a region of memory, discarding any previous allocations.
+ *
+ * @param start The start of the region.
+ * @param size The size of the region in bytes.
+ */
+void arena_init(void* start, u32_t size) {
+    arena_start   = start;
+    arena_top     = 0;
+    arena_size    = size;
+    arena_retired = false;
+}
+
+/**
+ * @brief Allocate from the arena.
+ *
+ * @param size The number of bytes to allocate.
+ * @param align The alignment of the allocation, a power of two.
+ * @return void* The memory, or NULL if the arena is full or retired.
+ */
+void* arena_alloc(u32_t size, u32_t align) {
+    if (arena_retired || !arena_start) {
+        return NULL;
+    }
+
+    // Align the address rather than the offset, the start of the arena is only word aligned.
+    uintptr_t address = ((uintptr_t)arena_start + arena_top + align - 1) & ~(uintptr_t)(align - 1);
+    u32_t offset      = (u32_t)(address - (uintptr_t)arena_start);
+
+    if (offset > arena_size || size > arena_size - offset) {
+        return NULL;
+    }
+
+    arena_top = offset + size;
+    return (void*)address;
+}
+
+/**
+ * @brief Get a mark that `arena_release` can roll the arena back to.
+ */
+u32_t arena_mark(void) { return arena_top; }
+
+/**
+ * @brief Free every allocation made since `mark` was taken.
+ *
+ * @param mark A value returned by `arena_mark`, later allocations must not be used afterwards.
+ */
+void arena_release(u32_t mark) {
+    if (mark < arena_top) {
+        arena_top = mark;
+    }
+}
+
+/**
+ * @brief Get the number of bytes of the arena in use, including alignment padding.
+ */
+u32_t arena_used(void) { return arena_top; }
+
+/**
+ * @brief Stop allocating from the arena, so the rest of it can be given to the page allocator.
+ *
+ * Allocations made before this stay valid forever.
+ *
+ * @return void* The first byte past the last allocation, NULL if the arena was never initialised.
+ */
+void* arena_retire(void) {
+    arena_retired = true;
+    return arena_start ? arena_start + arena_top : NULL;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file coherent.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Uncached buffers shared with the VideoCore and the DMA engine implementation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Buffers are runs of granules, tracked by a bitmap. Users are few and long lived (mailbox
+ * messages and DMA control blocks), so a first fit scan is plenty.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/coherent.h"
+#include "common/cache.h"
+#include "common/types.h"
+#include "kernel/mmu.h"
+#include "kernel/page.h"
+
+/// @brief Number of granules in the pool.
+#define COHERENT_GRANULES (MMU_SECTION_SIZE / COHERENT_GRANULE)
+
+_Static_assert((PAGE_SIZE << PAGE_MAX_ORDER) == MMU_SECTION_SIZE,
+               "The coherent pool must be exactly one section");
+
+/// @brief Start of the pool, NULL until `coherent_init`.
+static u8_t* coherent_pool;
+
+/// @brief Bit set for every granule in use.
+static u32_t coherent_used[COHERENT_GRANULES / 32];
+
+static inline bool coherent_granule_used(u32_t granule) {
+    return coherent_used[granule / 32] & (1u << (granule % 32));
+}
+
+static void coherent_mark(u32_t first, u32_t count, bool used) {
+    for (u32_t granule = first; granule < first + count; granule++) {
+        if (used) {
+            coherent_used[granule / 32] |= 1u << (granule % 32);
+        } else {
+            coherent_used[granule / 32] &= ~(1u << (granule % 32));
+        }
+    }
+}
+
+/**
+ * @brief Take a section from the page allocator and map it uncached, to serve coherent buffers
+ * from.
+ *
+ * @return enum CoherentReturn Return value.
+ */
+enum CoherentReturn coherent_init(void) {
+    ptr_t section;
+
+    // Blocks of the largest order are sections, as the page allocator aligns them to their size.
+    if (page_alloc(PAGE_MAX_ORDER, &section) != PAGE_GOOD) {
+        return COHERENT_NO_MEMORY;
+    }
+
+    // Nothing of the section may be left in the cache once it is uncached.
+    cache_clean_invalidate_range((void*)(uintptr_t)section, MMU_SECTION_SIZE);
+    mmu_set_section(section, MMU_MEMORY_UNCACHED);
+
+    for (u32_t i = 0; i < COHERENT_GRANULES / 32; i++) {
+        coherent_used[i] = 0;
+    }
+    coherent_pool = (u8_t*)(uintptr_t)section;
+    return COHERENT_GOOD;
+}
+
+/**
+ * @brief Check whether the coherent pool has been set up.
+ */
+bool coherent_ready(void) { return coherent_pool != NULL; }
+
+/**
+ * @brief Check whether memory is part of the coherent pool, and so never needs cache maintenance.
+ */
+bool coherent_contains(const void* ptr) {
+    return coherent_pool && (const u8_t*)ptr >= coherent_pool &&
+           (const u8_t*)ptr < coherent_pool + MMU_SECTION_SIZE;
+}
+
+/**
+ * @brief Allocate an uncached buffer.
+ *
+ * @param size The size of the buffer in bytes.
+ * @param buffer Where to write the buffer, aligned to COHERENT_GRANULE.
+ * @return enum CoherentReturn Return value.
+ */
+enum CoherentReturn coherent_alloc(u32_t size, struct coherent_buffer_t* buffer) {
+    if (!coherent_pool) {
+        return COHERENT_NOT_STARTED;
+    }
+
+    u32_t count = (size + COHERENT_GRANULE - 1) / COHERENT_GRANULE;
+    if (count == 0 || count > COHERENT_GRANULES) {
+        return COHERENT_NO_MEMORY;
+    }
+
+    u32_t run = 0;
+    for (u32_t granule = 0; granule < COHERENT_GRANULES; granule++) {
+        // Skip whole words that are full.
+        if (granule % 32 == 0 && coherent_used[granule / 32] == 0xffffffff) {
+            run = 0;
+            granule += 31;
+            continue;
+        }
+
+        run = coherent_granule_used(granule) ? 0 : run + 1;
+        if (run == count) {
+            u32_t first = granule + 1 - count;
+            coherent_mark(first, count, true);
+
+            buffer->cpu  = coherent_pool + first * COHERENT_GRANULE;
+            buffer->bus  = coherent_bus_address(buffer->cpu);
+            buffer->size = count * COHERENT_GRANULE;
+            return COHERENT_GOOD;
+        }
+    }
+
+    return COHERENT_NO_MEMORY;
+}
+
+/**
+ * @brief Free a buffer returned by `coherent_alloc`.
+ *
+ * @param buffer The buffer.
+ * @return enum CoherentReturn Return value.
+ */
+enum CoherentReturn coherent_free(const struct coherent_buffer_t* buffer) {
+    if (!coherent_contains(buffer->cpu)) {
+        return COHERENT_BAD_BUFFER;
+    }
+
+    u32_t offset = (u32_t)((u8_t*)buffer->cpu - coherent_pool);
+    if (offset % COHERENT_GRANULE != 0 || offset + buffer->size > MMU_SECTION_SIZE) {
+        return COHERENT_BAD_BUFFER;
+    }
+
+    coherent_mark(offset / COHERENT_GRANULE, buffer->size / COHERENT_GRANULE, false);
+    return COHERENT_GOOD;
+}
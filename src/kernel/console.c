@@ -0,0 +1,206 @@
+/**
+ * @file console.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Formatted console output.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The formatting itself is done by `format_vprint`, which fills the buffer of the file. The file
+ * is written out at most once per call, unless the output overflows its buffer.
+ *
+ * Once boot is done the console runs a small command line on the UART. While it waits for input
+ * it drains the kernel log, so log lines reach the serial port when nothing else is running, and
+ * streams out any trace records after the log.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/console.h"
+#include "common/format.h"
+#include "common/string.h"
+#include "common/types.h"
+#include "drivers/irq.h"
+#include "drivers/uart.h"
+#include "kernel/fs.h"
+#include "kernel/klog.h"
+#include "kernel/trace.h"
+
+/// @brief Longest command line, including its null terminator.
+#define CONSOLE_LINE_SIZE 64
+
+/// @brief The console files, standard output is line buffered and standard error is unbuffered.
+static FILE console_stdout;
+static FILE console_stderr;
+
+/// @brief Where the console output goes, trace frames are written straight to it.
+static file_write_t console_write;
+
+/**
+ * @brief Open standard output and standard error.
+ *
+ * @param write Where the console output goes.
+ */
+void console_init(file_write_t write) {
+    console_write = write;
+    file_init(&console_stdout, 1, write, FILE_LINE_BUFFERED);
+    file_init(&console_stderr, 2, write, FILE_UNBUFFERED);
+    stdout = &console_stdout;
+    stderr = &console_stderr;
+}
+
+static void console_sink(void* context, const char* data, u32_t length) {
+    file_queue(context, data, length);
+}
+
+/**
+ * @brief Write formatted output to a file.
+ *
+ * @param file The file.
+ * @param format The format string, see `format_vprint`.
+ * @param ap The arguments.
+ * @return int The number of characters written, or EOF on error.
+ */
+int vfprintf(FILE* file, const char* format, va_list ap) {
+    if (file == NULL) {
+        return EOF;
+    }
+
+    int written = format_vprint(console_sink, file, format, ap);
+    return file_settle(file) == 0 ? written : EOF;
+}
+
+/**
+ * @brief Write formatted output to a file.
+ *
+ * @param file The file.
+ * @param format The format string, see `format_vprint`.
+ * @return int The number of characters written, or EOF on error.
+ */
+int fprintf(FILE* file, const char* format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    int written = vfprintf(file, format, ap);
+    va_end(ap);
+    return written;
+}
+
+/**
+ * @brief Write formatted output to standard output.
+ *
+ * @param format The format string, see `format_vprint`.
+ * @return int The number of characters written, or EOF on error.
+ */
+int printf(const char* format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    int written = vfprintf(stdout, format, ap);
+    va_end(ap);
+    return written;
+}
+
+/**
+ * @brief Write the kernel log lines that have not been written yet to standard output.
+ */
+void console_drain_log(void) {
+    if (klog_drain(console_sink, stdout)) {
+        fflush(stdout);
+    }
+}
+
+/**
+ * @brief Send the trace records that have not been sent yet, after anything buffered for standard
+ * output so a frame never lands inside a line.
+ */
+void console_stream_trace(void) {
+    if (trace_pending()) {
+        fflush(stdout);
+        trace_stream(console_write);
+    }
+}
+
+/**
+ * @brief Write everything still in the kernel log to standard error, for after a panic.
+ *
+ * Callers with IRQs masked must `uart_flush` afterwards for the whole log to leave the UART.
+ */
+void console_panic_log(void) {
+    fputs("\nKernel panic, replaying the kernel log:\n", stderr);
+    klog_replay(console_sink, stderr);
+    fflush(stderr);
+}
+
+/**
+ * @brief Wait for the next input character, or for an interrupt that may have logged or traced
+ * something.
+ *
+ * @param c Set to the character.
+ * @return bool Whether a character was received.
+ */
+static bool console_wait_input(unsigned char* c) {
+    // Checked with IRQs masked so neither a byte nor a record can slip in before the sleep.
+    u32_t flags   = irq_save();
+    bool received = uart_try_getch(c);
+    if (!received && !klog_pending() && !trace_pending() && !(flags & IRQ_CPSR_MASK)) {
+        __irq_wait();
+    }
+    irq_restore(flags);
+    return received;
+}
+
+/**
+ * @brief Run one command line.
+ *
+ * @param line The null terminated line.
+ */
+static void console_command(const char* line) {
+    if (line[0] == '\0') {
+        return;
+    }
+
+    if (strncmp(line, "dmesg", CONSOLE_LINE_SIZE) == 0) {
+        klog_replay(console_sink, stdout);
+        fflush(stdout);
+    } else if (strncmp(line, "help", CONSOLE_LINE_SIZE) == 0) {
+        printf("dmesg\tshow the kernel log\nhelp\tlist the commands\n");
+    } else {
+        printf("%s: unknown command\n", line);
+    }
+}
+
+/**
+ * @brief Run the console command line, draining the kernel log and the trace ring whenever the
+ * core is idle. Never returns.
+ */
+void console_run(void) {
+    char line[CONSOLE_LINE_SIZE];
+    u32_t length = 0;
+
+    fputs("> ", stdout);
+    fflush(stdout);
+
+    while (true) {
+        console_drain_log();
+        console_stream_trace();
+
+        unsigned char in;
+        if (!console_wait_input(&in)) {
+            continue;
+        }
+
+        if (in == (unsigned char)'\r') {
+            fputs("\r\n", stdout);
+            line[length] = '\0';
+            console_command(line);
+            length = 0;
+            fputs("> ", stdout);
+        } else if (in == 127) { // Backspace
+            if (length) {
+                length--;
+                fputs("\e[1D\e[0J", stdout);
+            }
+        } else if (length < CONSOLE_LINE_SIZE - 1) {
+            line[length++] = (char)in;
+            fputc(in, stdout);
+        }
+        fflush(stdout);
+    }
+}
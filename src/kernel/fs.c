@@ -0,0 +1,163 @@
+/**
+ * @file fs.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Buffered output files.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Writes are gathered in the buffer of the file and handed to its sink in bulk, once the buffer
+ * is full or when the buffering mode of the file asks for it at the end of a call.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/fs.h"
+#include "common/string.h"
+#include "common/types.h"
+
+/// @brief The open files, indexed by file descriptor.
+static FILE* file_table[FILE_MAX_OPEN];
+
+FILE* stdout = NULL;
+FILE* stderr = NULL;
+
+/**
+ * @brief Set up an empty file and make it the open file of its descriptor.
+ *
+ * @param file The file.
+ * @param fd The file descriptor, below FILE_MAX_OPEN.
+ * @param write Sink of the buffer.
+ * @param flags enum FileFlags.
+ */
+void file_init(FILE* file, int fd, file_write_t write, u32_t flags) {
+    file->fd       = fd;
+    file->location = 0;
+    file->write    = write;
+    file->flags    = flags;
+    file->used     = 0;
+    file->newline  = false;
+
+    if (fd >= 0 && fd < FILE_MAX_OPEN) {
+        file_table[fd] = file;
+    }
+}
+
+/**
+ * @brief Get the open file of a descriptor.
+ *
+ * @param fd The file descriptor.
+ * @return FILE* The file, or NULL if nothing is open there.
+ */
+FILE* fopen(int fd) {
+    if (fd < 0 || fd >= FILE_MAX_OPEN) {
+        return NULL;
+    }
+    return file_table[fd];
+}
+
+/**
+ * @brief Write out everything buffered.
+ *
+ * @param file The file.
+ * @return int 0, or EOF if the sink did not take everything.
+ */
+int fflush(FILE* file) {
+    u32_t used    = file->used;
+    file->used    = 0;
+    file->newline = false;
+
+    if (!used) {
+        return 0;
+    }
+
+    u32_t written = file->write(file->buffer, used);
+    file->location += written;
+    return written == used ? 0 : EOF;
+}
+
+/**
+ * @brief Add characters to the buffer, writing it out each time it fills.
+ *
+ * Does not apply the buffering mode, see `file_settle`.
+ *
+ * @param file The file.
+ * @param data The characters.
+ * @param length The number of characters.
+ */
+void file_queue(FILE* file, const char* data, u32_t length) {
+    // Blocks at least as big as the buffer skip it when there is nothing to keep in order.
+    if (!file->used && length >= FILE_BUFFER_SIZE) {
+        file->location += file->write(data, length);
+        return;
+    }
+
+    while (length) {
+        u32_t space = FILE_BUFFER_SIZE - file->used;
+        u32_t chunk = length < space ? length : space;
+
+        for (u32_t i = 0; i < chunk; i++) {
+            file->buffer[file->used + i] = data[i];
+            if (data[i] == '\n') {
+                file->newline = true;
+            }
+        }
+        file->used += chunk;
+        data       += chunk;
+        length     -= chunk;
+
+        if (file->used == FILE_BUFFER_SIZE) {
+            fflush(file);
+        }
+    }
+}
+
+/**
+ * @brief Apply the buffering mode at the end of a call that wrote to the file.
+ *
+ * @param file The file.
+ * @return int 0, or EOF if the buffer was written out and the sink did not take everything.
+ */
+int file_settle(FILE* file) {
+    if ((file->flags & FILE_UNBUFFERED) || ((file->flags & FILE_LINE_BUFFERED) && file->newline)) {
+        return fflush(file);
+    }
+    return 0;
+}
+
+/**
+ * @brief Write a character to a file.
+ *
+ * @param c The character.
+ * @param file The file.
+ * @return int The character, or EOF on error.
+ */
+int fputc(int c, FILE* file) {
+    char character = (char)c;
+    file_queue(file, &character, 1);
+    return file_settle(file) == 0 ? (u8_t)character : EOF;
+}
+
+/**
+ * @brief Write a string to a file, without its null terminator.
+ *
+ * @param string The null terminated string.
+ * @param file The file.
+ * @return int 0, or EOF on error.
+ */
+int fputs(const char* string, FILE* file) {
+    file_queue(file, string, (u32_t)strlen(string));
+    return file_settle(file);
+}
+
+/**
+ * @brief Write `count` items of `size` bytes to a file.
+ *
+ * @param data The items.
+ * @param size Size of each item.
+ * @param count Number of items.
+ * @param file The file.
+ * @return size_t `count`, or 0 on error.
+ */
+size_t fwrite(const void* data, size_t size, size_t count, FILE* file) {
+    file_queue(file, data, (u32_t)(size * count));
+    return file_settle(file) == 0 ? count : 0;
+}
@@ -0,0 +1,369 @@
+/**
+ * @file heap.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Kernel heap implementation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Every slab starts with a header holding a bitmap of its free slots, and a summary word with a
+ * bit set for each bitmap word that still has a free slot. Finding a free slot is two count
+ * leading zeros, and finding the slab of a pointer is a mask, so neither allocation nor free
+ * scans anything.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/heap.h"
+#include "common/types.h"
+#include "kernel/page.h"
+
+/// @brief Order of the page blocks that back each slab.
+#define HEAP_SLAB_ORDER 2
+
+/// @brief Size of a slab in bytes, slabs are aligned to their size.
+#define HEAP_SLAB_SIZE (PAGE_SIZE << HEAP_SLAB_ORDER)
+
+/// @brief Number of bitmap words needed for a slab full of the smallest objects.
+#define HEAP_BITMAP_WORDS (HEAP_SLAB_SIZE / HEAP_ALIGN / 32)
+
+/**
+ * @brief Header at the start of every slab.
+ */
+struct heap_slab_t {
+    struct heap_slab_t* next;        // Next slab in the partial list of the class.
+    struct heap_slab_t* prev;        // Previous slab in the partial list of the class.
+    u16_t class_index;               // Size class of the objects in the slab.
+    u16_t used;                      // Number of live objects.
+    u32_t summary;                   // Bit n is set when bitmap[n] has a free slot.
+    u32_t bitmap[HEAP_BITMAP_WORDS]; // Bit set for every free slot.
+};
+
+/// @brief Offset of the first object in a slab.
+#define HEAP_SLAB_HEADER ((sizeof(struct heap_slab_t) + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1))
+
+/**
+ * @brief Constant description of a size class.
+ *
+ * `reciprocal` is ceil(2^32 / size), so the slot of an offset into the slab is
+ * `(offset * reciprocal) >> 32` without a division. This is exact for every offset in a slab.
+ */
+struct heap_class_t {
+    u32_t size;
+    u32_t count;
+    u32_t reciprocal;
+};
+
+#define HEAP_CLASS(size)                                                                           \
+    {(size), (HEAP_SLAB_SIZE - HEAP_SLAB_HEADER) / (size), 0xffffffffu / (size) + 1}
+
+/**
+ * @brief The size classes.
+ *
+ * Powers of two, with the 1.5x steps in between, until the classes get big enough that the slab
+ * header costs a whole slot. The last three are tuned to fill a slab with at most one slot of
+ * slack instead.
+ */
+static const struct heap_class_t heap_classes[HEAP_CLASSES] = {
+    HEAP_CLASS(16),  HEAP_CLASS(32),   HEAP_CLASS(48),   HEAP_CLASS(64),   HEAP_CLASS(96),
+    HEAP_CLASS(128), HEAP_CLASS(192),  HEAP_CLASS(256),  HEAP_CLASS(384),  HEAP_CLASS(512),
+    HEAP_CLASS(768), HEAP_CLASS(1008), HEAP_CLASS(1344), HEAP_CLASS(2016),
+};
+
+/// @brief Largest object served from a slab.
+#define HEAP_MAX_OBJECT 2016
+
+_Static_assert(HEAP_SLAB_SIZE / HEAP_ALIGN <= 32 * 32, "Slab bitmap summary does not fit a word");
+_Static_assert(HEAP_MAX_OBJECT % HEAP_ALIGN == 0, "Size classes must keep objects aligned");
+
+/**
+ * @brief Mutable state of a size class.
+ */
+struct heap_cache_t {
+    struct heap_slab_t* partial; // Slabs with both live objects and free slots.
+    struct heap_slab_t* empty;   // A slab with no live objects, kept to avoid page churn.
+    struct heap_stats_t stats;
+};
+
+/// @brief State of every size class, and HEAP_LARGE.
+static struct heap_cache_t heap_caches[HEAP_CLASSES + 1];
+
+/// @brief Size class of every multiple of HEAP_ALIGN up to HEAP_MAX_OBJECT.
+static u8_t heap_class_lookup[HEAP_MAX_OBJECT / HEAP_ALIGN + 1];
+
+/// @brief Virtual address of physical address 0.
+static uintptr_t heap_window;
+
+/**
+ * @brief Index of the lowest set bit of a non zero word.
+ */
+static inline u32_t heap_lowest_bit(u32_t word) { return 31 - __builtin_clz(word & -word); }
+
+static inline ptr_t heap_physical(const void* ptr) {
+    return (ptr_t)((uintptr_t)ptr - heap_window);
+}
+
+static inline void* heap_virtual(ptr_t address) { return (void*)(heap_window + address); }
+
+static void heap_list_push(struct heap_slab_t** head, struct heap_slab_t* slab) {
+    slab->prev = NULL;
+    slab->next = *head;
+    if (*head) {
+        (*head)->prev = slab;
+    }
+    *head = slab;
+}
+
+static void heap_list_remove(struct heap_slab_t** head, struct heap_slab_t* slab) {
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        *head = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+}
+
+/**
+ * @brief Take a new slab for a size class from the page allocator, with every slot free.
+ */
+static struct heap_slab_t* heap_new_slab(u32_t class_index) {
+    const struct heap_class_t* class = &heap_classes[class_index];
+    ptr_t address;
+
+    if (page_alloc(HEAP_SLAB_ORDER, &address) != PAGE_GOOD) {
+        return NULL;
+    }
+
+    struct heap_slab_t* slab = heap_virtual(address);
+    slab->class_index        = (u16_t)class_index;
+    slab->used               = 0;
+    slab->summary            = 0;
+
+    for (u32_t word = 0; word < HEAP_BITMAP_WORDS; word++) {
+        u32_t first = word * 32;
+        if (first + 32 <= class->count) {
+            slab->bitmap[word] = 0xffffffff;
+        } else if (first < class->count) {
+            slab->bitmap[word] = (1u << (class->count - first)) - 1;
+        } else {
+            slab->bitmap[word] = 0;
+        }
+
+        if (slab->bitmap[word]) {
+            slab->summary |= 1u << word;
+        }
+    }
+
+    struct heap_stats_t* stats = &heap_caches[class_index].stats;
+    stats->slabs++;
+    stats->capacity += class->count;
+    return slab;
+}
+
+/**
+ * @brief Handle a slab that just lost its last live object.
+ *
+ * One empty slab is cached per class so that an object bouncing between allocated and free does
+ * not take and return pages each time, any further ones go back to the page allocator.
+ */
+static void heap_release_slab(struct heap_cache_t* cache, struct heap_slab_t* slab) {
+    if (!cache->empty) {
+        cache->empty = slab;
+        return;
+    }
+
+    cache->stats.slabs--;
+    cache->stats.capacity -= heap_classes[slab->class_index].count;
+    page_free(heap_physical(slab));
+}
+
+static void heap_count_alloc(struct heap_stats_t* stats, u32_t requested, u32_t allocated) {
+    stats->allocs++;
+    stats->requested_bytes += requested;
+    stats->allocated_bytes += allocated;
+    if (stats->used > stats->peak_used) {
+        stats->peak_used = stats->used;
+    }
+}
+
+/**
+ * @brief Allocate straight from the page allocator.
+ */
+static void* heap_alloc_large(u32_t size) {
+    u32_t order = page_order_for_size(size);
+    ptr_t address;
+
+    if (order > PAGE_MAX_ORDER || page_alloc(order, &address) != PAGE_GOOD) {
+        return NULL;
+    }
+
+    struct heap_stats_t* stats = &heap_caches[HEAP_LARGE].stats;
+    stats->slabs++;
+    stats->capacity += 1u << order;
+    stats->used += 1u << order;
+    heap_count_alloc(stats, size, PAGE_SIZE << order);
+    return heap_virtual(address);
+}
+
+/**
+ * @brief Initialise the kernel heap.
+ *
+ * The page allocator must be initialised first, the heap takes its slabs from it on demand.
+ *
+ * @param window The virtual address that physical address 0 is mapped at, and so the offset from
+ * the page allocator addresses to pointers. 0 while memory is identity mapped.
+ */
+void heap_init(uintptr_t window) {
+    heap_window = window;
+
+    for (u32_t i = 0; i <= HEAP_CLASSES; i++) {
+        heap_caches[i] = (struct heap_cache_t){0};
+        if (i < HEAP_CLASSES) {
+            heap_caches[i].stats.object_size      = heap_classes[i].size;
+            heap_caches[i].stats.objects_per_slab = heap_classes[i].count;
+        }
+    }
+
+    u32_t class_index = 0;
+    for (u32_t slot = 0; slot <= HEAP_MAX_OBJECT / HEAP_ALIGN; slot++) {
+        while (heap_classes[class_index].size < slot * HEAP_ALIGN) {
+            class_index++;
+        }
+        heap_class_lookup[slot] = (u8_t)class_index;
+    }
+}
+
+/**
+ * @brief Allocate kernel memory.
+ *
+ * @param size The number of bytes to allocate.
+ * @return void* The memory, aligned to at least HEAP_ALIGN, or NULL if `size` is 0 or there is no
+ * memory left.
+ */
+void* kmalloc(u32_t size) {
+    if (size == 0) {
+        return NULL;
+    }
+    if (size > HEAP_MAX_OBJECT) {
+        return heap_alloc_large(size);
+    }
+
+    u32_t class_index                = heap_class_lookup[(size + HEAP_ALIGN - 1) / HEAP_ALIGN];
+    const struct heap_class_t* class = &heap_classes[class_index];
+    struct heap_cache_t* cache       = &heap_caches[class_index];
+    struct heap_slab_t* slab         = cache->partial;
+
+    if (!slab) {
+        if (cache->empty) {
+            slab         = cache->empty;
+            cache->empty = NULL;
+        } else if (!(slab = heap_new_slab(class_index))) {
+            return NULL;
+        }
+        heap_list_push(&cache->partial, slab);
+    }
+
+    u32_t word = heap_lowest_bit(slab->summary);
+    u32_t bit  = heap_lowest_bit(slab->bitmap[word]);
+
+    slab->bitmap[word] &= ~(1u << bit);
+    if (!slab->bitmap[word]) {
+        slab->summary &= ~(1u << word);
+    }
+    if (++slab->used == class->count) {
+        heap_list_remove(&cache->partial, slab);
+    }
+
+    cache->stats.used++;
+    heap_count_alloc(&cache->stats, size, class->size);
+    return (u8_t*)slab + HEAP_SLAB_HEADER + (word * 32 + bit) * class->size;
+}
+
+/**
+ * @brief Free memory returned by `kmalloc`.
+ *
+ * @param ptr The memory, NULL is ignored.
+ * @return enum HeapReturn Return value, HEAP_NOT_ALLOCATED on a double free and HEAP_BAD_POINTER
+ * if `ptr` was never returned by `kmalloc`.
+ */
+enum HeapReturn kfree(void* ptr) {
+    if (!ptr) {
+        return HEAP_GOOD;
+    }
+
+    ptr_t address = heap_physical(ptr);
+    u32_t order;
+
+    // Only blocks handed out whole by the page allocator start on an allocated page, slab objects
+    // never do as the slab header sits there.
+    if (page_block_order(address, &order) == PAGE_GOOD) {
+        if (page_free(address) != PAGE_GOOD) {
+            return HEAP_BAD_POINTER;
+        }
+
+        struct heap_stats_t* stats = &heap_caches[HEAP_LARGE].stats;
+        stats->slabs--;
+        stats->capacity -= 1u << order;
+        stats->used -= 1u << order;
+        stats->frees++;
+        return HEAP_GOOD;
+    }
+
+    struct heap_slab_t* slab = heap_virtual(address & ~(HEAP_SLAB_SIZE - 1));
+    u32_t offset             = address & (HEAP_SLAB_SIZE - 1);
+
+    if (offset < HEAP_SLAB_HEADER || slab->class_index >= HEAP_CLASSES) {
+        return HEAP_BAD_POINTER;
+    }
+    offset -= HEAP_SLAB_HEADER;
+
+    const struct heap_class_t* class = &heap_classes[slab->class_index];
+    struct heap_cache_t* cache       = &heap_caches[slab->class_index];
+    u32_t index                      = (u32_t)(((u64_t)offset * class->reciprocal) >> 32);
+
+    if (index >= class->count || index * class->size != offset) {
+        return HEAP_BAD_POINTER;
+    }
+
+    u32_t word = index / 32;
+    u32_t bit  = 1u << (index % 32);
+    if (slab->bitmap[word] & bit) {
+        return HEAP_NOT_ALLOCATED;
+    }
+
+    bool wasFull = slab->used == class->count;
+
+    slab->bitmap[word] |= bit;
+    slab->summary |= 1u << word;
+    slab->used--;
+
+    cache->stats.used--;
+    cache->stats.frees++;
+
+    if (slab->used == 0) {
+        if (!wasFull) {
+            heap_list_remove(&cache->partial, slab);
+        }
+        heap_release_slab(cache, slab);
+    } else if (wasFull) {
+        heap_list_push(&cache->partial, slab);
+    }
+
+    return HEAP_GOOD;
+}
+
+/**
+ * @brief Get the counters of a size class.
+ *
+ * @param index The size class, below HEAP_CLASSES, or HEAP_LARGE.
+ * @param stats Where to copy the counters.
+ * @return enum HeapReturn Return value.
+ */
+enum HeapReturn heap_stats(u32_t index, struct heap_stats_t* stats) {
+    if (index > HEAP_LARGE) {
+        return HEAP_BAD_CLASS;
+    }
+
+    *stats = heap_caches[index].stats;
+    return HEAP_GOOD;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file klog.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Kernel log ring.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * `klog_head` counts records ever claimed and `klog_tail` records ever drained, both wrapping at
+ * 2^32. Only the drain writes `klog_tail`. A reader copies a record and then checks that its
+ * sequence number did not change underneath, so a record overwritten while being copied is
+ * noticed rather than printed torn.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/klog.h"
+#include "common/format.h"
+#include "common/types.h"
+
+#define KLOG_MASK (KLOG_RECORDS - 1)
+
+static struct klog_record_t klog_records[KLOG_RECORDS];
+static u32_t klog_head;
+static u32_t klog_tail;
+static klog_clock_t klog_clock;
+
+static const char* const klog_level_names[] = {"error", "warn", "info", "debug"};
+
+/**
+ * @brief Empty the ring and set where timestamps come from. Must be called before anything logs.
+ *
+ * @param clock The timestamp source, or NULL to log without times.
+ */
+void klog_init(klog_clock_t clock) {
+    for (u32_t i = 0; i < KLOG_RECORDS; i++) {
+        klog_records[i].sequence = 0;
+    }
+    klog_head  = 0;
+    klog_tail  = 0;
+    klog_clock = clock;
+}
+
+/**
+ * @brief Where the message of a record is formatted to.
+ */
+struct klog_message_t {
+    char* buffer;
+    u32_t used;
+};
+
+static void klog_message_sink(void* context, const char* data, u32_t length) {
+    struct klog_message_t* message = context;
+
+    for (u32_t i = 0; i < length && message->used < KLOG_MESSAGE_SIZE - 1; i++) {
+        message->buffer[message->used++] = data[i];
+    }
+}
+
+/**
+ * @brief Append a formatted line to the log. Safe from any context, interrupt handlers included.
+ *
+ * @param level The severity.
+ * @param format The format string, see `format_vprint`, without a trailing newline.
+ * @param ap The arguments.
+ */
+void klog_vwrite(enum KlogLevel level, const char* format, va_list ap) {
+    u32_t index                  = __atomic_fetch_add(&klog_head, 1, __ATOMIC_RELAXED);
+    struct klog_record_t* record = &klog_records[index & KLOG_MASK];
+
+    // Unpublish the slot before its old contents start to be overwritten.
+    __atomic_store_n(&record->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    struct klog_message_t message = {record->message, 0};
+    record->level                 = level;
+    record->time                  = klog_clock ? klog_clock() : 0;
+    format_vprint(klog_message_sink, &message, format, ap);
+    record->message[message.used] = '\0';
+
+    __atomic_store_n(&record->sequence, index + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Append a formatted line to the log. Safe from any context, interrupt handlers included.
+ *
+ * @param level The severity.
+ * @param format The format string, see `format_vprint`, without a trailing newline.
+ */
+void klog(enum KlogLevel level, const char* format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    klog_vwrite(level, format, ap);
+    va_end(ap);
+}
+
+/**
+ * @brief Copy a published record out of the ring.
+ *
+ * @param index Index of the record.
+ * @param copy Where to copy it.
+ * @return bool False if the record is not published yet, or was overwritten by a later one.
+ */
+static bool klog_read(u32_t index, struct klog_record_t* copy) {
+    const struct klog_record_t* record = &klog_records[index & KLOG_MASK];
+
+    if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != index + 1) {
+        return false;
+    }
+
+    copy->level = record->level;
+    copy->time  = record->time;
+    for (u32_t i = 0; i < KLOG_MESSAGE_SIZE; i++) {
+        copy->message[i] = record->message[i];
+    }
+    copy->message[KLOG_MESSAGE_SIZE - 1] = '\0';
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&record->sequence, __ATOMIC_RELAXED) == index + 1;
+}
+
+static void klog_print(format_sink_t sink, void* context, const struct klog_record_t* record) {
+    const char* level = record->level <= KLOG_DEBUG ? klog_level_names[record->level] : "?";
+    format_print(sink, context, "[%10llu] %s: %s\n", record->time, level, record->message);
+}
+
+/**
+ * @brief Whether any record has been written that is not drained yet.
+ */
+bool klog_pending(void) {
+    return __atomic_load_n(&klog_head, __ATOMIC_ACQUIRE) != klog_tail;
+}
+
+/**
+ * @brief Write every published record not drained yet, oldest first. Only one drain can run at a
+ * time, from normal code.
+ *
+ * Stops at the first record that is still being written. Records overwritten before they could be
+ * drained are counted in a line of their own.
+ *
+ * @param sink Receives the formatted lines.
+ * @param context Passed to the sink.
+ * @return u32_t The number of records written.
+ */
+u32_t klog_drain(format_sink_t sink, void* context) {
+    struct klog_record_t record;
+    u32_t written = 0;
+    u32_t lost    = 0;
+
+    while (true) {
+        u32_t head = __atomic_load_n(&klog_head, __ATOMIC_ACQUIRE);
+        if (head - klog_tail > KLOG_RECORDS) {
+            lost      += head - klog_tail - KLOG_RECORDS;
+            klog_tail  = head - KLOG_RECORDS;
+        }
+        if (klog_tail == head) {
+            break;
+        }
+
+        if (!klog_read(klog_tail, &record)) {
+            // Overwritten while it was read, which the next pass counts, or still being written.
+            if (__atomic_load_n(&klog_head, __ATOMIC_ACQUIRE) - klog_tail > KLOG_RECORDS) {
+                continue;
+            }
+            break;
+        }
+
+        if (lost) {
+            format_print(sink, context, "klog: %u lines lost\n", lost);
+            lost = 0;
+        }
+        klog_print(sink, context, &record);
+        klog_tail++;
+        written++;
+    }
+
+    if (lost) {
+        format_print(sink, context, "klog: %u lines lost\n", lost);
+    }
+    return written;
+}
+
+/**
+ * @brief Write every record still in the ring, drained or not, oldest first. Does not change what
+ * `klog_drain` writes next.
+ *
+ * @param sink Receives the formatted lines.
+ * @param context Passed to the sink.
+ */
+void klog_replay(format_sink_t sink, void* context) {
+    struct klog_record_t record;
+    u32_t head  = __atomic_load_n(&klog_head, __ATOMIC_ACQUIRE);
+    u32_t index = head > KLOG_RECORDS ? head - KLOG_RECORDS : 0;
+
+    for (; index != head; index++) {
+        if (klog_read(index, &record)) {
+            klog_print(sink, context, &record);
+        }
+    }
+}
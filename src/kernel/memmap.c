@@ -0,0 +1,199 @@
+/**
+ * @file memmap.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Building and searching the memory map, without touching the hardware.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * `mm_init` gathers the regions from the firmware, the kernel image and the device tree, and this
+ * file merges them into one sorted map, so the same code runs in the host test suite.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/mm.h"
+#include "common/types.h"
+
+/**
+ * @brief Maximum number of memory segments in the memory map.
+ */
+#define MM_MAX_SEGMENTS 32
+
+/**
+ * @brief Maximum number of regions that the memory map is built from.
+ */
+#define MM_MAX_SOURCES 32
+
+/**
+ * @brief A region reported by one of the sources of the memory map, [start, end).
+ */
+struct mm_source_t {
+    u64_t start;
+    u64_t end;
+    enum MemoryOwnership owner;
+};
+
+/**
+ * @brief The memory map, sorted by base address with no overlaps and no two adjacent segments of
+ * the same owner.
+ *
+ * The size of this array means that this OS only supports a maximum of 32 different memory
+ * segments.
+ */
+static struct MemorySegment available_memory[MM_MAX_SEGMENTS];
+
+/// @brief Number of entries in `available_memory`.
+static u32_t segment_count;
+
+/// @brief The regions that the memory map is built from, in the order they were reported.
+static struct mm_source_t sources[MM_MAX_SOURCES];
+
+/// @brief Number of entries in `sources`.
+static u32_t source_count;
+
+/**
+ * @brief Forget every region and empty the memory map.
+ */
+void mm_map_reset(void) {
+    segment_count = 0;
+    source_count  = 0;
+}
+
+/**
+ * @brief Record a region for the memory map, which takes effect on the next `mm_map_build`.
+ *
+ * @param base The physical address of the region.
+ * @param size The size of the region in bytes.
+ * @param owner The owner of the region.
+ * @return enum MemoryMapReturn MM_TOO_MANY_SEGMENTS if there is no room for another region.
+ */
+enum MemoryMapReturn mm_map_add(u64_t base, u64_t size, enum MemoryOwnership owner) {
+    if (source_count >= MM_MAX_SOURCES) {
+        return MM_TOO_MANY_SEGMENTS;
+    }
+
+    // Everything past the 32 bit physical address space is unreachable, so it is dropped.
+    if (size == 0 || base > 0xffffffff) {
+        return MM_GOOD;
+    }
+    if (base + size > 0x100000000) {
+        size = 0x100000000 - base;
+    }
+
+    sources[source_count].start = base;
+    sources[source_count].end   = base + size;
+    sources[source_count].owner = owner;
+    source_count++;
+    return MM_GOOD;
+}
+
+/**
+ * @brief Insert a boundary into a sorted array of unique boundaries.
+ */
+static void mm_insert_bound(u64_t* bounds, u32_t* count, u64_t bound) {
+    u32_t i = *count;
+    while (i > 0 && bounds[i - 1] > bound) {
+        i--;
+    }
+    if (i > 0 && bounds[i - 1] == bound) {
+        return;
+    }
+
+    for (u32_t j = *count; j > i; j--) {
+        bounds[j] = bounds[j - 1];
+    }
+    bounds[i] = bound;
+    (*count)++;
+}
+
+/**
+ * @brief Rebuild the memory map from the regions.
+ *
+ * Every boundary of every region splits the address space into pieces that each region either
+ * covers entirely or not at all. Each piece goes to the highest priority owner that covers it,
+ * and neighbouring pieces with the same owner are merged.
+ *
+ * @return enum MemoryMapReturn MM_TOO_MANY_SEGMENTS if the map does not fit.
+ */
+enum MemoryMapReturn mm_map_build(void) {
+    u64_t bounds[MM_MAX_SOURCES * 2];
+    u32_t boundCount = 0;
+
+    for (u32_t i = 0; i < source_count; i++) {
+        mm_insert_bound(bounds, &boundCount, sources[i].start);
+        mm_insert_bound(bounds, &boundCount, sources[i].end);
+    }
+
+    segment_count = 0;
+    for (u32_t i = 0; i + 1 < boundCount; i++) {
+        enum MemoryOwnership owner = UNOWNED;
+
+        for (u32_t j = 0; j < source_count; j++) {
+            if (sources[j].start <= bounds[i] && sources[j].end >= bounds[i + 1] &&
+                (owner == UNOWNED || sources[j].owner > owner)) {
+                owner = sources[j].owner;
+            }
+        }
+        if (owner == UNOWNED) {
+            continue;
+        }
+
+        if (segment_count > 0) {
+            struct MemorySegment* last = &available_memory[segment_count - 1];
+            if (last->owner == owner && last->base + last->size == bounds[i]) {
+                last->size += (u32_t)(bounds[i + 1] - bounds[i]);
+                continue;
+            }
+        }
+
+        if (segment_count >= MM_MAX_SEGMENTS) {
+            return MM_TOO_MANY_SEGMENTS;
+        }
+        available_memory[segment_count].base  = (u32_t)bounds[i];
+        available_memory[segment_count].size  = (u32_t)(bounds[i + 1] - bounds[i]);
+        available_memory[segment_count].owner = owner;
+        segment_count++;
+    }
+
+    return MM_GOOD;
+}
+
+/**
+ * @brief Find the owner of a physical address.
+ *
+ * A binary search of the memory map, so O(log n) in the number of segments.
+ *
+ * @param address The physical address.
+ * @return enum MemoryOwnership The owner, UNOWNED if the address is not in the memory map.
+ */
+enum MemoryOwnership mm_owner_of(ptr_t address) {
+    u32_t low  = 0;
+    u32_t high = segment_count;
+
+    // Find the first segment that starts after the address, the one before it is the candidate.
+    while (low < high) {
+        u32_t mid = (low + high) >> 1;
+        if (available_memory[mid].base <= address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low == 0) {
+        return UNOWNED;
+    }
+
+    const struct MemorySegment* segment = &available_memory[low - 1];
+    return address - segment->base < segment->size ? segment->owner : UNOWNED;
+}
+
+/**
+ * @brief Get the memory map.
+ *
+ * @param count Where to write the number of segments.
+ * @return const struct MemorySegment* The segments, sorted by base address and not overlapping.
+ */
+const struct MemorySegment* mm_memory_map(u32_t* count) {
+    *count = segment_count;
+    return available_memory;
+}
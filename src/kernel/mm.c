@@ -1,68 +1,197 @@
 #include "kernel/mm.h"
 #include "common/common.h"
 #include "common/types.h"
-#include "drivers/mbox.h"
 #include "drivers/dt.h"
+#include "drivers/firmware.h"
+#include "kernel/arena.h"
+#include "kernel/coherent.h"
+#include "kernel/heap.h"
+#include "kernel/page.h"
 
-enum MemoryOwnership {
-    ARM      = 0,
-    VC       = 1,
-    RESERVED = 2,
-    MMIO     = 3
-};
+/// @brief Start of the kernel image, from linker.ld.
+extern u8_t __start[];
 
-struct MemorySegment {
-    u32_t base;
-    u32_t size;
-    enum MemoryOwnership owner;
-};
+/// @brief End of the kernel image, including the bss, from linker.ld.
+extern u8_t __end[];
 
 /**
- * @brief Array of available memory segments.
- * 
- * The size of this array means that this OS only supports a maximum of 32 different memory segments.
+ * @brief Add every region that the device tree says is in use to the memory map: the blob itself,
+ * the memory reservation block and the static regions under /reserved-memory.
+ */
+static enum MemoryMapReturn mm_reserve_device_tree(void) {
+    enum MemoryMapReturn status;
+    ptr_t blobBase;
+    u32_t blobSize;
+    u64_t address;
+    u64_t size;
+
+    if (dt_blob_region(&blobBase, &blobSize) != DT_GOOD) {
+        return MM_BAD_DEVICE_TREE;
+    }
+    if ((status = mm_map_add(blobBase, blobSize, RESERVED)) != MM_GOOD) {
+        return status;
+    }
+
+    for (u32_t i = 0; dt_memreserve(i, &address, &size) == DT_GOOD; i++) {
+        if ((status = mm_map_add(address, size, RESERVED)) != MM_GOOD) {
+            return status;
+        }
+    }
+
+    struct dt_node_iter_t node;
+    if (dt_get_node_by_path("/reserved-memory", &node) != DT_GOOD) {
+        // The node is optional.
+        return MM_GOOD;
+    }
+    if (dt_iter_first_child(&node) != DT_GOOD) {
+        return MM_GOOD;
+    }
+
+    // Children with only a `size` are allocated dynamically by linux, and have no fixed location.
+    do {
+        for (u32_t i = 0; dt_iter_reg_address(&node, i, &address, &size) == DT_GOOD; i++) {
+            if ((status = mm_map_add(address, size, RESERVED)) != MM_GOOD) {
+                return status;
+            }
+        }
+    } while (dt_iter_next_sibling(&node) == DT_GOOD);
+
+    return MM_GOOD;
+}
+
+/**
+ * @brief Add the windows that the SoC maps its peripherals through to the memory map, from the
+ * `ranges` of /soc.
+ */
+static enum MemoryMapReturn mm_reserve_peripherals(void) {
+    struct dt_range_t ranges[4];
+    struct dt_node_iter_t soc;
+    enum MemoryMapReturn status;
+    u32_t count;
+
+    if (dt_get_node_by_path("/soc", &soc) != DT_GOOD ||
+        dt_iter_decode_ranges(&soc, ranges, 4, &count) != DT_GOOD) {
+        // Without a /soc bus there are no peripheral windows to map.
+        return MM_GOOD;
+    }
+
+    for (u32_t i = 0; i < count && i < 4; i++) {
+        if ((status = mm_map_add(ranges[i].parent, ranges[i].size, MMIO)) != MM_GOOD) {
+            return status;
+        }
+    }
+
+    return MM_GOOD;
+}
+
+/**
+ * @brief Seed the page allocator with every ARM owned segment of the memory map.
+ *
+ * The page metadata is carved out of the first ARM segment large enough to hold it, and is then
+ * reserved in the map itself.
  */
-struct MemorySegment available_memory[32];
+static enum MemoryMapReturn mm_init_pages(u32_t armBase, u32_t armSize) {
+    const struct MemorySegment* segments;
+    enum MemoryMapReturn status;
+    u32_t count;
+
+    u32_t metadataSize = page_metadata_size(armBase, armSize);
+    metadataSize       = (metadataSize + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    u32_t metadata     = 0;
+    bool found         = false;
+
+    segments = mm_memory_map(&count);
+    for (u32_t i = 0; i < count && !found; i++) {
+        u32_t start = (segments[i].base + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        u32_t end   = segments[i].base + segments[i].size;
+
+        if (segments[i].owner == ARM && start < end && end - start >= metadataSize) {
+            metadata = start;
+            found    = true;
+        }
+    }
+    if (!found) {
+        return MM_NO_MEMORY;
+    }
+
+    page_init(armBase, armSize, (struct page_t*)(uintptr_t)metadata);
+
+    if ((status = mm_map_add(metadata, metadataSize, RESERVED)) != MM_GOOD ||
+        (status = mm_map_build()) != MM_GOOD) {
+        return status;
+    }
+
+    segments = mm_memory_map(&count);
+    for (u32_t i = 0; i < count; i++) {
+        if (segments[i].owner == ARM) {
+            page_add_free_range(segments[i].base, segments[i].base + segments[i].size);
+        }
+    }
+
+    return MM_GOOD;
+}
 
 /**
- * @brief Initialise the kernel memory map.
+ * @brief Initialise the kernel memory map and the page allocator.
  *
- * This function reads the dtb to discover all free memory segments.
+ * The ARM and VideoCore memory come from the mailbox, the regions that are already in use come
+ * from the kernel image and the device tree, and the peripheral windows from the /soc bus. They
+ * are merged into one sorted map, and all of the memory left to the ARM is handed to the page
+ * allocator, which backs the kernel heap and the coherent pool.
  * 
- * Requires the dtb driver to be initialised.
+ * Requires the dtb driver and the firmware properties to be initialised.
  *
- * @param dtb Pointer to the flattened device tree.
  * @return int Memory Map return
  */
 enum MemoryMapReturn mm_init() { 
-    struct MailboxMemoryIterator iter;
+    enum MemoryMapReturn status;
 
-    // Get the arm memory base and size
-    mailbox_mem_iter_init(&iter, true);
+    mm_map_reset();
 
-    if (mailbox_mem_iter_next(&iter) != MBOX_GOOD) {
+    struct FirmwareMemory arm = firmware_arm_memory();
+    struct FirmwareMemory vc  = firmware_vc_memory();
+    if (arm.size == 0 || mm_region_wraps(arm.base, arm.size) ||
+        mm_region_wraps(vc.base, vc.size)) {
         return MM_FAILED_INIT;
     }
 
-    u32_t arm_base = iter.base;
-    u32_t arm_size = iter.size;
+    u32_t arm_base = arm.base;
+    u32_t arm_size = arm.size;
+
+    if ((status = mm_map_add(arm_base, arm_size, ARM)) != MM_GOOD ||
+        (status = mm_map_add(vc.base, vc.size, VC)) != MM_GOOD) {
+        return status;
+    }
 
-    // Get the vc memory base and size
-    mailbox_mem_iter_init(&iter, false);
-    if (mailbox_mem_iter_next(&iter) != MBOX_GOOD) {
+    // The kernel image, and below it the boot stack, the ATAGs and the exception vectors. Above it
+    // everything allocated from the boot arena, which is retired here so that the rest of it goes
+    // to the page allocator.
+    ptr_t imageEnd = (ptr_t)(uintptr_t)arena_retire();
+    if (imageEnd < (ptr_t)(uintptr_t)__end) {
+        imageEnd = (ptr_t)(uintptr_t)__end;
+    }
+    if (imageEnd < arm_base) {
         return MM_FAILED_INIT;
     }
+    if ((status = mm_map_add(arm_base, imageEnd - arm_base, RESERVED)) != MM_GOOD) {
+        return status;
+    }
 
-    u32_t vc_base = iter.base;
-    u32_t vc_size = iter.size;
+    // Get reserved memory and the peripherals from the dtb
+    if ((status = mm_reserve_device_tree()) != MM_GOOD ||
+        (status = mm_reserve_peripherals()) != MM_GOOD || (status = mm_map_build()) != MM_GOOD) {
+        return status;
+    }
 
-    // Get reserved memory from the dtb
-    struct DeviceTreeNode* node = dt_get_node_by_path("/reserved-memory");
-    if (node == NULL) {
-        return MM_FAILED_INIT;
+    if ((status = mm_init_pages(arm_base, arm_size)) != MM_GOOD) {
+        return status;
     }
 
-    // node.
+    // Memory is identity mapped.
+    heap_init(0);
 
+    if (coherent_init() != COHERENT_GOOD) {
+        return MM_NO_MEMORY;
+    }
     return MM_GOOD;
-}
\ No newline at end of file
+}
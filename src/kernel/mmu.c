@@ -0,0 +1,193 @@
+/**
+ * @file mmu.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Memory management unit and L1 cache control implementation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * `mmu_init` runs from start.S before any C code, so it must not touch anything but its own
+ * translation table and the CP15 registers.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/mmu.h"
+#include "common/types.h"
+
+/// @brief Number of entries in the first level translation table, one per 1MiB section.
+#define MMU_TABLE_ENTRIES 4096
+
+/**
+ * @brief First level section descriptor bits, in the ARMv6 format with subpages disabled.
+ */
+enum MmuSectionBits {
+    MMU_SECTION       = 0x2,     // Descriptor type, a 1MiB section.
+    MMU_BUFFERABLE    = 1 << 2,  // B.
+    MMU_CACHEABLE     = 1 << 3,  // C.
+    MMU_EXECUTE_NEVER = 1 << 4,  // XN.
+    MMU_AP_KERNEL_RW  = 1 << 10, // AP = 0b01, APX = 0: kernel read write, no user access.
+    MMU_TEX_NORMAL    = 1 << 12, // TEX = 0b001, with C and B clear: normal uncached memory.
+};
+
+/// @brief Normal memory, inner and outer write-back without write allocate (TEX 0, C 1, B 1).
+#define MMU_NORMAL_WRITE_BACK (MMU_SECTION | MMU_AP_KERNEL_RW | MMU_CACHEABLE | MMU_BUFFERABLE)
+
+/// @brief Normal memory that is never cached (TEX 1, C 0, B 0).
+#define MMU_NORMAL_UNCACHED (MMU_SECTION | MMU_AP_KERNEL_RW | MMU_TEX_NORMAL)
+
+/// @brief Shared device memory (TEX 0, C 0, B 1), accesses stay in order and are never cached.
+#define MMU_DEVICE (MMU_SECTION | MMU_AP_KERNEL_RW | MMU_BUFFERABLE | MMU_EXECUTE_NEVER)
+
+/**
+ * @brief Control register (SCTLR) bits.
+ */
+enum MmuControlBits {
+    MMU_CONTROL_MMU               = 1 << 0,  // M.
+    MMU_CONTROL_DCACHE            = 1 << 2,  // C.
+    MMU_CONTROL_BRANCH_PREDICTION = 1 << 11, // Z.
+    MMU_CONTROL_ICACHE            = 1 << 12, // I.
+    MMU_CONTROL_EXTENDED_PAGES    = 1 << 23, // XP, ARMv6 descriptors with subpages disabled.
+};
+
+/// @brief Every cache control bit.
+#define MMU_CONTROL_CACHES (MMU_CONTROL_DCACHE | MMU_CONTROL_ICACHE | MMU_CONTROL_BRANCH_PREDICTION)
+
+/// @brief Table walks are inner cacheable (C) and outer write-back without write allocate (RGN).
+#define MMU_TTBR_WALK_CACHEABLE 0x19
+
+/// @brief Domain 0 is a client, so the access permissions of every section are checked.
+#define MMU_DOMAIN_CLIENT 0x1
+
+/// @brief The first level translation table, which must be aligned to its size.
+static u32_t mmu_table[MMU_TABLE_ENTRIES] __attribute__((aligned(16384)));
+
+static inline u32_t mmu_read_control(void) {
+    u32_t control;
+    asm volatile("mrc p15, 0, %0, c1, c0, 0" : "=r"(control));
+    return control;
+}
+
+static inline void mmu_write_control(u32_t control) {
+    asm volatile("mcr p15, 0, %0, c1, c0, 0" : : "r"(control) : "memory");
+    // Flush the prefetch buffer, so nothing fetched under the old settings runs.
+    asm volatile("mcr p15, 0, %0, c7, c5, 4" : : "r"(0) : "memory");
+}
+
+/**
+ * @brief Invalidate the whole instruction cache.
+ *
+ * On the ARM1176 a single invalidate while the instruction cache is on can leave stale lines
+ * behind (erratum 411920). The workaround from ARM, as used by Linux, is four invalidates back to
+ * back with interrupts masked, followed by at least 11 NOPs.
+ */
+static inline void mmu_invalidate_icache(void) {
+    u32_t flags;
+    asm volatile("mrs %0, cpsr\n\t"
+                 "cpsid ifa\n\t"
+                 "mcr p15, 0, %1, c7, c5, 0\n\t"
+                 "mcr p15, 0, %1, c7, c5, 0\n\t"
+                 "mcr p15, 0, %1, c7, c5, 0\n\t"
+                 "mcr p15, 0, %1, c7, c5, 0\n\t"
+                 "msr cpsr_cx, %0\n\t"
+                 ".rept 11\n\t"
+                 "nop\n\t"
+                 ".endr"
+                 : "=&r"(flags)
+                 : "r"(0)
+                 : "memory");
+}
+
+/**
+ * @brief Clean and invalidate the whole data cache, invalidate the instruction cache and the
+ * branch target cache, and wait for it all to finish.
+ */
+static inline void mmu_flush_caches(void) {
+    asm volatile("mcr p15, 0, %0, c7, c14, 0" : : "r"(0) : "memory");
+    mmu_invalidate_icache();
+    asm volatile("mcr p15, 0, %0, c7, c5, 6" : : "r"(0) : "memory");
+    asm volatile("mcr p15, 0, %0, c7, c10, 4" : : "r"(0) : "memory");
+}
+
+/**
+ * @brief Build the identity mapped translation table and turn on the MMU, the L1 caches and
+ * branch prediction.
+ *
+ * RAM below MMU_RAM_END is normal write-back memory, the peripheral window is device memory, and
+ * every other section faults.
+ */
+void mmu_init(void) {
+    for (u32_t section = 0; section < MMU_TABLE_ENTRIES; section++) {
+        u32_t base = section << MMU_SECTION_SHIFT;
+
+        if (base < MMU_RAM_END) {
+            mmu_table[section] = base | MMU_NORMAL_WRITE_BACK;
+        } else if (base >= MMU_PERIPHERAL_BASE && base < MMU_PERIPHERAL_END) {
+            mmu_table[section] = base | MMU_DEVICE;
+        } else {
+            mmu_table[section] = 0;
+        }
+    }
+
+    // Nothing is cached yet, but the caches are not guaranteed to be empty out of reset.
+    asm volatile("mcr p15, 0, %0, c7, c7, 0" : : "r"(0) : "memory");
+    asm volatile("mcr p15, 0, %0, c8, c7, 0" : : "r"(0) : "memory");
+    asm volatile("mcr p15, 0, %0, c7, c10, 4" : : "r"(0) : "memory");
+
+    // Use TTBR0 for the whole address space.
+    asm volatile("mcr p15, 0, %0, c2, c0, 2" : : "r"(0));
+    asm volatile("mcr p15, 0, %0, c2, c0, 0"
+                 :
+                 : "r"((u32_t)(uintptr_t)mmu_table | MMU_TTBR_WALK_CACHEABLE));
+    asm volatile("mcr p15, 0, %0, c3, c0, 0" : : "r"(MMU_DOMAIN_CLIENT));
+
+    mmu_write_control(mmu_read_control() | MMU_CONTROL_EXTENDED_PAGES | MMU_CONTROL_MMU |
+                      MMU_CONTROL_CACHES);
+}
+
+/**
+ * @brief Turn the L1 caches and branch prediction on or off, leaving the MMU on.
+ *
+ * The caches are cleaned and invalidated first either way, so memory is always up to date.
+ *
+ * @param enable Whether the caches should be on.
+ */
+void mmu_set_caches(bool enable) {
+    u32_t control = mmu_read_control();
+
+    mmu_flush_caches();
+    mmu_write_control(enable ? control | MMU_CONTROL_CACHES : control & ~MMU_CONTROL_CACHES);
+}
+
+/**
+ * @brief Change how the 1MiB section holding an address is accessed.
+ *
+ * The caller must clean and invalidate the section from the data cache before making it uncached
+ * or device memory, as cached lines of memory that is no longer cacheable are never written back.
+ *
+ * @param address Any address in the section.
+ * @param type How the section should be accessed.
+ */
+void mmu_set_section(ptr_t address, enum MmuMemoryType type) {
+    u32_t section = address >> MMU_SECTION_SHIFT;
+    u32_t base    = section << MMU_SECTION_SHIFT;
+
+    switch (type) {
+    case MMU_MEMORY_NORMAL:
+        mmu_table[section] = base | MMU_NORMAL_WRITE_BACK;
+        break;
+    case MMU_MEMORY_UNCACHED:
+        mmu_table[section] = base | MMU_NORMAL_UNCACHED;
+        break;
+    case MMU_MEMORY_DEVICE:
+        mmu_table[section] = base | MMU_DEVICE;
+        break;
+    }
+
+    // Table walks go through the data cache, so write the entry out before dropping the old one
+    // from the TLB.
+    asm volatile("mcr p15, 0, %0, c7, c10, 1" : : "r"(&mmu_table[section]) : "memory");
+    asm volatile("mcr p15, 0, %0, c7, c10, 4" : : "r"(0) : "memory");
+    asm volatile("mcr p15, 0, %0, c8, c7, 1" : : "r"(base) : "memory");
+    asm volatile("mcr p15, 0, %0, c7, c5, 6" : : "r"(0) : "memory");
+    asm volatile("mcr p15, 0, %0, c7, c10, 4" : : "r"(0) : "memory");
+    asm volatile("mcr p15, 0, %0, c7, c5, 4" : : "r"(0) : "memory");
+}
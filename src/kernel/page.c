@@ -0,0 +1,293 @@
+/**
+ * @file page.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Physical page frame allocator implementation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/page.h"
+#include "common/types.h"
+
+/**
+ * @brief Sentinel frame number for the end of a free list.
+ */
+#define PAGE_NONE 0xffffffff
+
+/**
+ * @brief The page heads a free block, which is linked into the free list of its order.
+ */
+#define PAGE_FLAG_FREE 0x1
+
+/**
+ * @brief The page heads a block that has been handed out by `page_alloc`.
+ */
+#define PAGE_FLAG_ALLOCATED 0x2
+
+/**
+ * @brief Number of pages in a block of `order`.
+ */
+#define PAGE_ORDER_PAGES(order) (1u << (order))
+
+/**
+ * @brief Alignment of the managed region, so that buddies of the largest order are aligned to
+ * their size in physical memory too.
+ */
+#define PAGE_BASE_ALIGN (PAGE_SIZE << PAGE_MAX_ORDER)
+
+/// @brief Metadata for every managed page frame, indexed by frame number.
+static struct page_t* pages;
+
+/// @brief Physical address of frame 0.
+static ptr_t page_base;
+
+/// @brief Number of managed page frames.
+static u32_t page_count;
+
+/// @brief Head of the free list of each order.
+static u32_t free_heads[PAGE_ORDERS];
+
+/// @brief Number of free blocks of each order.
+static u32_t free_counts[PAGE_ORDERS];
+
+static void page_list_push(u32_t frame, u32_t order) {
+    struct page_t* page = &pages[frame];
+    page->order         = (u8_t)order;
+    page->flags         = PAGE_FLAG_FREE;
+    page->prev          = PAGE_NONE;
+    page->next          = free_heads[order];
+
+    if (free_heads[order] != PAGE_NONE) {
+        pages[free_heads[order]].prev = frame;
+    }
+    free_heads[order] = frame;
+    free_counts[order]++;
+}
+
+static void page_list_remove(u32_t frame) {
+    struct page_t* page = &pages[frame];
+
+    if (page->prev != PAGE_NONE) {
+        pages[page->prev].next = page->next;
+    } else {
+        free_heads[page->order] = page->next;
+    }
+    if (page->next != PAGE_NONE) {
+        pages[page->next].prev = page->prev;
+    }
+
+    free_counts[page->order]--;
+    page->flags = 0;
+}
+
+/**
+ * @brief Return a block to the free lists, merging it with its buddy for as long as the buddy is
+ * also entirely free.
+ */
+static void page_free_block(u32_t frame, u32_t order) {
+    while (order < PAGE_MAX_ORDER) {
+        u32_t buddy = frame ^ PAGE_ORDER_PAGES(order);
+
+        if (buddy >= page_count || !(pages[buddy].flags & PAGE_FLAG_FREE) ||
+            pages[buddy].order != order) {
+            break;
+        }
+
+        page_list_remove(buddy);
+        frame = frame < buddy ? frame : buddy;
+        order++;
+    }
+
+    page_list_push(frame, order);
+}
+
+/**
+ * @brief Convert a physical address into a frame number.
+ *
+ * @return u32_t The frame, PAGE_NONE if the address is not a managed page boundary.
+ */
+static u32_t page_frame(ptr_t address) {
+    if (address < page_base || (address - page_base) % PAGE_SIZE != 0) {
+        return PAGE_NONE;
+    }
+
+    u32_t frame = (address - page_base) >> PAGE_SHIFT;
+    return frame < page_count ? frame : PAGE_NONE;
+}
+
+/**
+ * @brief Get the number of bytes of metadata needed to manage a region of physical memory.
+ *
+ * @param base The physical address of the start of the region.
+ * @param size The size of the region in bytes.
+ * @return u32_t The size of the metadata in bytes.
+ */
+u32_t page_metadata_size(ptr_t base, u32_t size) {
+    u32_t frames = (base % PAGE_BASE_ALIGN + size) >> PAGE_SHIFT;
+    return frames * sizeof(struct page_t);
+}
+
+/**
+ * @brief Initialise the page allocator to manage a region of physical memory.
+ *
+ * Every page starts out unavailable, and is only handed out once it has been added with
+ * `page_add_free_range`.
+ *
+ * @param base The physical address of the start of the region.
+ * @param size The size of the region in bytes.
+ * @param metadata Storage for the page metadata, of at least `page_metadata_size(base, size)`
+ * bytes.
+ */
+void page_init(ptr_t base, u32_t size, struct page_t* metadata) {
+    pages      = metadata;
+    page_base  = base - base % PAGE_BASE_ALIGN;
+    page_count = (base % PAGE_BASE_ALIGN + size) >> PAGE_SHIFT;
+
+    for (u32_t frame = 0; frame < page_count; frame++) {
+        pages[frame].flags = 0;
+        pages[frame].order = 0;
+    }
+
+    for (u32_t order = 0; order < PAGE_ORDERS; order++) {
+        free_heads[order]  = PAGE_NONE;
+        free_counts[order] = 0;
+    }
+}
+
+/**
+ * @brief Make every whole page in [start, end) available for allocation.
+ *
+ * The range is carved into the largest naturally aligned blocks that fit, and each is merged with
+ * any free neighbours. Pages outside of the managed region are ignored.
+ *
+ * @param start The physical address of the start of the range.
+ * @param end The physical address one past the end of the range.
+ */
+void page_add_free_range(ptr_t start, ptr_t end) {
+    ptr_t limit = page_base + page_count * PAGE_SIZE;
+
+    start = start < page_base ? page_base : start;
+    end   = end > limit ? limit : end;
+    if (start >= end) {
+        return;
+    }
+
+    u32_t frame = (start - page_base + PAGE_SIZE - 1) >> PAGE_SHIFT;
+    u32_t last  = (end - page_base) >> PAGE_SHIFT;
+
+    while (frame < last) {
+        u32_t order = PAGE_MAX_ORDER;
+        while (frame % PAGE_ORDER_PAGES(order) != 0 || frame + PAGE_ORDER_PAGES(order) > last) {
+            order--;
+        }
+
+        page_free_block(frame, order);
+        frame += PAGE_ORDER_PAGES(order);
+    }
+}
+
+/**
+ * @brief Allocate a block of physically contiguous pages.
+ *
+ * @param order The order of the block, which is `PAGE_SIZE << order` bytes.
+ * @param address Where to write the physical address of the block, aligned to its size.
+ * @return enum PageReturn Return value.
+ */
+enum PageReturn page_alloc(u32_t order, ptr_t* address) {
+    if (order > PAGE_MAX_ORDER) {
+        return PAGE_BAD_ORDER;
+    }
+
+    u32_t found = order;
+    while (found <= PAGE_MAX_ORDER && free_heads[found] == PAGE_NONE) {
+        found++;
+    }
+    if (found > PAGE_MAX_ORDER) {
+        return PAGE_NO_MEMORY;
+    }
+
+    u32_t frame = free_heads[found];
+    page_list_remove(frame);
+
+    // Split the block, returning the upper half to the free lists each time.
+    while (found > order) {
+        found--;
+        page_list_push(frame + PAGE_ORDER_PAGES(found), found);
+    }
+
+    pages[frame].order = (u8_t)order;
+    pages[frame].flags = PAGE_FLAG_ALLOCATED;
+
+    *address = page_base + (frame << PAGE_SHIFT);
+    return PAGE_GOOD;
+}
+
+/**
+ * @brief Free a block returned by `page_alloc`.
+ *
+ * @param address The physical address of the block.
+ * @return enum PageReturn Return value, PAGE_NOT_ALLOCATED if the block is not allocated.
+ */
+enum PageReturn page_free(ptr_t address) {
+    u32_t frame = page_frame(address);
+    if (frame == PAGE_NONE) {
+        return PAGE_BAD_ADDRESS;
+    }
+    if (!(pages[frame].flags & PAGE_FLAG_ALLOCATED)) {
+        return PAGE_NOT_ALLOCATED;
+    }
+
+    pages[frame].flags = 0;
+    page_free_block(frame, pages[frame].order);
+    return PAGE_GOOD;
+}
+
+/**
+ * @brief Get the order of an allocated block.
+ *
+ * @param address The physical address of the block.
+ * @param order Where to write the order of the block.
+ * @return enum PageReturn Return value, PAGE_NOT_ALLOCATED if the block is not allocated.
+ */
+enum PageReturn page_block_order(ptr_t address, u32_t* order) {
+    u32_t frame = page_frame(address);
+    if (frame == PAGE_NONE) {
+        return PAGE_BAD_ADDRESS;
+    }
+    if (!(pages[frame].flags & PAGE_FLAG_ALLOCATED)) {
+        return PAGE_NOT_ALLOCATED;
+    }
+
+    *order = pages[frame].order;
+    return PAGE_GOOD;
+}
+
+/**
+ * @brief Get the smallest order of block that holds `size` bytes.
+ *
+ * @return u32_t The order, greater than PAGE_MAX_ORDER if no block is large enough.
+ */
+u32_t page_order_for_size(u32_t size) {
+    u32_t order = 0;
+    while (order <= PAGE_MAX_ORDER && (u32_t)(PAGE_SIZE << order) < size) {
+        order++;
+    }
+    return order;
+}
+
+/**
+ * @brief Get the number of free blocks of an order.
+ */
+u32_t page_free_count(u32_t order) { return order <= PAGE_MAX_ORDER ? free_counts[order] : 0; }
+
+/**
+ * @brief Get the total number of free pages, across all orders.
+ */
+u32_t page_free_pages(void) {
+    u32_t total = 0;
+    for (u32_t order = 0; order <= PAGE_MAX_ORDER; order++) {
+        total += free_counts[order] << order;
+    }
+    return total;
+}
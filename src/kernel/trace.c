@@ -0,0 +1,248 @@
+/**
+ * @file trace.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Binary event tracing over the UART.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The ring works like the kernel log ring: writers claim a record with an atomic increment and
+ * publish it by writing its sequence number last, and the streamer, the only reader, checks the
+ * sequence number again after copying a record.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/trace.h"
+#include "common/types.h"
+#include "drivers/irq.h"
+
+#define TRACE_MASK (TRACE_RECORDS - 1)
+
+struct trace_record_t {
+    u32_t sequence; // Index of the record plus one once published, 0 while being written.
+    u32_t event;    // enum TraceEvent.
+    u32_t arg0;
+    u32_t arg1;
+    u64_t time; // Microseconds since boot.
+};
+
+static struct trace_record_t trace_records[TRACE_RECORDS];
+static u32_t trace_head;
+static u32_t trace_tail;
+static trace_clock_t trace_clock;
+
+/// @brief One bit per interrupt left out of the trace.
+static u32_t trace_ignored_irqs[IRQ_COUNT / 32];
+
+/// @brief The frame being built by `trace_stream`.
+static u8_t trace_frame[TRACE_FRAME_SIZE(TRACE_BATCH)];
+
+/// @brief CRC-32 of every nibble, for the reflected polynomial 0xEDB88320.
+static const u32_t trace_crc_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+/**
+ * @brief The standard CRC-32, as used by zlib, a nibble at a time.
+ *
+ * @param data The bytes.
+ * @param length The number of bytes.
+ * @return u32_t The checksum.
+ */
+u32_t trace_crc32(const u8_t* data, u32_t length) {
+    u32_t crc = 0xffffffff;
+
+    for (u32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ trace_crc_table[crc & 0xf];
+        crc = (crc >> 4) ^ trace_crc_table[crc & 0xf];
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Empty the ring and set where timestamps come from. Must be called before any trace point.
+ *
+ * @param clock The timestamp source, or NULL to trace without times.
+ */
+void trace_init(trace_clock_t clock) {
+    for (u32_t i = 0; i < TRACE_RECORDS; i++) {
+        trace_records[i].sequence = 0;
+    }
+    for (u32_t i = 0; i < IRQ_COUNT / 32; i++) {
+        trace_ignored_irqs[i] = 0;
+    }
+    trace_head  = 0;
+    trace_tail  = 0;
+    trace_clock = clock;
+}
+
+/**
+ * @brief Leave an interrupt out of the trace, see `trace_irq`.
+ *
+ * @param irq The interrupt number.
+ */
+void trace_ignore_irq(u32_t irq) {
+    if (irq < IRQ_COUNT) {
+        trace_ignored_irqs[irq >> 5] |= 1u << (irq & 31);
+    }
+}
+
+/**
+ * @brief Whether the handlers of an interrupt are traced.
+ *
+ * @param irq The interrupt number.
+ */
+bool trace_irq_wanted(u32_t irq) {
+    return irq >= IRQ_COUNT || !(trace_ignored_irqs[irq >> 5] & (1u << (irq & 31)));
+}
+
+/**
+ * @brief Append a record to the ring, see `trace`.
+ *
+ * @param event The event.
+ * @param arg0 First argument.
+ * @param arg1 Second argument.
+ */
+void trace_emit(enum TraceEvent event, u32_t arg0, u32_t arg1) {
+    u32_t index                   = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+    struct trace_record_t* record = &trace_records[index & TRACE_MASK];
+
+    __atomic_store_n(&record->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    record->event = event;
+    record->arg0  = arg0;
+    record->arg1  = arg1;
+    record->time  = trace_clock ? trace_clock() : 0;
+
+    __atomic_store_n(&record->sequence, index + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy a published record out of the ring.
+ *
+ * @param index Index of the record.
+ * @param copy Where to copy it.
+ * @return bool False if the record is not published yet, or was overwritten by a later one.
+ */
+static bool trace_read(u32_t index, struct trace_record_t* copy) {
+    const struct trace_record_t* record = &trace_records[index & TRACE_MASK];
+
+    if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != index + 1) {
+        return false;
+    }
+
+    copy->event = record->event;
+    copy->arg0  = record->arg0;
+    copy->arg1  = record->arg1;
+    copy->time  = record->time;
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&record->sequence, __ATOMIC_RELAXED) == index + 1;
+}
+
+/**
+ * @brief Whether any record has been written that is not streamed yet.
+ */
+bool trace_pending(void) {
+    return __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE) != trace_tail;
+}
+
+static void trace_put_u16(u8_t* out, u32_t value) {
+    out[0] = (u8_t)value;
+    out[1] = (u8_t)(value >> 8);
+}
+
+static void trace_put_u32(u8_t* out, u32_t value) {
+    trace_put_u16(out, value);
+    trace_put_u16(out + 2, value >> 16);
+}
+
+/**
+ * @brief Fill `trace_frame` with records from the tail of the ring.
+ *
+ * Stops early at a record that is not published or was overwritten, and before a record too far
+ * from the previous one for its time delta to fit.
+ *
+ * @return u32_t The number of records in the frame, 0 if the first record could not be read.
+ */
+static u32_t trace_frame_build(void) {
+    struct trace_record_t record;
+    u32_t head     = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    u32_t first    = trace_tail;
+    u64_t previous = 0;
+    u32_t count    = 0;
+
+    while (count < TRACE_BATCH && trace_tail != head && trace_read(trace_tail, &record)) {
+        if (count == 0) {
+            previous = record.time;
+            trace_put_u32(trace_frame + 8, (u32_t)record.time);
+            trace_put_u32(trace_frame + 12, (u32_t)(record.time >> 32));
+        }
+
+        i64_t delta = (i64_t)(record.time - previous);
+        if (delta > 0x7fffffff || delta < -0x7fffffff) {
+            break;
+        }
+
+        u8_t* out = trace_frame + TRACE_HEADER_SIZE + count * TRACE_RECORD_SIZE;
+        trace_put_u16(out, record.event);
+        trace_put_u16(out + 2, 0);
+        trace_put_u32(out + 4, (u32_t)delta);
+        trace_put_u32(out + 8, record.arg0);
+        trace_put_u32(out + 12, record.arg1);
+
+        previous = record.time;
+        trace_tail++;
+        count++;
+    }
+
+    if (count) {
+        trace_put_u16(trace_frame, TRACE_MAGIC);
+        trace_frame[2] = TRACE_VERSION;
+        trace_frame[3] = (u8_t)count;
+        trace_put_u32(trace_frame + 4, first);
+
+        u32_t length = TRACE_HEADER_SIZE + count * TRACE_RECORD_SIZE;
+        trace_put_u32(trace_frame + length, trace_crc32(trace_frame, length));
+    }
+    return count;
+}
+
+/**
+ * @brief Send every published record not sent yet, in frames of up to TRACE_BATCH records. Only
+ * one stream can run at a time, from normal code.
+ *
+ * Records overwritten before they could be sent are skipped, which the decoder sees as a gap in
+ * the sequence numbers.
+ *
+ * @param write Where the frames go.
+ * @return u32_t The number of records sent.
+ */
+u32_t trace_stream(trace_write_t write) {
+    u32_t sent = 0;
+
+    while (true) {
+        u32_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+        if (head - trace_tail > TRACE_RECORDS) {
+            trace_tail = head - TRACE_RECORDS;
+        }
+        if (trace_tail == head) {
+            break;
+        }
+
+        u32_t count = trace_frame_build();
+        if (count == 0) {
+            // Overwritten while it was read, which the next pass skips, or still being written.
+            if (__atomic_load_n(&trace_head, __ATOMIC_ACQUIRE) - trace_tail > TRACE_RECORDS) {
+                continue;
+            }
+            break;
+        }
+
+        write((const char*)trace_frame, TRACE_FRAME_SIZE(count));
+        sent += count;
+    }
+    return sent;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file divide_bench.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Host benchmarks for the integer division runtime.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Times the shift and subtract routines and the constant reciprocals against the host divide
+ * instruction, over operands of every bit length. The host numbers are only a guide to the relative
+ * cost on the ARM1176, which has no divide instruction at all. Results are printed one JSON object
+ * per line, like dt_bench:
+ *
+ *     {"bench": "divide_u64", "ops": 4194304, "ns_per_op": 9.1}
+ *
+ * Usage: divide_bench
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+
+// clock_gettime is POSIX, and the benchmarks are built with -std=c17.
+#define _POSIX_C_SOURCE 199309L
+
+#include "common/divide.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/// @brief Each benchmark is repeated until it has run for at least this long.
+#define BENCH_MIN_NS 200000000ull
+
+/// @brief Number of operand pairs, a power of two.
+#define BENCH_OPERANDS 4096
+
+/// @brief Operands, spread over every bit length.
+static u64_t bench_dividends[BENCH_OPERANDS];
+static u64_t bench_divisors[BENCH_OPERANDS];
+
+/// @brief Results of every benchmark are written here so that they are never dead.
+static volatile u64_t bench_sink;
+
+/**
+ * @brief A benchmark, which runs over every operand `ops` times and returns a value depending on
+ * the results so the work cannot be optimised away.
+ */
+struct bench_t {
+    const char* name;
+    u64_t (*run)(u64_t ops);
+};
+
+static u64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64_t)ts.tv_sec * 1000000000ull + (u64_t)ts.tv_nsec;
+}
+
+/// @brief xorshift64, so the operands are the same on every run.
+static u64_t bench_random(u64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void bench_operands(void) {
+    u64_t state = 0x9e3779b97f4a7c15ull;
+    for (u32_t i = 0; i < BENCH_OPERANDS; i++) {
+        bench_dividends[i] = bench_random(&state) >> (bench_random(&state) & 63);
+        bench_divisors[i]  = (bench_random(&state) >> (bench_random(&state) & 63)) | 1;
+    }
+}
+
+static u64_t bench_divide_u32(u64_t ops) {
+    u64_t result = 0;
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t n = 0; n < BENCH_OPERANDS; n++) {
+            u32_t remainder;
+            result += divide_u32((u32_t)bench_dividends[n], (u32_t)bench_divisors[n], &remainder);
+            result += remainder;
+        }
+    }
+    return result;
+}
+
+static u64_t bench_native_u32(u64_t ops) {
+    u64_t result = 0;
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t n = 0; n < BENCH_OPERANDS; n++) {
+            u32_t dividend = (u32_t)bench_dividends[n];
+            u32_t divisor  = (u32_t)bench_divisors[n];
+            result += dividend / divisor + dividend % divisor;
+        }
+    }
+    return result;
+}
+
+static u64_t bench_divide_u64(u64_t ops) {
+    u64_t result = 0;
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t n = 0; n < BENCH_OPERANDS; n++) {
+            u64_t remainder;
+            result += divide_u64(bench_dividends[n], bench_divisors[n], &remainder);
+            result += remainder;
+        }
+    }
+    return result;
+}
+
+static u64_t bench_native_u64(u64_t ops) {
+    u64_t result = 0;
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t n = 0; n < BENCH_OPERANDS; n++) {
+            u64_t dividend = bench_dividends[n];
+            u64_t divisor  = bench_divisors[n];
+            result += dividend / divisor + dividend % divisor;
+        }
+    }
+    return result;
+}
+
+static u64_t bench_divide_u64_by_1000000(u64_t ops) {
+    u64_t result = 0;
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t n = 0; n < BENCH_OPERANDS; n++) {
+            result += divide_u64_by_1000000(bench_dividends[n]);
+        }
+    }
+    return result;
+}
+
+static u64_t bench_shift_subtract_by_1000000(u64_t ops) {
+    u64_t result = 0;
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t n = 0; n < BENCH_OPERANDS; n++) {
+            result += divide_u64(bench_dividends[n], 1000000, NULL);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Time a benchmark, doubling the number of iterations until it runs for BENCH_MIN_NS.
+ */
+static void run_bench(const struct bench_t* bench) {
+    u64_t iterations = 1;
+    u64_t elapsed;
+
+    while (true) {
+        u64_t start = now_ns();
+        bench_sink += bench->run(iterations);
+        elapsed = now_ns() - start;
+
+        if (elapsed >= BENCH_MIN_NS) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    u64_t ops = iterations * BENCH_OPERANDS;
+    printf("{\"bench\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.2f}\n", bench->name,
+           (unsigned long long)ops, (double)elapsed / (double)ops);
+}
+
+int main(void) {
+    const struct bench_t benches[] = {
+        {"divide_u32", bench_divide_u32},
+        {"native_u32", bench_native_u32},
+        {"divide_u64", bench_divide_u64},
+        {"native_u64", bench_native_u64},
+        {"divide_u64_by_1000000", bench_divide_u64_by_1000000},
+        {"shift_subtract_by_1000000", bench_shift_subtract_by_1000000},
+    };
+
+    bench_operands();
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        run_bench(&benches[b]);
+    }
+    return 0;
+}
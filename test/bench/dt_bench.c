@@ -0,0 +1,294 @@
+/**
+ * @file dt_bench.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Host benchmarks for the device tree driver.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Every blob given on the command line is loaded from disk and each benchmark is run against it.
+ * Results are printed one JSON object per line, so that runs can be diffed or collected by a script
+ * to catch regressions when the driver's data structures change:
+ *
+ *     {"dtb": "qemu/bcm2708-rpi-b-plus.dtb", "bench": "dt_init", "ops": 65536, "ns_per_op": 9.1}
+ *
+ * Usage: dt_bench <blob.dtb>...
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+
+// clock_gettime is POSIX, and the benchmarks are built with -std=c17.
+#define _POSIX_C_SOURCE 199309L
+
+#include "drivers/dt.h"
+#include "host_util.h"
+#include "kernel/arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// @brief Each benchmark is repeated until it has run for at least this long.
+#define BENCH_MIN_NS 200000000ull
+
+/// @brief Properties looked up on every node by the property benchmarks.
+static const char* const bench_props[] = {"compatible", "reg", "status", "phandle", "no-such-prop"};
+
+#define BENCH_PROP_COUNT (sizeof(bench_props) / sizeof(bench_props[0]))
+
+/**
+ * @brief Everything a benchmark needs, prepared once per blob so that only the operation under
+ * test is timed.
+ */
+struct bench_ctx_t {
+    void* blob;                                  // The blob, as loaded from disk.
+    struct dt_node_iter_t* nodes;                // Every node, in depth first order.
+    char (*paths)[HOST_PATH_MAX];               // Absolute path of every node.
+    u32_t node_count;                            // Number of entries in `nodes` and `paths`.
+    dt_prop_name_t prop_names[BENCH_PROP_COUNT]; // Resolved `bench_props`.
+};
+
+/**
+ * @brief A benchmark, which runs its operation `ops` times and returns a value depending on the
+ * results so the work cannot be optimised away.
+ */
+struct bench_t {
+    const char* name;
+    u64_t (*run)(struct bench_ctx_t* ctx, u64_t ops);
+    u32_t ops_per_call; // Operations performed by each iteration of `run`.
+};
+
+/// @brief Results of every benchmark are written here so that they are never dead.
+static volatile u64_t bench_sink;
+
+/// @brief Size of the boot arena that the device tree tables are allocated from.
+#define BENCH_ARENA_SIZE 0x100000
+
+/// @brief Stands in for the boot arena of the kernel.
+static _Alignas(16) u8_t bench_arena[BENCH_ARENA_SIZE];
+
+static u64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64_t)ts.tv_sec * 1000000000ull + (u64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Visit every node and every property of the tree depth first, using only the iterators.
+ *
+ * @return u64_t The number of nodes plus the number of properties.
+ */
+static u64_t walk_tree(void) {
+    struct dt_node_iter_t node;
+    struct dt_prop_iter_t prop;
+    u64_t visited = 0;
+
+    if (dt_iter_init_node(&node) != DT_GOOD) {
+        return 0;
+    }
+
+    while (true) {
+        visited++;
+        if (dt_iter_first_prop(&node, &prop) == DT_GOOD) {
+            do {
+                visited += dt_prop_len(&prop);
+            } while (dt_prop_next(&prop) == DT_GOOD);
+        }
+
+        if (dt_iter_first_child(&node) == DT_GOOD) {
+            continue;
+        }
+
+        // Climb until a node has a next sibling, the walk is over when the root is reached.
+        while (dt_iter_next_sibling(&node) != DT_GOOD) {
+            if (dt_iter_parent(&node) != DT_GOOD) {
+                return visited;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Collect an iterator for every node of the tree, in depth first order.
+ *
+ * @param nodes Where to write the newly allocated array of nodes.
+ * @return u32_t The number of nodes.
+ */
+static u32_t collect_nodes(struct dt_node_iter_t** nodes) {
+    struct dt_node_iter_t node;
+    u32_t count    = 0;
+    u32_t capacity = 64;
+
+    *nodes = malloc(capacity * sizeof(**nodes));
+    if (dt_iter_init_node(&node) != DT_GOOD) {
+        return 0;
+    }
+
+    while (true) {
+        if (count == capacity) {
+            capacity *= 2;
+            *nodes = realloc(*nodes, capacity * sizeof(**nodes));
+        }
+        (*nodes)[count++] = node;
+
+        if (dt_iter_first_child(&node) == DT_GOOD) {
+            continue;
+        }
+
+        while (dt_iter_next_sibling(&node) != DT_GOOD) {
+            if (dt_iter_parent(&node) != DT_GOOD) {
+                return count;
+            }
+        }
+    }
+}
+
+static u64_t bench_dt_init(struct bench_ctx_t* ctx, u64_t ops) {
+    u64_t result = 0;
+    u32_t mark   = arena_mark();
+
+    // Every parse builds fresh tables in the arena, so roll it back each time. The tables of the
+    // last parse are kept for the other benchmarks.
+    for (u64_t i = 0; i < ops; i++) {
+        arena_release(mark);
+        result += (u64_t)dt_init(ctx->blob);
+    }
+    return result;
+}
+
+static u64_t bench_iterate(struct bench_ctx_t* ctx, u64_t ops) {
+    (void)ctx;
+
+    u64_t result = 0;
+    for (u64_t i = 0; i < ops; i++) {
+        result += walk_tree();
+    }
+    return result;
+}
+
+static u64_t bench_path(struct bench_ctx_t* ctx, u64_t ops) {
+    struct dt_node_iter_t node;
+    u64_t result = 0;
+
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t p = 0; p < ctx->node_count; p++) {
+            dt_get_node_by_path(ctx->paths[p], &node);
+            result += node.index;
+        }
+    }
+    return result;
+}
+
+static u64_t bench_prop_get(struct bench_ctx_t* ctx, u64_t ops) {
+    struct dt_prop_iter_t prop;
+    u64_t result = 0;
+
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t n = 0; n < ctx->node_count; n++) {
+            for (u32_t p = 0; p < BENCH_PROP_COUNT; p++) {
+                result += (u64_t)dt_iter_get_prop(&ctx->nodes[n], bench_props[p], &prop);
+            }
+        }
+    }
+    return result;
+}
+
+static u64_t bench_prop_find(struct bench_ctx_t* ctx, u64_t ops) {
+    struct dt_prop_iter_t prop;
+    u64_t result = 0;
+
+    for (u64_t i = 0; i < ops; i++) {
+        for (u32_t n = 0; n < ctx->node_count; n++) {
+            for (u32_t p = 0; p < BENCH_PROP_COUNT; p++) {
+                result += (u64_t)dt_iter_find_prop(&ctx->nodes[n], ctx->prop_names[p], &prop);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Time a benchmark, doubling the number of iterations until it runs for BENCH_MIN_NS.
+ */
+static void run_bench(const char* dtb, const struct bench_t* bench, struct bench_ctx_t* ctx) {
+    u64_t iterations = 1;
+    u64_t elapsed;
+
+    while (true) {
+        u64_t start = now_ns();
+        bench_sink += bench->run(ctx, iterations);
+        elapsed = now_ns() - start;
+
+        if (elapsed >= BENCH_MIN_NS) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    u64_t ops = iterations * bench->ops_per_call;
+    printf("{\"dtb\": \"%s\", \"bench\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.2f}\n", dtb,
+           bench->name, (unsigned long long)ops, (double)elapsed / (double)ops);
+}
+
+/**
+ * @brief Load a blob, prepare the inputs of every benchmark and run them all.
+ *
+ * @return int 0 on success.
+ */
+static int bench_blob(const char* dtb) {
+    struct bench_ctx_t ctx;
+    ctx.blob = host_read_file(dtb, NULL);
+    if (ctx.blob == NULL) {
+        fprintf(stderr, "dt_bench: could not read %s\n", dtb);
+        return 1;
+    }
+
+    arena_init(bench_arena, BENCH_ARENA_SIZE);
+    enum dt_return_value_t status = dt_init(ctx.blob);
+    if (status != DT_GOOD) {
+        fprintf(stderr, "dt_bench: could not parse %s (%d)\n", dtb, status);
+        free(ctx.blob);
+        return 1;
+    }
+
+    // Record every node and its path.
+    u32_t count    = collect_nodes(&ctx.nodes);
+    ctx.node_count = count;
+    ctx.paths      = malloc(count * sizeof(*ctx.paths));
+    for (u32_t index = 0; index < count; index++) {
+        host_dt_path(ctx.nodes[index], ctx.paths[index]);
+    }
+
+    for (u32_t p = 0; p < BENCH_PROP_COUNT; p++) {
+        dt_prop_name_resolve(bench_props[p], &ctx.prop_names[p]);
+    }
+
+    const struct bench_t benches[] = {
+        {"dt_init", bench_dt_init, 1},
+        {"iterate", bench_iterate, 1},
+        {"path_lookup", bench_path, count},
+        {"prop_get", bench_prop_get, count * BENCH_PROP_COUNT},
+        {"prop_find", bench_prop_find, count * BENCH_PROP_COUNT},
+    };
+
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        run_bench(dtb, &benches[b], &ctx);
+    }
+
+    free(ctx.paths);
+    free(ctx.nodes);
+    free(ctx.blob);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <blob.dtb>...\n", argv[0]);
+        return 1;
+    }
+
+    int result = 0;
+    for (int i = 1; i < argc; i++) {
+        result |= bench_blob(argv[i]);
+    }
+    return result;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file host_util.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Helpers shared by the host tests, the benchmarks and the tools.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "host_util.h"
+#include "common/string.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Read a whole file into a freshly allocated buffer, which malloc aligns well enough for a
+ * device tree blob.
+ *
+ * @param path The file.
+ * @param size Set to the size of the file, may be NULL.
+ * @return void* The contents, to be freed by the caller, or NULL if the file could not be read.
+ */
+void* host_read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void* data = length > 0 ? malloc((size_t)length) : NULL;
+    if (data != NULL && fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+    if (data != NULL && size != NULL) {
+        *size = (size_t)length;
+    }
+    return data;
+}
+
+/**
+ * @brief Write the absolute path of a node, by walking up to the root.
+ *
+ * @param node The node.
+ * @param out Where to write the null terminated path.
+ * @return bool False if the path does not fit, `out` then holds the part that does.
+ */
+bool host_dt_path(struct dt_node_iter_t node, char out[HOST_PATH_MAX]) {
+    char scratch[HOST_PATH_MAX];
+    size_t start   = HOST_PATH_MAX - 1;
+    scratch[start] = '\0';
+    bool fits      = true;
+
+    struct dt_node_iter_t parent = node;
+    while (dt_iter_parent(&parent) == DT_GOOD) {
+        const char* name = dt_iter_name(&node);
+        size_t len       = strlen(name);
+        if (start <= len + 1) {
+            fits = false;
+            break;
+        }
+
+        start -= len;
+        for (size_t i = 0; i < len; i++) {
+            scratch[start + i] = name[i];
+        }
+        scratch[--start] = '/';
+
+        node = parent;
+    }
+
+    // The root is the only node without a parent, and its path is just the separator.
+    if (scratch[start] == '\0') {
+        scratch[--start] = '/';
+    }
+
+    for (size_t i = start; i < HOST_PATH_MAX; i++) {
+        out[i - start] = scratch[i];
+    }
+    return fits;
+}
@@ -0,0 +1,22 @@
+/**
+ * @file host_util.h
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Helpers shared by the host tests, the benchmarks and the tools.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#ifndef TEST_HOST_UTIL_H
+#define TEST_HOST_UTIL_H
+
+#include "common/types.h"
+#include "drivers/dt.h"
+
+/// @brief Longest absolute node path, null terminator included, built by `host_dt_path`.
+#define HOST_PATH_MAX 512
+
+void* host_read_file(const char* path, size_t* size);
+bool host_dt_path(struct dt_node_iter_t node, char out[HOST_PATH_MAX]);
+
+#endif // host_util.h
@@ -1 +1,47 @@
+/**
+ * @file main.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Host test suite entry point.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Each source directory under test/src contributes a null terminated array of munit tests, which
+ * are collected here into one suite per module.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "munit.h"
 
+extern MunitTest string_tests[];
+extern MunitTest endian_tests[];
+extern MunitTest ring_tests[];
+extern MunitTest format_tests[];
+extern MunitTest divide_tests[];
+extern MunitTest dt_tests[];
+extern MunitTest mm_tests[];
+extern MunitTest page_tests[];
+extern MunitTest heap_tests[];
+extern MunitTest arena_tests[];
+extern MunitTest klog_tests[];
+extern MunitTest trace_tests[];
+
+static MunitSuite module_suites[] = {
+    {"/common/string", string_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/common/endian", endian_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/common/ring", ring_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/common/format", format_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/common/divide", divide_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/drivers/dt", dt_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/kernel/mm", mm_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/kernel/page", page_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/kernel/heap", heap_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/kernel/arena", arena_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/kernel/klog", klog_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {"/kernel/trace", trace_tests, NULL, 1, MUNIT_SUITE_OPTION_NONE},
+    {NULL, NULL, NULL, 0, MUNIT_SUITE_OPTION_NONE},
+};
+
+static const MunitSuite kernel_suite = {"/pioneer", NULL, module_suites, 1,
+                                        MUNIT_SUITE_OPTION_NONE};
+
+int main(int argc, char* argv[]) { return munit_suite_main(&kernel_suite, NULL, argc, argv); }
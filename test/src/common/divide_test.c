@@ -0,0 +1,150 @@
+/**
+ * @file divide_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the integer division runtime.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The host divide instruction is the reference for every result.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "common/divide.h"
+#include "munit.h"
+
+u64_t __aeabi_uidivmod(u32_t dividend, u32_t divisor);
+u64_t __aeabi_idivmod(i32_t dividend, i32_t divisor);
+
+/// @brief Random values spread over every bit length, so that short quotients are covered too.
+static u64_t random_u64(void) {
+    u64_t value = ((u64_t)munit_rand_uint32() << 32) | munit_rand_uint32();
+    return value >> munit_rand_int_range(0, 63);
+}
+
+static MunitResult test_unsigned(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    for (u32_t i = 0; i < 200000; i++) {
+        u64_t dividend = random_u64();
+        u64_t divisor  = random_u64();
+        if (divisor == 0) {
+            continue;
+        }
+
+        u64_t remainder;
+        munit_assert_uint64(divide_u64(dividend, divisor, &remainder), ==, dividend / divisor);
+        munit_assert_uint64(remainder, ==, dividend % divisor);
+
+        u32_t remainder32;
+        u32_t dividend32 = (u32_t)dividend;
+        u32_t divisor32  = (u32_t)divisor ? (u32_t)divisor : 1;
+        munit_assert_uint32(divide_u32(dividend32, divisor32, &remainder32), ==,
+                            dividend32 / divisor32);
+        munit_assert_uint32(remainder32, ==, dividend32 % divisor32);
+    }
+
+    u64_t remainder;
+    munit_assert_uint64(divide_u64(~0ull, 1, &remainder), ==, ~0ull);
+    munit_assert_uint64(remainder, ==, 0);
+    munit_assert_uint64(divide_u64(~0ull, ~0ull, NULL), ==, 1);
+    munit_assert_uint64(divide_u64(1ull << 63, 3, &remainder), ==, (1ull << 63) / 3);
+    munit_assert_uint64(remainder, ==, (1ull << 63) % 3);
+    munit_assert_uint32(divide_u32(0xffffffffu, 0x80000000u, NULL), ==, 1);
+
+    // Division by zero does not trap.
+    munit_assert_uint32(divide_u32(1234, 0, NULL), ==, 0);
+    munit_assert_uint64(divide_u64(1ull << 40, 0, &remainder), ==, 0);
+    munit_assert_uint64(remainder, ==, 1ull << 40);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_signed(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    for (u32_t i = 0; i < 200000; i++) {
+        i64_t dividend = (i64_t)random_u64();
+        i64_t divisor  = (i64_t)random_u64();
+        if (divisor == 0 || (dividend == INT64_MIN && divisor == -1)) {
+            continue;
+        }
+
+        i64_t remainder;
+        munit_assert_int64(divide_i64(dividend, divisor, &remainder), ==, dividend / divisor);
+        munit_assert_int64(remainder, ==, dividend % divisor);
+
+        i32_t remainder32;
+        i32_t dividend32 = (i32_t)dividend;
+        i32_t divisor32  = (i32_t)divisor ? (i32_t)divisor : 1;
+        if (dividend32 == INT32_MIN && divisor32 == -1) {
+            continue;
+        }
+        munit_assert_int32(divide_i32(dividend32, divisor32, &remainder32), ==,
+                           dividend32 / divisor32);
+        munit_assert_int32(remainder32, ==, dividend32 % divisor32);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_aeabi(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    // Quotient in the low word, remainder in the high word, as they come back in r0 and r1.
+    u64_t result = __aeabi_uidivmod(1000003, 1000);
+    munit_assert_uint32((u32_t)result, ==, 1000);
+    munit_assert_uint32((u32_t)(result >> 32), ==, 3);
+
+    result = __aeabi_idivmod(-7, 2);
+    munit_assert_int32((i32_t)(u32_t)result, ==, -3);
+    munit_assert_int32((i32_t)(u32_t)(result >> 32), ==, -1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_constants(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    // Either side of each multiple is where a reciprocal that is slightly off gets caught.
+    const u64_t divisors[] = {10, 100, 1000, 1000000};
+    for (u32_t d = 0; d < 4; d++) {
+        for (u32_t i = 0; i < 50000; i++) {
+            u64_t multiple = (random_u64() / divisors[d]) * divisors[d];
+            for (u64_t value = multiple - 1; value != multiple + 2; value++) {
+                u64_t quotient = value / divisors[d];
+                u64_t fast     = d == 0   ? divide_u64_by_10(value)
+                                 : d == 1 ? divide_u64_by_100(value)
+                                 : d == 2 ? divide_u64_by_1000(value)
+                                          : divide_u64_by_1000000(value);
+                munit_assert_uint64(fast, ==, quotient);
+
+                u32_t value32    = (u32_t)value;
+                u32_t quotient32 = value32 / (u32_t)divisors[d];
+                u32_t fast32     = d == 0   ? divide_u32_by_10(value32)
+                                   : d == 1 ? divide_u32_by_100(value32)
+                                   : d == 2 ? divide_u32_by_1000(value32)
+                                            : divide_u32_by_1000000(value32);
+                munit_assert_uint32(fast32, ==, quotient32);
+            }
+        }
+    }
+
+    munit_assert_uint64(divide_u64_by_1000000(~0ull), ==, ~0ull / 1000000);
+    munit_assert_uint64(divide_u64_by_10(~0ull), ==, ~0ull / 10);
+    munit_assert_uint32(divide_u32_by_1000(0xffffffffu), ==, 0xffffffffu / 1000);
+    munit_assert_uint64(divide_mulhi_u64(~0ull, ~0ull), ==, ~0ull - 1);
+
+    return MUNIT_OK;
+}
+
+MunitTest divide_tests[] = {
+    {"/unsigned", test_unsigned, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/signed", test_signed, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aeabi", test_aeabi, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/constants", test_constants, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
@@ -0,0 +1,49 @@
+/**
+ * @file endian_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the byte order conversion helpers.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "common/endian.h"
+#include "munit.h"
+
+static MunitResult test_bswap(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    munit_assert_uint16(bswap16(0x1234), ==, 0x3412);
+    munit_assert_uint32(bswap32(0xd00dfeed), ==, 0xedfe0dd0);
+    munit_assert_uint64(bswap64(0x0102030405060708), ==, 0x0807060504030201);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_beth(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    // The magic number at the start of every device tree blob, as it is laid out in memory.
+    const u8_t magic[] = {0xd0, 0x0d, 0xfe, 0xed, 0x00, 0x00, 0x00, 0x11};
+    u16_t be16;
+    u32_t be32;
+    u64_t be64;
+
+    __builtin_memcpy(&be16, magic, sizeof(be16));
+    __builtin_memcpy(&be32, magic, sizeof(be32));
+    __builtin_memcpy(&be64, magic, sizeof(be64));
+
+    munit_assert_uint16(beths(be16), ==, 0xd00d);
+    munit_assert_uint32(beth(be32), ==, 0xd00dfeed);
+    munit_assert_uint64(bethl(be64), ==, 0xd00dfeed00000011);
+
+    return MUNIT_OK;
+}
+
+MunitTest endian_tests[] = {
+    {"/bswap", test_bswap, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/beth", test_beth, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
@@ -0,0 +1,146 @@
+/**
+ * @file format_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the formatted output engine.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The host C library is the reference for every conversion.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "common/format.h"
+#include "munit.h"
+
+#include <stdio.h>
+#include <string.h>
+
+struct format_capture_t {
+    char text[256];
+    u32_t length;
+    u32_t calls;
+};
+
+static void format_capture(void* context, const char* data, u32_t length) {
+    struct format_capture_t* capture = context;
+    munit_assert_uint32(capture->length + length, <, sizeof(capture->text));
+
+    memcpy(capture->text + capture->length, data, length);
+    capture->length += length;
+    capture->text[capture->length] = '\0';
+    capture->calls++;
+}
+
+/// @brief Format with the engine and with the host, and check that both agree.
+#define assert_format(...)                                                                         \
+    do {                                                                                           \
+        struct format_capture_t capture = {{0}, 0, 0};                                             \
+        char expected[256];                                                                        \
+        int written = format_print(format_capture, &capture, __VA_ARGS__);                         \
+        int length  = snprintf(expected, sizeof(expected), __VA_ARGS__);                           \
+        munit_assert_string_equal(capture.text, expected);                                         \
+        munit_assert_int(written, ==, length);                                                     \
+    } while (0)
+
+static char* format_u64_string(char* buffer, u64_t value) {
+    char* end = buffer + FORMAT_NUMBER_SIZE - 1;
+    *end      = '\0';
+    return format_decimal_u64(end, value);
+}
+
+static MunitResult test_decimal(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    char buffer[FORMAT_NUMBER_SIZE];
+    char expected[FORMAT_NUMBER_SIZE];
+
+    // Every power of ten and its neighbours, where the digit pairs change length.
+    for (u64_t power = 1;; power *= 10) {
+        for (u64_t value = power - 1; value <= power + 1; value++) {
+            snprintf(expected, sizeof(expected), "%llu", (unsigned long long)value);
+            munit_assert_string_equal(format_u64_string(buffer, value), expected);
+        }
+        if (power == 10000000000000000000ull) {
+            break;
+        }
+    }
+
+    // The ends of the 32 and 64 bit paths and random values along both.
+    const u64_t edges[] = {0, 0xffffffffull, 0x100000000ull, 0xffffffffffffffffull};
+    for (u32_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+        snprintf(expected, sizeof(expected), "%llu", (unsigned long long)edges[i]);
+        munit_assert_string_equal(format_u64_string(buffer, edges[i]), expected);
+    }
+    for (u32_t i = 0; i < 100000; i++) {
+        u64_t value = ((u64_t)munit_rand_uint32() << 32) | munit_rand_uint32();
+        value >>= munit_rand_int_range(0, 63);
+
+        snprintf(expected, sizeof(expected), "%llu", (unsigned long long)value);
+        munit_assert_string_equal(format_u64_string(buffer, value), expected);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_conversions(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    assert_format("plain text");
+    assert_format("%d %d %d %i", 0, 42, -42, -2147483647 - 1);
+    assert_format("%u %u", 0u, 4294967295u);
+    assert_format("%x %X %x", 0xdeadbeefu, 0xdeadbeefu, 0u);
+    assert_format("%llu %lld %llx", 18446744073709551615ull, -9223372036854775807ll - 1,
+                  0x0123456789abcdefull);
+    assert_format("%lu %ld", 123456789ul, -123456789l);
+    assert_format("[%s] [%c] 100%%", "string", 'c');
+    assert_format("%p", (void*)0x8000);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_padding(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    assert_format("[%5d] [%-5d] [%05d]", 42, 42, 42);
+    assert_format("[%6d] [%-6d] [%06d]", -42, -42, -42);
+    assert_format("[%08x] [%-8X]", 0xbeefu, 0xbeefu);
+    assert_format("[%10s] [%-10s] [%2s]", "abc", "abc", "abcdef");
+    assert_format("[%*u] [%*u]", 7, 12u, -7, 12u);
+    assert_format("[%40u]", 1u);
+    assert_format("[%020llu]", 1234567890123ull);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_runs(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    // Literal text reaches the sink in runs, not a character at a time.
+    struct format_capture_t capture = {{0}, 0, 0};
+    format_print(format_capture, &capture, "[%u]:\tsome literal text\n", 7u);
+    munit_assert_string_equal(capture.text, "[7]:\tsome literal text\n");
+    munit_assert_uint32(capture.calls, ==, 3);
+
+    // Unknown and truncated conversions are written out unchanged.
+    capture = (struct format_capture_t){{0}, 0, 0};
+    format_print(format_capture, &capture, "%q %5");
+    munit_assert_string_equal(capture.text, "%q %5");
+
+    capture = (struct format_capture_t){{0}, 0, 0};
+    format_print(format_capture, &capture, "%s", (const char*)NULL);
+    munit_assert_string_equal(capture.text, "(null)");
+
+    return MUNIT_OK;
+}
+
+MunitTest format_tests[] = {
+    {"/decimal", test_decimal, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/conversions", test_conversions, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/padding", test_padding, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/runs", test_runs, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
@@ -0,0 +1,80 @@
+/**
+ * @file ring_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the single producer, single consumer byte ring.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "common/ring.h"
+#include "munit.h"
+
+static MunitResult test_fill(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    u8_t buffer[8];
+    struct ring_t ring;
+    u8_t byte;
+
+    ring_init(&ring, buffer, sizeof(buffer));
+    munit_assert_true(ring_empty(&ring));
+    munit_assert_false(ring_pop(&ring, &byte));
+
+    for (u32_t i = 0; i < sizeof(buffer); i++) {
+        munit_assert_true(ring_push(&ring, (u8_t)i));
+    }
+    munit_assert_uint32(ring_count(&ring), ==, sizeof(buffer));
+    munit_assert_false(ring_push(&ring, 0xff));
+
+    for (u32_t i = 0; i < sizeof(buffer); i++) {
+        munit_assert_true(ring_pop(&ring, &byte));
+        munit_assert_uint8(byte, ==, (u8_t)i);
+    }
+    munit_assert_true(ring_empty(&ring));
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_wrap(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    u8_t buffer[4];
+    struct ring_t ring;
+    u8_t byte;
+
+    // Start just before the indices wrap at 2^32.
+    ring_init(&ring, buffer, sizeof(buffer));
+    ring.head = 0xfffffffe;
+    ring.tail = 0xfffffffe;
+
+    u8_t next = 0;
+    u8_t want = 0;
+    for (u32_t round = 0; round < 100; round++) {
+        while (ring_push(&ring, next)) {
+            next++;
+        }
+        munit_assert_uint32(ring_count(&ring), ==, sizeof(buffer));
+
+        // Leave a byte behind each round so the slots in use move around the buffer.
+        for (u32_t i = 0; i + 1 < sizeof(buffer); i++) {
+            munit_assert_true(ring_pop(&ring, &byte));
+            munit_assert_uint8(byte, ==, want++);
+        }
+    }
+
+    while (ring_pop(&ring, &byte)) {
+        munit_assert_uint8(byte, ==, want++);
+    }
+    munit_assert_uint8(want, ==, next);
+
+    return MUNIT_OK;
+}
+
+MunitTest ring_tests[] = {
+    {"/fill", test_fill, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/wrap", test_wrap, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
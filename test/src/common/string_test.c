@@ -1 +1,44 @@
-#include "common/string.h"
\ No newline at end of file
+/**
+ * @file string_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the kernel string functions.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "common/string.h"
+#include "munit.h"
+
+static MunitResult test_strlen(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    munit_assert_size(strlen(""), ==, 0);
+    munit_assert_size(strlen("soc"), ==, 3);
+    munit_assert_size(strlen("gpio@7e200000"), ==, 13);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_strncmp(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    munit_assert_int(strncmp("soc", "soc", 3), ==, 0);
+    munit_assert_int(strncmp("soc", "soc", 10), ==, 0);
+    munit_assert_int(strncmp("gpio@7e200000", "gpio", 4), ==, 0);
+    munit_assert_int(strncmp("soc", "sod", 2), ==, 0);
+    munit_assert_int(strncmp("soc", "sod", 3), <, 0);
+    munit_assert_int(strncmp("sod", "soc", 3), >, 0);
+    munit_assert_int(strncmp("so", "soc", 3), <, 0);
+    munit_assert_int(strncmp("a", "b", 0), ==, 0);
+
+    return MUNIT_OK;
+}
+
+MunitTest string_tests[] = {
+    {"/strlen", test_strlen, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/strncmp", test_strncmp, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
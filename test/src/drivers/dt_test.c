@@ -0,0 +1,379 @@
+/**
+ * @file dt_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the device tree driver, run against a real device tree blob.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The blob is read from `TEST_DTB` (by default qemu/bcm2708-rpi-b-plus.dtb), and the tests are
+ * skipped if it has not been downloaded.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "drivers/dt.h"
+#include "common/string.h"
+#include "drivers/dt_tables.h"
+#include "host_util.h"
+#include "kernel/arena.h"
+#include "munit.h"
+
+#include <stdlib.h>
+
+#ifndef TEST_DTB
+#define TEST_DTB "qemu/bcm2708-rpi-b-plus.dtb"
+#endif
+
+/// @brief Size of the boot arena that the device tree tables are allocated from.
+#define TEST_ARENA_SIZE 0x40000
+
+/// @brief Stands in for the boot arena of the kernel.
+static _Alignas(16) u8_t test_arena[TEST_ARENA_SIZE];
+
+/**
+ * @brief Load the test blob into memory and initialise the device tree driver with it.
+ *
+ * @return void* The blob, or NULL if it could not be loaded.
+ */
+static void* dt_setup(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    // The structure block must be 4 byte aligned, which malloc guarantees.
+    void* blob = host_read_file(TEST_DTB, NULL);
+    if (blob == NULL) {
+        return NULL;
+    }
+
+    arena_init(test_arena, TEST_ARENA_SIZE);
+    munit_assert_int(dt_init(blob), ==, DT_GOOD);
+    return blob;
+}
+
+static void dt_tear_down(void* blob) { free(blob); }
+
+/**
+ * @brief Resolve the path of `node` and every node after it in depth first order.
+ *
+ * @return unsigned int The number of nodes checked.
+ */
+static unsigned int dt_check_subtree(struct dt_node_iter_t node) {
+    unsigned int checked = 0;
+    char path[HOST_PATH_MAX];
+
+    do {
+        munit_assert_true(host_dt_path(node, path));
+
+        struct dt_node_iter_t found;
+        munit_assert_int(dt_get_node_by_path(path, &found), ==, DT_GOOD);
+        munit_assert_ptr_equal(found.device_tree, node.device_tree);
+        munit_assert_uint32(found.index, ==, node.index);
+        checked++;
+
+        struct dt_node_iter_t child = node;
+        if (dt_iter_first_child(&child) == DT_GOOD) {
+            checked += dt_check_subtree(child);
+        }
+    } while (dt_iter_next_sibling(&node) == DT_GOOD);
+
+    return checked;
+}
+
+static MunitResult test_resolve_every_path(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct dt_node_iter_t root;
+    munit_assert_int(dt_iter_init_node(&root), ==, DT_GOOD);
+    munit_assert_uint(dt_check_subtree(root), >, 1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_resolve_known_paths(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct dt_node_iter_t node;
+
+    munit_assert_int(dt_get_node_by_path("/", &node), ==, DT_GOOD);
+    munit_assert_uint32(node.index, ==, 0);
+
+    munit_assert_int(dt_get_node_by_path("/reserved-memory", &node), ==, DT_GOOD);
+    munit_assert_string_equal(dt_iter_name(&node), "reserved-memory");
+
+    munit_assert_int(dt_get_node_by_path("/soc/gpio@7e200000", &node), ==, DT_GOOD);
+    munit_assert_string_equal(dt_iter_name(&node), "gpio@7e200000");
+    munit_assert_int(dt_iter_parent(&node), ==, DT_GOOD);
+    munit_assert_string_equal(dt_iter_name(&node), "soc");
+
+    struct dt_node_iter_t trailing;
+    munit_assert_int(dt_get_node_by_path("/soc/", &trailing), ==, DT_GOOD);
+    munit_assert_uint32(trailing.index, ==, node.index);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_resolve_missing_paths(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct dt_node_iter_t node;
+
+    munit_assert_int(dt_get_node_by_path("soc", &node), ==, DT_INVALID_PATH);
+    munit_assert_int(dt_get_node_by_path("", &node), ==, DT_INVALID_PATH);
+    munit_assert_int(dt_get_node_by_path("/does-not-exist", &node), ==, DT_PATH_NOT_FOUND);
+    munit_assert_int(dt_get_node_by_path("/soc/gpio", &node), ==, DT_PATH_NOT_FOUND);
+    munit_assert_int(dt_get_node_by_path("/gpio@7e200000", &node), ==, DT_PATH_NOT_FOUND);
+    munit_assert_int(dt_get_node_by_path("//soc", &node), ==, DT_PATH_NOT_FOUND);
+    munit_assert_int(dt_get_node_by_path("/soc/gpio@7e200000/missing", &node), ==,
+                     DT_PATH_NOT_FOUND);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_find_props(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct dt_node_iter_t root;
+    struct dt_prop_iter_t prop;
+    dt_prop_name_t addressCells;
+    u32_t value;
+
+    munit_assert_int(dt_iter_init_node(&root), ==, DT_GOOD);
+    munit_assert_int(dt_prop_name_resolve("#address-cells", &addressCells), ==, DT_GOOD);
+    munit_assert_int(dt_iter_find_prop(&root, addressCells, &prop), ==, DT_GOOD);
+    munit_assert_string_equal(dt_prop_name(&prop), "#address-cells");
+    munit_assert_uint32(dt_prop_len(&prop), ==, sizeof(u32_t));
+    munit_assert_int(dt_prop_read_u32(&prop, 0, &value), ==, DT_GOOD);
+    munit_assert_uint32(value, ==, 1);
+    munit_assert_int(dt_prop_read_u32(&prop, 1, &value), ==, DT_PROP_TOO_SHORT);
+
+    struct dt_node_iter_t gpio;
+    munit_assert_int(dt_get_node_by_path("/soc/gpio@7e200000", &gpio), ==, DT_GOOD);
+    munit_assert_int(dt_iter_get_prop(&gpio, "compatible", &prop), ==, DT_GOOD);
+    munit_assert_string_equal((const char*)dt_prop_data(&prop), "brcm,bcm2835-gpio");
+    munit_assert_int(dt_iter_find_prop(&gpio, addressCells, &prop), ==, DT_PROP_NOT_FOUND);
+
+    dt_prop_name_t missing;
+    munit_assert_int(dt_prop_name_resolve("no-such-property", &missing), ==, DT_PROP_NOT_FOUND);
+    munit_assert_int(dt_iter_find_prop(&root, missing, &prop), ==, DT_PROP_NOT_FOUND);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_iterate_props(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct dt_node_iter_t gpio;
+    struct dt_prop_iter_t prop;
+    munit_assert_int(dt_get_node_by_path("/soc/gpio@7e200000", &gpio), ==, DT_GOOD);
+    munit_assert_int(dt_iter_first_prop(&gpio, &prop), ==, DT_GOOD);
+
+    // Every property found by iterating must also be found by name.
+    do {
+        struct dt_prop_iter_t found;
+        munit_assert_int(dt_iter_get_prop(&gpio, dt_prop_name(&prop), &found), ==, DT_GOOD);
+        munit_assert_uint32(found.index, ==, prop.index);
+    } while (dt_prop_next(&prop) == DT_GOOD);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_resolve_phandles(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct dt_node_iter_t node;
+    struct dt_prop_iter_t prop;
+    u32_t phandle;
+
+    // The root names the interrupt controller as the default interrupt parent.
+    munit_assert_int(dt_iter_init_node(&node), ==, DT_GOOD);
+    munit_assert_int(dt_iter_get_prop(&node, "interrupt-parent", &prop), ==, DT_GOOD);
+    munit_assert_int(dt_prop_read_u32(&prop, 0, &phandle), ==, DT_GOOD);
+    munit_assert_int(dt_resolve_phandle(phandle, &node), ==, DT_GOOD);
+    munit_assert_int(dt_iter_get_prop(&node, "interrupt-controller", &prop), ==, DT_GOOD);
+
+    // And the controller's own phandle resolves back to it.
+    u32_t own;
+    struct dt_node_iter_t back;
+    munit_assert_int(dt_iter_get_prop(&node, "phandle", &prop), ==, DT_GOOD);
+    munit_assert_int(dt_prop_read_u32(&prop, 0, &own), ==, DT_GOOD);
+    munit_assert_uint32(own, ==, phandle);
+    munit_assert_int(dt_resolve_phandle(own, &back), ==, DT_GOOD);
+    munit_assert_uint32(back.index, ==, node.index);
+
+    munit_assert_int(dt_resolve_phandle(0, &node), ==, DT_PHANDLE_NOT_FOUND);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_decode_cells(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct dt_node_iter_t node;
+    struct dt_reg_t reg[2];
+    struct dt_range_t ranges[4];
+    u32_t interrupts[8];
+    u32_t cells;
+    u32_t count;
+
+    // The soc bus maps the VideoCore peripheral bus addresses onto the ARM physical addresses.
+    munit_assert_int(dt_get_node_by_path("/soc", &node), ==, DT_GOOD);
+    munit_assert_int(dt_iter_decode_ranges(&node, ranges, 4, &count), ==, DT_GOOD);
+    munit_assert_uint32(count, >=, 1);
+    munit_assert_uint64(ranges[0].child, ==, 0x7e000000);
+    munit_assert_uint64(ranges[0].parent, ==, 0x20000000);
+
+    // Registers are left in the bus address space.
+    munit_assert_int(dt_get_node_by_path("/soc/gpio@7e200000", &node), ==, DT_GOOD);
+    munit_assert_int(dt_iter_decode_reg(&node, reg, 2, &count), ==, DT_GOOD);
+    munit_assert_uint32(count, ==, 1);
+    munit_assert_uint64(reg[0].address, ==, 0x7e200000);
+    munit_assert_uint64(reg[0].size, ==, 0xb4);
+
+    // The interrupt controller uses two cells, a bank and an interrupt number.
+    munit_assert_int(dt_get_node_by_path("/soc/serial@7e201000", &node), ==, DT_GOOD);
+    munit_assert_int(dt_iter_decode_interrupts(&node, interrupts, 8, &cells, &count), ==,
+                     DT_GOOD);
+    munit_assert_uint32(cells, ==, 2);
+    munit_assert_uint32(count, ==, 1);
+    munit_assert_uint32(interrupts[0], ==, 2);
+    munit_assert_uint32(interrupts[1], ==, 25);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_precompiled_tables(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct dt_tables_t tables;
+    struct dt_node_iter_t node;
+    u64_t address;
+
+    // Tables built from this blob are accepted, and answer lookups without parsing it again.
+    dt_get_tables(&tables);
+    munit_assert_uint32(tables.checksum, ==, dt_blob_checksum(blob));
+    munit_assert_int(dt_init_from_tables(blob, &tables), ==, DT_GOOD);
+    munit_assert_int(dt_get_node_by_path("/soc/serial@7e201000", &node), ==, DT_GOOD);
+    munit_assert_int(dt_iter_reg_address(&node, 0, &address, NULL), ==, DT_GOOD);
+    munit_assert_uint64(address, ==, 0x20201000);
+    munit_assert_int(dt_iter_reg_address(&node, 1, &address, NULL), ==, DT_PROP_TOO_SHORT);
+
+    // Tables built from any other blob are rejected.
+    tables.checksum ^= 1;
+    munit_assert_int(dt_init_from_tables(blob, &tables), ==, DT_BAD_CHECKSUM);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_arena_sizing(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    // The tables are sized for the blob, so a second parse takes exactly as much again.
+    u32_t used = arena_used();
+    munit_assert_uint32(used, >, 0);
+    munit_assert_int(dt_init(blob), ==, DT_GOOD);
+    munit_assert_uint32(arena_used(), ==, used * 2);
+
+    // A parse that runs out of arena gives back everything it took.
+    arena_init(test_arena, used / 2);
+    munit_assert_int(dt_init(blob), ==, DT_NO_MEMORY);
+    munit_assert_uint32(arena_used(), ==, 0);
+
+    return MUNIT_OK;
+}
+
+/// @brief Probe results recorded by the test drivers.
+static ptr_t probed_gpio_base;
+static ptr_t probed_uart_base;
+static unsigned int probed_gpio_count;
+static unsigned int probed_uart_count;
+
+static enum dt_return_value_t test_gpio_probe(const struct dt_node_iter_t* node) {
+    probed_gpio_count++;
+    return dt_iter_mmio_base(node, &probed_gpio_base);
+}
+
+static enum dt_return_value_t test_uart_probe(const struct dt_node_iter_t* node) {
+    probed_uart_count++;
+    return dt_iter_mmio_base(node, &probed_uart_base);
+}
+
+static const char* const test_gpio_compatible[] = {"brcm,bcm2835-gpio", NULL};
+static const char* const test_uart_compatible[] = {"brcm,bcm2835-pl011", "arm,pl011", NULL};
+static const char* const test_none_compatible[] = {"pioneer,no-such-device", NULL};
+
+static MunitResult test_probe_drivers(const MunitParameter params[], void* blob) {
+    (void)params;
+    if (blob == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    const struct dt_driver_t gpio = {"gpio", test_gpio_compatible, test_gpio_probe};
+    const struct dt_driver_t uart = {"uart", test_uart_compatible, test_uart_probe};
+    const struct dt_driver_t none = {"none", test_none_compatible, NULL};
+    const struct dt_driver_t* const drivers[] = {&gpio, &uart, &none};
+
+    probed_gpio_base  = 0;
+    probed_uart_base  = 0;
+    probed_gpio_count = 0;
+    probed_uart_count = 0;
+
+    munit_assert_int(dt_probe_drivers(drivers, 3), ==, DT_GOOD);
+
+    // Both are translated through the soc ranges from bus to CPU physical addresses.
+    munit_assert_uint(probed_gpio_count, ==, 1);
+    munit_assert_uint(probed_uart_count, ==, 1);
+    munit_assert_uint64(probed_gpio_base, ==, 0x20200000);
+    munit_assert_uint64(probed_uart_base, ==, 0x20201000);
+
+    // More compatible strings than the table holds is its own error.
+    const struct dt_driver_t* many[33];
+    for (u32_t i = 0; i < 33; i++) {
+        many[i] = &none;
+    }
+    munit_assert_int(dt_probe_drivers(many, 33), ==, DT_TOO_MANY_COMPATIBLES);
+
+    return MUNIT_OK;
+}
+
+MunitTest dt_tests[] = {
+    {"/path/every", test_resolve_every_path, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/path/known", test_resolve_known_paths, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE,
+     NULL},
+    {"/path/missing", test_resolve_missing_paths, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE,
+     NULL},
+    {"/prop/find", test_find_props, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/prop/iterate", test_iterate_props, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/phandle", test_resolve_phandles, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/decode", test_decode_cells, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/precompiled", test_precompiled_tables, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE,
+     NULL},
+    {"/probe", test_probe_drivers, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/arena", test_arena_sizing, dt_setup, dt_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
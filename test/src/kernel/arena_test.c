@@ -0,0 +1,96 @@
+/**
+ * @file arena_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the boot time bump allocator.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/arena.h"
+#include "munit.h"
+
+/// @brief Size of the test arena.
+#define TEST_ARENA_SIZE 4096
+
+/// @brief Backing memory for the test arena.
+static _Alignas(64) u8_t test_arena[TEST_ARENA_SIZE];
+
+static MunitResult test_alloc(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    // Start off an odd boundary, as the linker only word aligns the real arena.
+    arena_init(test_arena + 4, TEST_ARENA_SIZE - 4);
+
+    u8_t* first = arena_alloc(3, 1);
+    munit_assert_ptr_equal(first, test_arena + 4);
+
+    // Alignment is of the address, and the padding is counted as used.
+    u8_t* aligned = arena_alloc(16, 64);
+    munit_assert_ptr_equal(aligned, test_arena + 64);
+    munit_assert_uint32(arena_used(), ==, 64 + 16 - 4);
+
+    u8_t* next = arena_alloc(8, 8);
+    munit_assert_ptr_equal(next, test_arena + 80);
+
+    // Exactly filling the arena works, going one byte over does not.
+    u32_t left = TEST_ARENA_SIZE - 88;
+    munit_assert_null(arena_alloc(left + 1, 1));
+    munit_assert_not_null(arena_alloc(left, 1));
+    munit_assert_null(arena_alloc(1, 1));
+    munit_assert_uint32(arena_used(), ==, TEST_ARENA_SIZE - 4);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_mark_release(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    arena_init(test_arena, TEST_ARENA_SIZE);
+
+    u8_t* kept = arena_alloc(100, 4);
+    u32_t mark = arena_mark();
+
+    u8_t* scratch = arena_alloc(1000, 4);
+    munit_assert_not_null(scratch);
+    munit_assert_uint32(arena_used(), ==, 1100);
+
+    // Releasing rolls back to the mark, so the scratch memory is handed out again.
+    arena_release(mark);
+    munit_assert_uint32(arena_used(), ==, 100);
+    munit_assert_ptr_equal(arena_alloc(1000, 4), scratch);
+    munit_assert_ptr_equal(kept, test_arena);
+
+    // A mark past the top is ignored.
+    arena_release(TEST_ARENA_SIZE);
+    munit_assert_uint32(arena_used(), ==, 1100);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_retire(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    arena_init(NULL, 0);
+    munit_assert_null(arena_alloc(1, 1));
+    munit_assert_null(arena_retire());
+
+    arena_init(test_arena, TEST_ARENA_SIZE);
+    munit_assert_not_null(arena_alloc(10, 1));
+
+    // The memory past the last allocation is given away, nothing more comes out of the arena.
+    munit_assert_ptr_equal(arena_retire(), test_arena + 10);
+    munit_assert_null(arena_alloc(1, 1));
+
+    return MUNIT_OK;
+}
+
+MunitTest arena_tests[] = {
+    {"/alloc", test_alloc, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/mark", test_mark_release, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/retire", test_retire, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
@@ -0,0 +1,184 @@
+/**
+ * @file heap_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the kernel heap.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The page allocator manages a made up 4MiB of physical memory starting at 0, and the heap maps it
+ * onto a real host buffer through its window.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/heap.h"
+#include "kernel/page.h"
+#include "munit.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/// @brief Size of the made up physical memory, 4MiB.
+#define TEST_MEMORY_SIZE 0x400000
+
+/// @brief Memory kept back from the allocator, like the kernel image on the target.
+#define TEST_RESERVED 0x4000
+
+struct heap_fixture_t {
+    struct page_t* metadata;
+    u8_t* memory;
+};
+
+static void* heap_setup(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    struct heap_fixture_t* fixture = malloc(sizeof(*fixture));
+    munit_assert_not_null(fixture);
+
+    fixture->metadata = malloc(page_metadata_size(0, TEST_MEMORY_SIZE));
+    fixture->memory   = aligned_alloc(PAGE_SIZE << PAGE_MAX_ORDER, TEST_MEMORY_SIZE);
+    munit_assert_not_null(fixture->metadata);
+    munit_assert_not_null(fixture->memory);
+
+    page_init(0, TEST_MEMORY_SIZE, fixture->metadata);
+    page_add_free_range(TEST_RESERVED, TEST_MEMORY_SIZE);
+    heap_init((uintptr_t)fixture->memory);
+    return fixture;
+}
+
+static void heap_tear_down(void* data) {
+    struct heap_fixture_t* fixture = data;
+    free(fixture->memory);
+    free(fixture->metadata);
+    free(fixture);
+}
+
+static bool heap_in_memory(struct heap_fixture_t* fixture, void* ptr, u32_t size) {
+    u8_t* bytes = ptr;
+    return bytes >= fixture->memory + TEST_RESERVED &&
+           bytes + size <= fixture->memory + TEST_MEMORY_SIZE;
+}
+
+static MunitResult test_sizes(const MunitParameter params[], void* data) {
+    (void)params;
+    struct heap_fixture_t* fixture = data;
+
+    munit_assert_null(kmalloc(0));
+
+    // Every size up to a few pages, each written in full to catch any overlap.
+    u8_t* blocks[160];
+    for (u32_t i = 0; i < 160; i++) {
+        u32_t size = 1 + i * 61;
+        blocks[i]  = kmalloc(size);
+
+        munit_assert_not_null(blocks[i]);
+        munit_assert_true(heap_in_memory(fixture, blocks[i], size));
+        munit_assert_uint64((uintptr_t)blocks[i] % HEAP_ALIGN, ==, 0);
+        memset(blocks[i], (int)i, size);
+    }
+
+    for (u32_t i = 0; i < 160; i++) {
+        u32_t size = 1 + i * 61;
+        for (u32_t j = 0; j < size; j++) {
+            munit_assert_uint8(blocks[i][j], ==, (u8_t)i);
+        }
+        munit_assert_int(kfree(blocks[i]), ==, HEAP_GOOD);
+    }
+
+    munit_assert_int(kfree(NULL), ==, HEAP_GOOD);
+    return MUNIT_OK;
+}
+
+static MunitResult test_reuse(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    struct heap_stats_t stats;
+    void* objects[2000];
+    u32_t freePages = page_free_pages();
+
+    // Several slabs worth of one class.
+    for (u32_t i = 0; i < 2000; i++) {
+        objects[i] = kmalloc(24);
+        munit_assert_not_null(objects[i]);
+    }
+
+    munit_assert_int(heap_stats(1, &stats), ==, HEAP_GOOD);
+    munit_assert_uint32(stats.object_size, ==, 32);
+    munit_assert_uint32(stats.used, ==, 2000);
+    u32_t slabs = (2000 + stats.objects_per_slab - 1) / stats.objects_per_slab;
+    munit_assert_uint32(stats.slabs, ==, slabs);
+    munit_assert_uint32(stats.capacity, ==, stats.slabs * stats.objects_per_slab);
+    munit_assert_uint64(stats.requested_bytes, ==, 2000 * 24);
+    munit_assert_uint64(stats.allocated_bytes, ==, 2000 * 32);
+
+    // A freed slot is the next one handed out.
+    void* freed = objects[777];
+    munit_assert_int(kfree(freed), ==, HEAP_GOOD);
+    objects[777] = kmalloc(32);
+    munit_assert_ptr_equal(objects[777], freed);
+
+    for (u32_t i = 0; i < 2000; i++) {
+        munit_assert_int(kfree(objects[i]), ==, HEAP_GOOD);
+    }
+
+    // Only the cached empty slab is kept back from the page allocator.
+    munit_assert_int(heap_stats(1, &stats), ==, HEAP_GOOD);
+    munit_assert_uint32(stats.used, ==, 0);
+    munit_assert_uint32(stats.peak_used, ==, 2000);
+    munit_assert_uint32(stats.slabs, ==, 1);
+    munit_assert_uint32(stats.allocs, ==, stats.frees);
+    munit_assert_uint32(page_free_pages(), ==, freePages - 4);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_large(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    struct heap_stats_t stats;
+    u32_t freePages = page_free_pages();
+
+    void* block = kmalloc(3 * PAGE_SIZE);
+    munit_assert_not_null(block);
+    munit_assert_uint32(page_free_pages(), ==, freePages - 4);
+
+    munit_assert_int(heap_stats(HEAP_LARGE, &stats), ==, HEAP_GOOD);
+    munit_assert_uint32(stats.used, ==, 4);
+    munit_assert_uint64(stats.requested_bytes, ==, 3 * PAGE_SIZE);
+    munit_assert_uint64(stats.allocated_bytes, ==, 4 * PAGE_SIZE);
+
+    munit_assert_int(kfree(block), ==, HEAP_GOOD);
+    munit_assert_uint32(page_free_pages(), ==, freePages);
+
+    munit_assert_null(kmalloc(TEST_MEMORY_SIZE));
+    munit_assert_int(heap_stats(HEAP_LARGE + 1, &stats), ==, HEAP_BAD_CLASS);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_bad_free(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    u8_t* keep   = kmalloc(100);
+    u8_t* object = kmalloc(100);
+    munit_assert_not_null(keep);
+    munit_assert_not_null(object);
+
+    munit_assert_int(kfree(object + 8), ==, HEAP_BAD_POINTER);
+    munit_assert_int(kfree(object), ==, HEAP_GOOD);
+    munit_assert_int(kfree(object), ==, HEAP_NOT_ALLOCATED);
+    munit_assert_int(kfree(keep), ==, HEAP_GOOD);
+
+    return MUNIT_OK;
+}
+
+MunitTest heap_tests[] = {
+    {"/sizes", test_sizes, heap_setup, heap_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/reuse", test_reuse, heap_setup, heap_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/large", test_large, heap_setup, heap_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/bad_free", test_bad_free, heap_setup, heap_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
@@ -0,0 +1,143 @@
+/**
+ * @file klog_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the kernel log ring.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/klog.h"
+#include "munit.h"
+
+#include <string.h>
+
+/// @brief Big enough for a full ring of the longest lines.
+#define TEST_CAPTURE_SIZE (KLOG_RECORDS * (KLOG_MESSAGE_SIZE + 32))
+
+struct klog_capture_t {
+    char text[TEST_CAPTURE_SIZE];
+    u32_t length;
+};
+
+static struct klog_capture_t capture;
+static u64_t test_time;
+
+static u64_t test_clock(void) {
+    return test_time += 10;
+}
+
+static void capture_sink(void* context, const char* data, u32_t length) {
+    struct klog_capture_t* out = context;
+    munit_assert_uint32(out->length + length, <, TEST_CAPTURE_SIZE);
+
+    memcpy(out->text + out->length, data, length);
+    out->length            += length;
+    out->text[out->length]  = '\0';
+}
+
+static void* klog_setup(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    test_time       = 0;
+    capture.length  = 0;
+    capture.text[0] = '\0';
+    klog_init(test_clock);
+    return NULL;
+}
+
+static u32_t count_lines(const char* text) {
+    u32_t lines = 0;
+    for (; *text; text++) {
+        lines += *text == '\n';
+    }
+    return lines;
+}
+
+static MunitResult test_drain(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    munit_assert_false(klog_pending());
+    klog(KLOG_INFO, "booting %u", 1u);
+    klog(KLOG_ERROR, "failed: %s", "disk");
+    munit_assert_true(klog_pending());
+
+    munit_assert_uint32(klog_drain(capture_sink, &capture), ==, 2);
+    munit_assert_string_equal(capture.text, "[        10] info: booting 1\n"
+                                            "[        20] error: failed: disk\n");
+    munit_assert_false(klog_pending());
+
+    // Nothing is written twice.
+    capture.length = 0;
+    munit_assert_uint32(klog_drain(capture_sink, &capture), ==, 0);
+    munit_assert_uint32(capture.length, ==, 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_overwrite(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    for (u32_t i = 0; i < KLOG_RECORDS + 5; i++) {
+        klog(KLOG_DEBUG, "line %u", i);
+    }
+
+    // The oldest lines are gone and counted, the newest are all kept.
+    munit_assert_uint32(klog_drain(capture_sink, &capture), ==, KLOG_RECORDS);
+    munit_assert_uint32(count_lines(capture.text), ==, KLOG_RECORDS + 1);
+    munit_assert_true(strncmp(capture.text, "klog: 5 lines lost\n", 19) == 0);
+    munit_assert_not_null(strstr(capture.text, "debug: line 5\n"));
+    munit_assert_null(strstr(capture.text, "debug: line 4\n"));
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_replay(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    klog(KLOG_WARN, "first");
+    klog_drain(capture_sink, &capture);
+    klog(KLOG_WARN, "second");
+
+    // Replay writes drained records too, and leaves the drain where it was.
+    capture.length = 0;
+    klog_replay(capture_sink, &capture);
+    munit_assert_string_equal(capture.text, "[        10] warn: first\n"
+                                            "[        20] warn: second\n");
+
+    capture.length = 0;
+    munit_assert_uint32(klog_drain(capture_sink, &capture), ==, 1);
+    munit_assert_string_equal(capture.text, "[        20] warn: second\n");
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_truncate(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    char message[2 * KLOG_MESSAGE_SIZE];
+    memset(message, 'x', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+
+    klog(KLOG_INFO, "%s", message);
+    klog_drain(capture_sink, &capture);
+
+    const char* text = strstr(capture.text, "info: ") + 6;
+    munit_assert_size(strlen(text), ==, KLOG_MESSAGE_SIZE);
+    munit_assert_int(text[KLOG_MESSAGE_SIZE - 1], ==, '\n');
+
+    return MUNIT_OK;
+}
+
+MunitTest klog_tests[] = {
+    {"/drain", test_drain, klog_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/overwrite", test_overwrite, klog_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/replay", test_replay, klog_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/truncate", test_truncate, klog_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
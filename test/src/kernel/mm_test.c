@@ -0,0 +1,190 @@
+/**
+ * @file mm_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for building and searching the memory map.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The regions are made up physical addresses shaped like a Raspberry Pi 1, the map never touches
+ * the memory it describes.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/mm.h"
+#include "munit.h"
+
+static void* mm_setup(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    mm_map_reset();
+    return NULL;
+}
+
+/**
+ * @brief Check a segment of the memory map.
+ */
+static void check_segment(const struct MemorySegment* segment, u32_t base, u32_t size,
+                          enum MemoryOwnership owner) {
+    munit_assert_uint32(segment->base, ==, base);
+    munit_assert_uint32(segment->size, ==, size);
+    munit_assert_int(segment->owner, ==, owner);
+}
+
+static MunitResult test_overlap(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    u32_t count;
+
+    // The sources of `mm_init`, in the order it adds them.
+    munit_assert_int(mm_map_add(0x0, 0x1c000000, ARM), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x1c000000, 0x4000000, VC), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x0, 0x40000, RESERVED), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x1bff0000, 0x20000, RESERVED), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x20000000, 0x1000000, MMIO), ==, MM_GOOD);
+    munit_assert_int(mm_map_build(), ==, MM_GOOD);
+
+    // Reserved wins over both the ARM and the VideoCore memory it straddles.
+    const struct MemorySegment* map = mm_memory_map(&count);
+    munit_assert_uint32(count, ==, 5);
+    check_segment(&map[0], 0x0, 0x40000, RESERVED);
+    check_segment(&map[1], 0x40000, 0x1bfb0000, ARM);
+    check_segment(&map[2], 0x1bff0000, 0x20000, RESERVED);
+    check_segment(&map[3], 0x1c010000, 0x3ff0000, VC);
+    check_segment(&map[4], 0x20000000, 0x1000000, MMIO);
+
+    // Peripherals win over everything, whatever order they come in.
+    munit_assert_int(mm_map_add(0x1ff00000, 0x200000, MMIO), ==, MM_GOOD);
+    munit_assert_int(mm_map_build(), ==, MM_GOOD);
+
+    map = mm_memory_map(&count);
+    munit_assert_uint32(count, ==, 5);
+    check_segment(&map[3], 0x1c010000, 0x3ef0000, VC);
+    check_segment(&map[4], 0x1ff00000, 0x1100000, MMIO);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_merge(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    u32_t count;
+
+    // Touching and overlapping regions of one owner become one segment.
+    munit_assert_int(mm_map_add(0x1000, 0x1000, ARM), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x2000, 0x1000, ARM), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x2800, 0x1800, ARM), ==, MM_GOOD);
+
+    // A gap, or a different owner, keeps the segments apart.
+    munit_assert_int(mm_map_add(0x5000, 0x1000, ARM), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x6000, 0x1000, VC), ==, MM_GOOD);
+
+    // Reserving all of a segment leaves its neighbours of the same owner merged around it.
+    munit_assert_int(mm_map_add(0x8000, 0x1000, ARM), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x9000, 0x1000, RESERVED), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x9000, 0x2000, ARM), ==, MM_GOOD);
+    munit_assert_int(mm_map_build(), ==, MM_GOOD);
+
+    const struct MemorySegment* map = mm_memory_map(&count);
+    munit_assert_uint32(count, ==, 6);
+    check_segment(&map[0], 0x1000, 0x3000, ARM);
+    check_segment(&map[1], 0x5000, 0x1000, ARM);
+    check_segment(&map[2], 0x6000, 0x1000, VC);
+    check_segment(&map[3], 0x8000, 0x1000, ARM);
+    check_segment(&map[4], 0x9000, 0x1000, RESERVED);
+    check_segment(&map[5], 0xa000, 0x1000, ARM);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_wrap(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    u32_t count;
+
+    munit_assert_false(mm_region_wraps(0x0, 0xffffffff));
+    munit_assert_false(mm_region_wraps(0xfffff000, 0xfff));
+    munit_assert_true(mm_region_wraps(0xfffff000, 0x1000));
+    munit_assert_true(mm_region_wraps(0x1, 0xffffffff));
+    munit_assert_true(mm_region_wraps(0xffffffff, 0xffffffff));
+
+    // 64 bit regions from the device tree are cut at the top of the address space, or dropped.
+    munit_assert_int(mm_map_add(0xfffff000, 0x2000, MMIO), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x100000000, 0x1000, RESERVED), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x3000, 0, RESERVED), ==, MM_GOOD);
+    munit_assert_int(mm_map_build(), ==, MM_GOOD);
+
+    const struct MemorySegment* map = mm_memory_map(&count);
+    munit_assert_uint32(count, ==, 1);
+    check_segment(&map[0], 0xfffff000, 0x1000, MMIO);
+    munit_assert_int(mm_owner_of(0xffffffff), ==, MMIO);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_lookup(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    munit_assert_int(mm_owner_of(0x0), ==, UNOWNED);
+
+    munit_assert_int(mm_map_add(0x1000, 0x7000, ARM), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x8000, 0x8000, VC), ==, MM_GOOD);
+    munit_assert_int(mm_map_add(0x20000, 0x1000, MMIO), ==, MM_GOOD);
+    munit_assert_int(mm_map_build(), ==, MM_GOOD);
+
+    // Before the first segment.
+    munit_assert_int(mm_owner_of(0x0), ==, UNOWNED);
+    munit_assert_int(mm_owner_of(0xfff), ==, UNOWNED);
+
+    // First byte, last byte, and one past each segment.
+    munit_assert_int(mm_owner_of(0x1000), ==, ARM);
+    munit_assert_int(mm_owner_of(0x7fff), ==, ARM);
+    munit_assert_int(mm_owner_of(0x8000), ==, VC);
+    munit_assert_int(mm_owner_of(0xffff), ==, VC);
+    munit_assert_int(mm_owner_of(0x10000), ==, UNOWNED);
+    munit_assert_int(mm_owner_of(0x1ffff), ==, UNOWNED);
+    munit_assert_int(mm_owner_of(0x20000), ==, MMIO);
+    munit_assert_int(mm_owner_of(0x20fff), ==, MMIO);
+    munit_assert_int(mm_owner_of(0x21000), ==, UNOWNED);
+    munit_assert_int(mm_owner_of(0xffffffff), ==, UNOWNED);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_too_many(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    u32_t i = 0;
+    while (mm_map_add(i * 0x2000, 0x1000, ARM) == MM_GOOD) {
+        i++;
+    }
+    munit_assert_uint32(i, >, 0);
+
+    // Every region is kept apart by a gap, which fills the map exactly.
+    munit_assert_int(mm_map_build(), ==, MM_GOOD);
+    munit_assert_int(mm_owner_of((i - 1) * 0x2000), ==, ARM);
+
+    // Holes punched in one region split it into more segments than the map holds.
+    mm_map_reset();
+    munit_assert_int(mm_map_add(0x0, i * 0x2000, ARM), ==, MM_GOOD);
+    for (u32_t j = 0; j < i / 2; j++) {
+        munit_assert_int(mm_map_add(j * 0x4000 + 0x1000, 0x1000, RESERVED), ==, MM_GOOD);
+    }
+    munit_assert_int(mm_map_build(), ==, MM_TOO_MANY_SEGMENTS);
+
+    return MUNIT_OK;
+}
+
+MunitTest mm_tests[] = {
+    {"/overlap", test_overlap, mm_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/merge", test_merge, mm_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/wrap", test_wrap, mm_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/lookup", test_lookup, mm_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/too_many", test_too_many, mm_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
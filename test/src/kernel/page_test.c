@@ -0,0 +1,173 @@
+/**
+ * @file page_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the physical page frame allocator.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The allocator never touches the memory it manages, so the tests hand it made up physical
+ * addresses and only allocate real memory for the metadata.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/page.h"
+#include "munit.h"
+
+#include <stdlib.h>
+
+/// @brief Size of the made up physical memory, 4MiB.
+#define TEST_MEMORY_SIZE 0x400000
+
+/// @brief Largest block that the allocator hands out.
+#define TEST_MAX_BLOCK (PAGE_SIZE << PAGE_MAX_ORDER)
+
+static void* page_setup(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    struct page_t* metadata = malloc(page_metadata_size(0, TEST_MEMORY_SIZE));
+    munit_assert_not_null(metadata);
+
+    page_init(0, TEST_MEMORY_SIZE, metadata);
+    return metadata;
+}
+
+static void page_tear_down(void* metadata) { free(metadata); }
+
+static MunitResult test_seed(const MunitParameter params[], void* metadata) {
+    (void)params;
+    (void)metadata;
+
+    munit_assert_uint32(page_free_pages(), ==, 0);
+
+    // Whole 1MiB blocks.
+    page_add_free_range(TEST_MAX_BLOCK, TEST_MEMORY_SIZE);
+    munit_assert_uint32(page_free_count(PAGE_MAX_ORDER), ==, 3);
+    munit_assert_uint32(page_free_pages(), ==, 3 * (TEST_MAX_BLOCK / PAGE_SIZE));
+
+    // A range that is not page aligned only frees the whole pages in it, frames 2 to 8.
+    page_add_free_range(0x1800, 0x9000);
+    munit_assert_uint32(page_free_count(0), ==, 1);
+    munit_assert_uint32(page_free_count(1), ==, 1);
+    munit_assert_uint32(page_free_count(2), ==, 1);
+    munit_assert_uint32(page_free_pages(), ==, 3 * (TEST_MAX_BLOCK / PAGE_SIZE) + 7);
+
+    // Freeing the neighbours coalesces everything back into whole blocks.
+    page_add_free_range(0, 0x2000);
+    page_add_free_range(0x9000, TEST_MAX_BLOCK);
+    munit_assert_uint32(page_free_count(PAGE_MAX_ORDER), ==, 4);
+    for (u32_t order = 0; order < PAGE_MAX_ORDER; order++) {
+        munit_assert_uint32(page_free_count(order), ==, 0);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_split_and_merge(const MunitParameter params[], void* metadata) {
+    (void)params;
+    (void)metadata;
+
+    ptr_t address;
+    u32_t order;
+
+    page_add_free_range(0, TEST_MAX_BLOCK);
+
+    // A single page splits the block once at every order.
+    munit_assert_int(page_alloc(0, &address), ==, PAGE_GOOD);
+    munit_assert_uint32(address, ==, 0);
+    munit_assert_uint32(page_free_count(PAGE_MAX_ORDER), ==, 0);
+    for (order = 0; order < PAGE_MAX_ORDER; order++) {
+        munit_assert_uint32(page_free_count(order), ==, 1);
+    }
+
+    munit_assert_int(page_block_order(address, &order), ==, PAGE_GOOD);
+    munit_assert_uint32(order, ==, 0);
+
+    // And merges back when it is freed.
+    munit_assert_int(page_free(address), ==, PAGE_GOOD);
+    munit_assert_uint32(page_free_count(PAGE_MAX_ORDER), ==, 1);
+    munit_assert_uint32(page_free_pages(), ==, TEST_MAX_BLOCK / PAGE_SIZE);
+
+    munit_assert_int(page_free(address), ==, PAGE_NOT_ALLOCATED);
+    munit_assert_int(page_free(0x800), ==, PAGE_BAD_ADDRESS);
+    munit_assert_int(page_free(TEST_MEMORY_SIZE), ==, PAGE_BAD_ADDRESS);
+    munit_assert_int(page_alloc(PAGE_MAX_ORDER + 1, &address), ==, PAGE_BAD_ORDER);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_exhaust(const MunitParameter params[], void* metadata) {
+    (void)params;
+    (void)metadata;
+
+    const u32_t orders[] = {0, 3, 1, 5, 0, 2, 8, 4};
+    ptr_t blocks[TEST_MEMORY_SIZE / PAGE_SIZE];
+    u32_t blockOrders[TEST_MEMORY_SIZE / PAGE_SIZE];
+    u32_t count = 0;
+    u32_t used  = 0;
+
+    page_add_free_range(0, TEST_MEMORY_SIZE);
+
+    // Allocate mixed orders until memory runs out, every block aligned and inside memory.
+    while (true) {
+        u32_t order = orders[count % 8];
+        ptr_t address;
+
+        if (page_alloc(order, &address) != PAGE_GOOD) {
+            if (order == 0) {
+                break;
+            }
+            if (page_alloc(0, &address) != PAGE_GOOD) {
+                break;
+            }
+            order = 0;
+        }
+
+        munit_assert_uint32(address % (PAGE_SIZE << order), ==, 0);
+        munit_assert_uint32(address + (PAGE_SIZE << order), <=, TEST_MEMORY_SIZE);
+        blocks[count]      = address;
+        blockOrders[count] = order;
+        used += 1u << order;
+        count++;
+    }
+
+    munit_assert_uint32(used, ==, TEST_MEMORY_SIZE / PAGE_SIZE);
+    munit_assert_uint32(page_free_pages(), ==, 0);
+
+    // Freeing in any order gets all of the memory back as whole blocks.
+    for (u32_t i = 0; i < count; i += 2) {
+        munit_assert_int(page_free(blocks[i]), ==, PAGE_GOOD);
+    }
+    for (u32_t i = 1; i < count; i += 2) {
+        u32_t order;
+        munit_assert_int(page_block_order(blocks[i], &order), ==, PAGE_GOOD);
+        munit_assert_uint32(order, ==, blockOrders[i]);
+        munit_assert_int(page_free(blocks[i]), ==, PAGE_GOOD);
+    }
+
+    munit_assert_uint32(page_free_count(PAGE_MAX_ORDER), ==, TEST_MEMORY_SIZE / TEST_MAX_BLOCK);
+    munit_assert_uint32(page_free_pages(), ==, TEST_MEMORY_SIZE / PAGE_SIZE);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_order_for_size(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    munit_assert_uint32(page_order_for_size(1), ==, 0);
+    munit_assert_uint32(page_order_for_size(PAGE_SIZE), ==, 0);
+    munit_assert_uint32(page_order_for_size(PAGE_SIZE + 1), ==, 1);
+    munit_assert_uint32(page_order_for_size(TEST_MAX_BLOCK), ==, PAGE_MAX_ORDER);
+    munit_assert_uint32(page_order_for_size(TEST_MAX_BLOCK + 1), >, PAGE_MAX_ORDER);
+
+    return MUNIT_OK;
+}
+
+MunitTest page_tests[] = {
+    {"/seed", test_seed, page_setup, page_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/split", test_split_and_merge, page_setup, page_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/exhaust", test_exhaust, page_setup, page_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/order", test_order_for_size, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
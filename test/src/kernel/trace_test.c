@@ -0,0 +1,229 @@
+/**
+ * @file trace_test.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Tests for the trace ring and its frames.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+// Build the trace points as a `make TRACE=1` kernel does.
+#define TRACE_ENABLED
+
+#include "kernel/trace.h"
+#include "munit.h"
+
+#include <string.h>
+
+/// @brief Big enough for a full ring, each record in its own frame.
+#define TEST_CAPTURE_SIZE (TRACE_RECORDS * TRACE_FRAME_SIZE(1))
+
+struct trace_capture_t {
+    u8_t data[TEST_CAPTURE_SIZE];
+    u32_t length;
+    u32_t writes;
+};
+
+static struct trace_capture_t capture;
+static u64_t test_time;
+
+static u64_t test_clock(void) {
+    return test_time += 10;
+}
+
+static u32_t capture_write(const char* data, u32_t length) {
+    munit_assert_uint32(capture.length + length, <=, TEST_CAPTURE_SIZE);
+
+    memcpy(capture.data + capture.length, data, length);
+    capture.length += length;
+    capture.writes++;
+    return length;
+}
+
+/// @brief Interrupt that carries the stream in `test_ignored_irq`.
+#define TEST_STREAM_IRQ 57
+
+/**
+ * @brief A write whose bytes leave through interrupts, as the UART ring does, each tracing itself.
+ */
+static u32_t refill_write(const char* data, u32_t length) {
+    for (u32_t refills = 0; refills < length / 12; refills++) {
+        trace_irq(TRACE_IRQ_BEGIN, TEST_STREAM_IRQ);
+        trace_irq(TRACE_IRQ_END, TEST_STREAM_IRQ);
+    }
+    return capture_write(data, length);
+}
+
+static void* trace_setup(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    test_time      = 0;
+    capture.length = 0;
+    capture.writes = 0;
+    trace_init(test_clock);
+    return NULL;
+}
+
+static u32_t get_u32(const u8_t* in) {
+    return (u32_t)in[0] | (u32_t)in[1] << 8 | (u32_t)in[2] << 16 | (u32_t)in[3] << 24;
+}
+
+/**
+ * @brief Check the header and checksum of the frame at `in`.
+ *
+ * @return u32_t The number of records in the frame.
+ */
+static u32_t check_frame(const u8_t* in, u32_t sequence) {
+    u32_t count  = in[3];
+    u32_t length = TRACE_HEADER_SIZE + count * TRACE_RECORD_SIZE;
+
+    munit_assert_memory_equal(2, in, "TR");
+    munit_assert_uint8(in[2], ==, TRACE_VERSION);
+    munit_assert_uint32(count, >, 0);
+    munit_assert_uint32(count, <=, TRACE_BATCH);
+    munit_assert_uint32(get_u32(in + 4), ==, sequence);
+    munit_assert_uint32(get_u32(in + length), ==, trace_crc32(in, length));
+    return count;
+}
+
+static MunitResult test_crc32(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    munit_assert_uint32(trace_crc32((const u8_t*)"123456789", 9), ==, 0xCBF43926);
+    munit_assert_uint32(trace_crc32(NULL, 0), ==, 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_frame(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    munit_assert_false(trace_pending());
+    trace_emit(TRACE_IRQ_BEGIN, 3, 0);
+    trace_emit(TRACE_IRQ_END, 3, 0);
+    trace_emit(TRACE_MAILBOX_SUBMIT, 0x1000, 8);
+    munit_assert_true(trace_pending());
+
+    munit_assert_uint32(trace_stream(capture_write), ==, 3);
+    munit_assert_false(trace_pending());
+    munit_assert_uint32(capture.writes, ==, 1);
+    munit_assert_uint32(capture.length, ==, TRACE_FRAME_SIZE(3));
+    munit_assert_uint32(check_frame(capture.data, 0), ==, 3);
+
+    // Base time, then the deltas from one record to the next.
+    munit_assert_uint32(get_u32(capture.data + 8), ==, 10);
+    munit_assert_uint32(get_u32(capture.data + 12), ==, 0);
+
+    const u8_t* record = capture.data + TRACE_HEADER_SIZE;
+    munit_assert_uint8(record[0], ==, TRACE_IRQ_BEGIN);
+    munit_assert_uint32(get_u32(record + 4), ==, 0);
+    munit_assert_uint32(get_u32(record + 8), ==, 3);
+
+    record += 2 * TRACE_RECORD_SIZE;
+    munit_assert_uint8(record[0], ==, TRACE_MAILBOX_SUBMIT);
+    munit_assert_uint32(get_u32(record + 4), ==, 10);
+    munit_assert_uint32(get_u32(record + 8), ==, 0x1000);
+    munit_assert_uint32(get_u32(record + 12), ==, 8);
+
+    // Nothing is sent twice.
+    munit_assert_uint32(trace_stream(capture_write), ==, 0);
+    munit_assert_uint32(capture.writes, ==, 1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_batches(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    for (u32_t i = 0; i < TRACE_BATCH + 5; i++) {
+        trace_emit(TRACE_UART_DMA_BEGIN, 4, i);
+    }
+
+    munit_assert_uint32(trace_stream(capture_write), ==, TRACE_BATCH + 5);
+    munit_assert_uint32(capture.writes, ==, 2);
+    munit_assert_uint32(check_frame(capture.data, 0), ==, TRACE_BATCH);
+
+    const u8_t* second = capture.data + TRACE_FRAME_SIZE(TRACE_BATCH);
+    munit_assert_uint32(check_frame(second, TRACE_BATCH), ==, 5);
+
+    // The second frame has its own base time.
+    munit_assert_uint32(get_u32(second + 8), ==, (TRACE_BATCH + 1) * 10);
+    munit_assert_uint32(get_u32(second + TRACE_HEADER_SIZE + 4), ==, 0);
+    munit_assert_uint32(get_u32(second + TRACE_HEADER_SIZE + 12), ==, TRACE_BATCH);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_overwrite(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    for (u32_t i = 0; i < TRACE_RECORDS + 7; i++) {
+        trace_emit(TRACE_BOOT_STEP_BEGIN, i, 0);
+    }
+
+    // The oldest records are skipped, and the first frame starts after the gap.
+    munit_assert_uint32(trace_stream(capture_write), ==, TRACE_RECORDS);
+    munit_assert_uint32(capture.writes, ==, TRACE_RECORDS / TRACE_BATCH);
+    munit_assert_uint32(check_frame(capture.data, 7), ==, TRACE_BATCH);
+    munit_assert_uint32(get_u32(capture.data + TRACE_HEADER_SIZE + 8), ==, 7);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_delta_overflow(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    trace_emit(TRACE_IRQ_BEGIN, 1, 0);
+    test_time += 0x80000000ull;
+    trace_emit(TRACE_IRQ_END, 1, 0);
+
+    // A gap too long for a delta starts a new frame.
+    munit_assert_uint32(trace_stream(capture_write), ==, 2);
+    munit_assert_uint32(capture.writes, ==, 2);
+    munit_assert_uint32(check_frame(capture.data, 0), ==, 1);
+
+    const u8_t* second = capture.data + TRACE_FRAME_SIZE(1);
+    munit_assert_uint32(check_frame(second, 1), ==, 1);
+    munit_assert_uint32(get_u32(second + 8), ==, 0x80000014u);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_ignored_irq(const MunitParameter params[], void* data) {
+    (void)params;
+    (void)data;
+
+    trace_ignore_irq(TEST_STREAM_IRQ);
+    munit_assert_false(trace_irq_wanted(TEST_STREAM_IRQ));
+    munit_assert_true(trace_irq_wanted(TEST_STREAM_IRQ + 1));
+
+    trace_emit(TRACE_MAILBOX_SUBMIT, 0x1000, 8);
+    trace_irq(TRACE_IRQ_BEGIN, TEST_STREAM_IRQ + 1);
+
+    // Streaming must not feed the ring with the interrupts that carry the stream.
+    munit_assert_uint32(trace_stream(refill_write), ==, 2);
+    munit_assert_false(trace_pending());
+    munit_assert_uint32(trace_stream(refill_write), ==, 0);
+
+    // Other interrupts are still traced.
+    trace_irq(TRACE_IRQ_END, TEST_STREAM_IRQ + 1);
+    munit_assert_true(trace_pending());
+
+    return MUNIT_OK;
+}
+
+MunitTest trace_tests[] = {
+    {"/crc32", test_crc32, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/frame", test_frame, trace_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/batches", test_batches, trace_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/overwrite", test_overwrite, trace_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/delta_overflow", test_delta_overflow, trace_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/ignored_irq", test_ignored_irq, trace_setup, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+};
@@ -0,0 +1,158 @@
+/**
+ * @file dt_compile.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Host tool that compiles a device tree blob into constant C tables.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The blob is parsed with the kernel's own device tree driver, and every table it builds is written
+ * out as a C source file defining `dt_precompiled_tables`. A kernel built with that file skips
+ * parsing at boot, whenever the firmware passes it the same blob.
+ *
+ * Usage: dt_compile <blob.dtb> <output.c>
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "drivers/dt.h"
+#include "drivers/dt_tables.h"
+#include "host_util.h"
+#include "kernel/arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void write_nodes(FILE* out, const struct dt_tables_t* tables) {
+    fprintf(out, "static const struct dt_node_t dt_precompiled_nodes[%u] = {\n",
+            tables->node_count);
+    for (u32_t i = 0; i < tables->node_count; i++) {
+        const struct dt_node_t* node = &tables->nodes[i];
+        fprintf(out, "    {0x%x, %u, 0x%08x, %u, 0x%x, 0x%x, 0x%x, %u, %u},\n", node->name_off,
+                node->first_prop, node->path_hash, node->prop_count, node->parent,
+                node->first_child, node->next_sibling, node->address_cells, node->size_cells);
+    }
+    fprintf(out, "};\n\n");
+}
+
+static void write_props(FILE* out, const struct dt_tables_t* tables) {
+    fprintf(out, "static const struct dt_prop_entry_t dt_precompiled_props[%u] = {\n",
+            tables->prop_count);
+    for (u32_t i = 0; i < tables->prop_count; i++) {
+        const struct dt_prop_entry_t* prop = &tables->props[i];
+        fprintf(out, "    {0x%x, %u, 0x%x},\n", prop->nameoff, prop->len, prop->data_off);
+    }
+    fprintf(out, "};\n\n");
+}
+
+static void write_paths(FILE* out, const struct dt_tables_t* tables) {
+    fprintf(out, "static const u16_t dt_precompiled_paths[%u] = {\n",
+            tables->path_table_mask + 1);
+    for (u32_t i = 0; i <= tables->path_table_mask; i++) {
+        fprintf(out, "%s0x%x,%s", i % 8 == 0 ? "    " : " ", tables->path_table[i],
+                i % 8 == 7 ? "\n" : "");
+    }
+    fprintf(out, "};\n\n");
+}
+
+static void write_phandles(FILE* out, const struct dt_tables_t* tables) {
+    fprintf(out, "static const struct dt_phandle_entry_t dt_precompiled_phandles[%u] = {\n",
+            tables->phandle_table_mask + 1);
+    for (u32_t i = 0; i <= tables->phandle_table_mask; i++) {
+        fprintf(out, "    {%u, 0x%x},\n", tables->phandles[i].phandle, tables->phandles[i].node);
+    }
+    fprintf(out, "};\n\n");
+}
+
+static void write_names(FILE* out, const struct dt_tables_t* tables) {
+    fprintf(out, "static const struct dt_name_entry_t dt_precompiled_names[%u] = {\n",
+            tables->name_table_mask + 1);
+    for (u32_t i = 0; i <= tables->name_table_mask; i++) {
+        fprintf(out, "    {0x%08x, 0x%x},\n", tables->names[i].hash, tables->names[i].nameoff);
+    }
+    fprintf(out, "};\n\n");
+}
+
+static void write_regs(FILE* out, const struct dt_tables_t* tables) {
+    // Zero length arrays are not valid C, so there is always at least one entry.
+    fprintf(out, "static const struct dt_reg_entry_t dt_precompiled_regs[%u] = {\n",
+            tables->reg_count + 1);
+    for (u32_t i = 0; i < tables->reg_count; i++) {
+        const struct dt_reg_entry_t* reg = &tables->regs[i];
+        fprintf(out, "    {0x%llx, 0x%llx, %d},\n", (unsigned long long)reg->address,
+                (unsigned long long)reg->size, reg->status);
+    }
+    fprintf(out, "    {0x0, 0x0, %d},\n};\n\n", DT_PROP_NOT_FOUND);
+
+    fprintf(out, "static const u16_t dt_precompiled_reg_first[%u] = {\n", tables->node_count + 1);
+    for (u32_t i = 0; i <= tables->node_count; i++) {
+        fprintf(out, "%s%u,%s", i % 8 == 0 ? "    " : " ", tables->reg_first[i],
+                i % 8 == 7 || i == tables->node_count ? "\n" : "");
+    }
+    fprintf(out, "};\n\n");
+}
+
+static void write_tables(FILE* out, const char* source, const struct dt_tables_t* tables) {
+    fprintf(out, "/* Generated by tools/dt_compile from %s, do not edit. */\n\n", source);
+    fprintf(out, "#include \"drivers/dt_tables.h\"\n\n");
+
+    write_nodes(out, tables);
+    write_props(out, tables);
+    write_paths(out, tables);
+    write_phandles(out, tables);
+    write_names(out, tables);
+    write_regs(out, tables);
+
+    fprintf(out, "const struct dt_tables_t dt_precompiled_tables = {\n");
+    fprintf(out, "    .checksum           = 0x%08x,\n", tables->checksum);
+    fprintf(out, "    .totalsize          = %u,\n", tables->totalsize);
+    fprintf(out, "    .nodes              = dt_precompiled_nodes,\n");
+    fprintf(out, "    .node_count         = %u,\n", tables->node_count);
+    fprintf(out, "    .props              = dt_precompiled_props,\n");
+    fprintf(out, "    .prop_count         = %u,\n", tables->prop_count);
+    fprintf(out, "    .path_table         = dt_precompiled_paths,\n");
+    fprintf(out, "    .path_table_mask    = 0x%x,\n", tables->path_table_mask);
+    fprintf(out, "    .phandles           = dt_precompiled_phandles,\n");
+    fprintf(out, "    .phandle_table_mask = 0x%x,\n", tables->phandle_table_mask);
+    fprintf(out, "    .names              = dt_precompiled_names,\n");
+    fprintf(out, "    .name_table_mask    = 0x%x,\n", tables->name_table_mask);
+    fprintf(out, "    .regs               = dt_precompiled_regs,\n");
+    fprintf(out, "    .reg_first          = dt_precompiled_reg_first,\n");
+    fprintf(out, "    .reg_count          = %u,\n", tables->reg_count);
+    fprintf(out, "};\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <blob.dtb> <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    void* blob = host_read_file(argv[1], NULL);
+    if (blob == NULL) {
+        fprintf(stderr, "%s: could not read %s\n", argv[0], argv[1]);
+        return 1;
+    }
+
+    // The tables are built in the boot arena, as they are on the target.
+    static _Alignas(16) u8_t arena[0x100000];
+    arena_init(arena, sizeof(arena));
+
+    enum dt_return_value_t status = dt_init(blob);
+    if (status != DT_GOOD) {
+        fprintf(stderr, "%s: could not parse %s (%d)\n", argv[0], argv[1], status);
+        return 1;
+    }
+
+    struct dt_tables_t tables;
+    dt_get_tables(&tables);
+
+    FILE* out = fopen(argv[2], "w");
+    if (out == NULL) {
+        fprintf(stderr, "%s: could not write %s\n", argv[0], argv[2]);
+        return 1;
+    }
+
+    write_tables(out, argv[1], &tables);
+    fclose(out);
+    free(blob);
+    return 0;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file trace_decode.c
+ * @author Riley Horrix (riley@horrix.com)
+ * @brief Host tool that turns a capture of the kernel trace stream into Chrome trace JSON.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * The capture is the raw serial output of a kernel built with `make TRACE=1`. Frames are found by
+ * their magic and only kept when their checksum matches, so console text around them is skipped.
+ * Event names, phases and tracks come from the kernel's own trace_events.h, so the decoder always
+ * agrees with the kernel it is built with. The output loads in chrome://tracing or Perfetto.
+ *
+ * Usage: trace_decode [capture] > trace.json, reading standard input without a capture.
+ *
+ * Copyright (c) Riley Horrix 2026
+ */
+#include "kernel/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct trace_event_info_t {
+    const char* name;
+    char phase;
+    u32_t track;
+};
+
+static const struct trace_event_info_t trace_event_info[TRACE_EVENT_COUNT] = {
+#define TRACE_EVENT_INFO(id, name, phase, track) [id] = {name, phase, track},
+    TRACE_EVENTS(TRACE_EVENT_INFO)
+#undef TRACE_EVENT_INFO
+};
+
+/**
+ * @brief Read a whole stream into a freshly allocated buffer.
+ *
+ * @param file The stream.
+ * @param size Set to the number of bytes read.
+ * @return u8_t* The contents, or NULL if it could not be read.
+ */
+static u8_t* read_capture(FILE* file, size_t* size) {
+    size_t capacity = 1 << 16;
+    u8_t* data      = malloc(capacity);
+    *size           = 0;
+
+    while (data != NULL) {
+        *size += fread(data + *size, 1, capacity - *size, file);
+        if (*size < capacity && ferror(file)) {
+            free(data);
+            return NULL;
+        }
+        if (*size < capacity) {
+            return data;
+        }
+
+        capacity *= 2;
+        u8_t* grown = realloc(data, capacity);
+        if (grown == NULL) {
+            free(data);
+        }
+        data = grown;
+    }
+    return NULL;
+}
+
+static u32_t get_u16(const u8_t* in) {
+    return (u32_t)in[0] | (u32_t)in[1] << 8;
+}
+
+static u32_t get_u32(const u8_t* in) {
+    return get_u16(in) | get_u16(in + 2) << 16;
+}
+
+/**
+ * @brief Check for a whole, intact frame.
+ *
+ * @param in The possible start of a frame.
+ * @param available Bytes left in the capture.
+ * @return u32_t The number of records in the frame, or 0 if there is no valid frame here.
+ */
+static u32_t frame_check(const u8_t* in, size_t available) {
+    if (available < TRACE_HEADER_SIZE || get_u16(in) != TRACE_MAGIC || in[2] != TRACE_VERSION) {
+        return 0;
+    }
+
+    u32_t count = in[3];
+    if (count == 0 || count > TRACE_BATCH || available < TRACE_FRAME_SIZE(count)) {
+        return 0;
+    }
+
+    u32_t length = TRACE_HEADER_SIZE + count * TRACE_RECORD_SIZE;
+    return trace_crc32(in, length) == get_u32(in + length) ? count : 0;
+}
+
+/**
+ * @brief Start the next event of the JSON array.
+ */
+static void event_begin(FILE* out, bool* first) {
+    fputs(*first ? "\n" : ",\n", out);
+    *first = false;
+}
+
+/**
+ * @brief Write the events of one frame.
+ *
+ * @param out The JSON output.
+ * @param in The frame, already checked.
+ * @param count Number of records in the frame.
+ * @param first Whether no event has been written yet.
+ */
+static void frame_write(FILE* out, const u8_t* in, u32_t count, bool* first) {
+    u64_t time = (u64_t)get_u32(in + 8) | (u64_t)get_u32(in + 12) << 32;
+
+    for (u32_t i = 0; i < count; i++) {
+        const u8_t* record = in + TRACE_HEADER_SIZE + i * TRACE_RECORD_SIZE;
+        u32_t event        = get_u16(record);
+        u32_t arg0         = get_u32(record + 8);
+        u32_t arg1         = get_u32(record + 12);
+        time              += (u64_t)(i64_t)(i32_t)get_u32(record + 4);
+
+        event_begin(out, first);
+        if (event >= TRACE_EVENT_COUNT) {
+            // From a newer kernel than this decoder.
+            fprintf(out, "{\"name\":\"event_%u\",\"ph\":\"i\",\"s\":\"t\"", event);
+            fprintf(out, ",\"ts\":%llu,\"pid\":0,\"tid\":0", (unsigned long long)time);
+        } else {
+            const struct trace_event_info_t* info = &trace_event_info[event];
+            fprintf(out, "{\"name\":\"%s\",\"ph\":\"%c\"", info->name, info->phase);
+            fprintf(out, ",\"ts\":%llu,\"pid\":0,\"tid\":%u", (unsigned long long)time,
+                    info->track);
+            if (info->phase == 'b' || info->phase == 'e') {
+                fprintf(out, ",\"cat\":\"%s\",\"id\":\"0x%x\"", info->name, arg0);
+            } else if (info->phase == 'i') {
+                fputs(",\"s\":\"t\"", out);
+            }
+        }
+        fprintf(out, ",\"args\":{\"arg0\":%u,\"arg1\":%u}}", arg0, arg1);
+    }
+}
+
+/**
+ * @brief Mark records that the kernel overwrote before it could send them.
+ */
+static void lost_write(FILE* out, const u8_t* in, u32_t lost, bool* first) {
+    u64_t time = (u64_t)get_u32(in + 8) | (u64_t)get_u32(in + 12) << 32;
+
+    event_begin(out, first);
+    fprintf(out, "{\"name\":\"trace_lost\",\"ph\":\"i\",\"s\":\"g\"");
+    fprintf(out, ",\"ts\":%llu,\"pid\":0,\"tid\":0", (unsigned long long)time);
+    fprintf(out, ",\"args\":{\"records\":%u}}", lost);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [capture]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* in = argc == 2 ? fopen(argv[1], "rb") : stdin;
+    if (in == NULL) {
+        fprintf(stderr, "%s: could not open %s\n", argv[0], argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    size_t size;
+    u8_t* capture = read_capture(in, &size);
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (capture == NULL) {
+        fprintf(stderr, "%s: could not read the capture\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* out  = stdout;
+    bool first = true;
+    fputs("{\"traceEvents\":[", out);
+    for (u32_t track = 0; track < 2; track++) {
+        event_begin(out, &first);
+        fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u", track);
+        fprintf(out, ",\"args\":{\"name\":\"%s\"}}", track ? "irq" : "kernel");
+    }
+
+    u32_t frames = 0, records = 0, lost = 0, next = 0;
+    for (size_t offset = 0; offset < size;) {
+        u32_t count = frame_check(capture + offset, size - offset);
+        if (count == 0) {
+            offset++;
+            continue;
+        }
+
+        u32_t sequence = get_u32(capture + offset + 4);
+        if (frames && sequence != next) {
+            lost_write(out, capture + offset, sequence - next, &first);
+            lost += sequence - next;
+        }
+
+        frame_write(out, capture + offset, count, &first);
+        next     = sequence + count;
+        records += count;
+        frames++;
+        offset  += TRACE_FRAME_SIZE(count);
+    }
+    fputs("\n]}\n", out);
+
+    fprintf(stderr, "%s: %u records in %u frames, %u lost\n", argv[0], records, frames, lost);
+    free(capture);
+    return EXIT_SUCCESS;
+}